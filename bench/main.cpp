@@ -0,0 +1,823 @@
+/**
+* @file     bench/main.cpp
+* @brief    Main function of the benchmark sub-program. Measures the scan, update and formatting kernels.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "../src/memory/memory.h"
+#include "../target/target.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+/*
+* Syntax: memory_bench [-o <file>] [-f <filter>] [-r <repetitions>] [-q | --quick] [-t <target>] [-b <baseline> [--update-baseline]]
+* All data is seeded within the own process, no target process is needed. Every benchmark is repeated and
+* the fastest repetition is reported. The results are written as one JSON object to the standard output or
+* to a file, every result has a unique name, its bytes and operations, the time in nanoseconds, GB/s and ns/op.
+* With '-t' the scans, updates, reads and writes are also measured against a started memory_target, these results
+* are checked against the layout that the target announces. Returns 1 if a check has failed.
+*
+* With '-b' every result that is in the baseline file is compared with it, a result fails if its ns/op exceeds the
+* baseline by more than its tolerance or if it reallocates more often. Returns 1 if a result has failed. With
+* '--update-baseline' the baseline file is written with the measured results instead, the tolerances are kept.
+* The baseline file must exist unless it is written with '--update-baseline'.
+* Baseline file, one result per line, '#' starts a comment:
+*   <name> <ns/op> <reallocations> [<tolerance>]     (tolerance as fraction, default BASELINE_TOLERANCE)
+*/
+namespace
+{
+    using namespace memory;
+    using clock_type = std::chrono::high_resolution_clock;
+
+    constexpr int EXIT_CHECK            = 1;
+    constexpr int EXIT_USAGE            = 2;
+    constexpr uint32_t JSON_VERSION     = 2;
+    constexpr uint32_t REPETITIONS      = 5;
+    constexpr size_t SCAN_SIZE          = 0x1000000;    // 16MB per scan
+    constexpr size_t SCAN_SIZE_QUICK    = 0x100000;     // 1MB per scan
+    constexpr size_t SPLIT_SIZE         = 0x100000;     // same chunk size as the application
+    constexpr size_t PUSH_COUNT         = 0x100000;     // values per push benchmark
+    constexpr size_t GROW_COUNT         = 0x10000;      // values per push benchmark without preallocation
+    constexpr size_t UPDATE_COUNT       = 0x40000;      // results per update benchmark
+    constexpr size_t FORMAT_COUNT       = 0x100000;     // values per formatting benchmark
+    constexpr uint32_t TABLE_ROWS       = 0x4000;       // entries per table benchmark
+    constexpr char STRING_VALUE[]       = "memory!!";
+    constexpr uint64_t TARGET_SEED      = 20210101;
+    constexpr uint64_t TARGET_HEAP      = 0x4000000;    // 64MB
+    constexpr uint64_t TARGET_HEAP_QUICK = 0x400000;    // 4MB
+    constexpr uint32_t TARGET_TIMEOUT   = 10000;        // milliseconds to wait for the pipe of the target
+    constexpr uint32_t TARGET_WRITE     = 0x0BADF00D;   // value written to the slots of the target
+    constexpr double BASELINE_TOLERANCE = 1.0;          // a result may take twice the time of the baseline
+
+    const char USAGE[] =
+        "Usage: memory_bench [-o <file>] [-f <filter>] [-r <repetitions>] [-q | --quick]\n"
+        "   -o <file>           writes the results to a file instead of the standard output\n"
+        "   -f <filter>         runs only the benchmarks whose name contains the filter\n"
+        "   -r <repetitions>    number of repetitions, the fastest one is reported (default 5)\n"
+        "   -q or --quick       uses smaller inputs\n"
+        "   -t <target>         path to memory_target, also runs the benchmarks against the target\n"
+        "   -b <baseline>       compares the results with a baseline file, fails on a regression\n"
+        "   --update-baseline   writes the results to the baseline file instead of comparing them";
+
+    const type_t ALL_TYPES[] = {
+        MEMORY_TYPE_INT8, MEMORY_TYPE_UINT8, MEMORY_TYPE_INT16, MEMORY_TYPE_UINT16, MEMORY_TYPE_INT32, MEMORY_TYPE_UINT32,
+        MEMORY_TYPE_INT64, MEMORY_TYPE_UINT64, MEMORY_TYPE_FLOAT, MEMORY_TYPE_DOUBLE, MEMORY_TYPE_STRING
+    };
+    const uint16_t ALIGNMENTS[] = { 1, 2, 4, 8 };
+    const double DENSITIES[] = { 0.0, 0.001, 0.05 };     // fraction of the aligned addresses that hold a match
+
+    struct Options
+    {
+        std::string output, filter, target, baseline;
+        uint32_t repetitions = REPETITIONS;
+        bool quick = false;
+        bool update_baseline = false;
+    };
+
+    struct Baseline
+    {
+        double ns_op;
+        uint64_t reallocations;
+        double tolerance;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t bytes;     // processed bytes of one repetition, 0 if not meaningful
+        uint64_t ops;       // operations of one repetition
+        uint64_t time_ns;   // time of the fastest repetition
+        uint64_t hits;      // matches, results or formatted characters of one repetition
+        uint64_t reallocations; // reallocations of the buffers of one repetition
+        bool checked;       // the result has been checked against the layout of the target
+        bool correct;
+    };
+
+    /*
+    * The values of a type that are seeded and searched for. The seeded value is between 'lower' and 'upper',
+    * the filler of the memory (0) is not.
+    */
+    struct Values
+    {
+        size_t size;
+        uint8_t value[sizeof(STRING_VALUE)], lower[8], upper[8];
+    };
+
+    template<typename T>
+    void make_values(Values& v)
+    {
+        const T value = static_cast<T>(100), lower = static_cast<T>(50), upper = static_cast<T>(120);
+        v.size = sizeof(T);
+        memcpy(v.value, &value, sizeof(T));
+        memcpy(v.lower, &lower, sizeof(T));
+        memcpy(v.upper, &upper, sizeof(T));
+    }
+
+    Values make_values(type_t type)
+    {
+        Values v;
+        switch (type)
+        {
+        case MEMORY_TYPE_INT8:      make_values<int8_t>(v); break;
+        case MEMORY_TYPE_UINT8:     make_values<uint8_t>(v); break;
+        case MEMORY_TYPE_INT16:     make_values<int16_t>(v); break;
+        case MEMORY_TYPE_UINT16:    make_values<uint16_t>(v); break;
+        case MEMORY_TYPE_INT32:     make_values<int32_t>(v); break;
+        case MEMORY_TYPE_UINT32:    make_values<uint32_t>(v); break;
+        case MEMORY_TYPE_INT64:     make_values<int64_t>(v); break;
+        case MEMORY_TYPE_UINT64:    make_values<uint64_t>(v); break;
+        case MEMORY_TYPE_FLOAT:     make_values<float>(v); break;
+        case MEMORY_TYPE_DOUBLE:    make_values<double>(v); break;
+        default:
+            v.size = sizeof(STRING_VALUE) - 1;
+            memcpy(v.value, STRING_VALUE, v.size);
+            break;
+        }
+        return v;
+    }
+
+    inline uint64_t elapsed_ns(clock_type::time_point t0) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - t0).count();
+    }
+
+    class Bench
+    {
+    private:
+        const Options& _opt;
+        std::vector<Result> _results;
+        uint64_t _reallocations;
+
+        bool selected(const std::string& name) const
+        {
+            return this->_opt.filter.empty() || name.find(this->_opt.filter) != std::string::npos;
+        }
+
+        /*
+        * Returns the time of the fastest repetition, 'fn' measures and returns the time of one repetition.
+        * The reallocations of the buffers of the last repetition are stored for the next result.
+        */
+        template<typename Fn>
+        uint64_t best_of(Fn fn)
+        {
+            uint64_t best = UINT64_MAX;
+            for (uint32_t i = 0; i < this->_opt.repetitions; i++)
+            {
+                Stats::reset_thread();
+                best = std::min<uint64_t>(best, fn());
+            }
+            Stats::Snapshot stats;
+            Stats::thread_snapshot(stats);
+            this->_reallocations = stats.counters[MEMORY_STAT_REALLOCATIONS];
+            return best;
+        }
+
+        void add(const std::string& name, uint64_t bytes, uint64_t ops, uint64_t time_ns, uint64_t hits)
+        {
+            this->_results.push_back({ name, bytes, ops, time_ns, hits, this->_reallocations, false, false });
+            this->_reallocations = 0;
+            std::cerr << name << ": " << time_ns / 1000000.0 << "ms" << std::endl;
+        }
+
+        void add_checked(const std::string& name, uint64_t bytes, uint64_t ops, uint64_t time_ns, uint64_t hits, bool correct)
+        {
+            this->_results.push_back({ name, bytes, ops, time_ns, hits, this->_reallocations, true, correct });
+            this->_reallocations = 0;
+            std::cerr << name << ": " << time_ns / 1000000.0 << "ms" << (correct ? "" : ", INCORRECT") << std::endl;
+        }
+
+    public:
+        explicit Bench(const Options& opt) : _opt(opt), _reallocations(0) {}
+
+        /*
+        * Scans a seeded block with Scanner::scan_block in chunks of SPLIT_SIZE, like a scan of a process
+        * without reading the memory. The matches are stored in a preallocated buffer.
+        */
+        void scan(void)
+        {
+            const size_t block_size = this->_opt.quick ? SCAN_SIZE_QUICK : SCAN_SIZE;
+            std::vector<uint8_t> block(block_size);
+            std::string type_name;
+            for (type_t type : ALL_TYPES)
+            {
+                const Values v = make_values(type);
+                utility::strtype(type, type_name);
+                for (uint16_t alignment : ALIGNMENTS)
+                {
+                    for (double density : DENSITIES)
+                    {
+                        // matches are seeded at every n-th aligned address and do not overlap
+                        const size_t slots = (block_size - v.size) / alignment + 1;
+                        size_t stride = (density > 0.0) ? static_cast<size_t>(1.0 / density) : slots;
+                        stride = std::max<size_t>(stride, (v.size + alignment - 1) / alignment);
+                        std::fill(block.begin(), block.end(), 0);
+                        uint64_t expected = 0;
+                        if (density > 0.0)
+                        {
+                            for (size_t slot = 0; slot < slots; slot += stride, expected++)
+                                memcpy(block.data() + slot * alignment, v.value, v.size);
+                        }
+
+                        for (int range = 0; range < 2; range++)
+                        {
+                            if (range && type == MEMORY_TYPE_STRING) continue;    // strings are only searched exactly
+                            std::stringstream ss;
+                            ss << (range ? "scan_range/" : "scan_exact/") << type_name << "/align=" << alignment << "/density=" << density;
+                            if (!this->selected(ss.str())) continue;
+
+                            const ScanSettings settings = { type, v.size, alignment, 0, block_size, SPLIT_SIZE };
+                            const uint8_t* a = range ? v.lower : v.value;
+                            const uint8_t* b = range ? v.upper : v.value;
+                            uint64_t hits = 0;
+                            const uint64_t time_ns = this->best_of([&]()
+                            {
+                                Buffer out(0, std::max<size_t>(expected * v.size, 1));
+                                hits = 0;
+                                const clock_type::time_point t0 = clock_type::now();
+                                for (size_t i = 0; i < block_size; i += SPLIT_SIZE)
+                                {
+                                    // chunks overlap by 'size - 1' bytes like the chunks of Scanner::scan
+                                    const size_t rd_size = std::min(block_size - i, SPLIT_SIZE + v.size - 1);
+                                    uint64_t chunk_hits;
+                                    Scanner::scan_block(settings, a, b, block.data() + i, rd_size, 0, i, out, chunk_hits);
+                                    hits += chunk_hits;
+                                }
+                                return elapsed_ns(t0);
+                            });
+                            this->add(ss.str(), block_size, slots, time_ns, hits);
+                        }
+                    }
+                }
+            }
+        }
+
+        /* Pushes 4-byte values into a preallocated buffer and into a buffer that grows with every push. */
+        void push(void)
+        {
+            const size_t counts[] = { this->_opt.quick ? PUSH_COUNT / 16 : PUSH_COUNT, this->_opt.quick ? GROW_COUNT / 16 : GROW_COUNT };
+            for (int grow = 0; grow < 2; grow++)
+            {
+                const std::string name = grow ? "buffer_push/grow" : "buffer_push/preallocated";
+                if (!this->selected(name)) continue;
+                const size_t count = counts[grow];
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    Buffer buffer(0, grow ? 0 : count * sizeof(uint32_t));
+                    const clock_type::time_point t0 = clock_type::now();
+                    for (uint32_t i = 0; i < count; i++)
+                        buffer.push(0, i * sizeof(uint32_t), sizeof(uint32_t), MEMORY_TYPE_UINT32, &i);
+                    return elapsed_ns(t0);
+                });
+                this->add(name, count * sizeof(uint32_t), count, time_ns, count);
+            }
+        }
+
+        /*
+        * Rereads and filters results with Scanner::filter, the results point to a seeded array of the own process.
+        * Every second value matches the filter.
+        */
+        void update(void)
+        {
+            const size_t count = this->_opt.quick ? UPDATE_COUNT / 16 : UPDATE_COUNT;
+            std::vector<uint32_t> values(count);
+            for (size_t i = 0; i < count; i++)
+                values[i] = (i % 2 == 0) ? 100 : 0;
+
+            const memory::pid_t pid = GetCurrentProcessId();
+            Buffer in(0, count * sizeof(uint32_t));
+            for (size_t i = 0; i < count; i++)
+                in.push(pid, reinterpret_cast<address_t>(values.data() + i), sizeof(uint32_t), MEMORY_TYPE_UINT32, &values[i]);
+
+            const uint32_t exact = 100;
+            for (int filter = 0; filter < 2; filter++)
+            {
+                const std::string name = filter ? "update/exact" : "update/reread";
+                if (!this->selected(name)) continue;
+                const uint8_t* a = filter ? reinterpret_cast<const uint8_t*>(&exact) : nullptr;
+                uint64_t hits = 0;
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    Buffer out(0, in.size());
+                    const clock_type::time_point t0 = clock_type::now();
+                    Scanner::filter(in, MEMORY_TYPE_UINT32, a, a, sizeof(uint32_t), out, nullptr, nullptr);
+                    const uint64_t time = elapsed_ns(t0);
+                    hits = out.table().size();
+                    return time;
+                });
+                this->add(name, in.size(), count, time_ns, hits);
+            }
+        }
+
+        /* Formats values of every type with utility::to_string, decimal and hexadecimal. */
+        void format(void)
+        {
+            const size_t count = this->_opt.quick ? FORMAT_COUNT / 16 : FORMAT_COUNT;
+            std::vector<uint64_t> values(count);
+            uint64_t x = 0x9E3779B97F4A7C15;    // xorshift, the values are the same for every run
+            for (uint64_t& value : values)
+            {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                value = x;
+            }
+
+            std::string type_name, str;
+            for (type_t type : ALL_TYPES)
+            {
+                if (type == MEMORY_TYPE_STRING) continue;
+                const size_t size = make_values(type).size;
+                utility::strtype(type, type_name);
+                for (int hex = 0; hex < 2; hex++)
+                {
+                    const std::string name = std::string("to_string/") + type_name + (hex ? "/hex" : "/dec");
+                    if (!this->selected(name)) continue;
+                    uint64_t chars = 0;
+                    const uint64_t time_ns = this->best_of([&]()
+                    {
+                        chars = 0;
+                        const clock_type::time_point t0 = clock_type::now();
+                        for (const uint64_t& value : values)
+                        {
+                            utility::to_string(reinterpret_cast<const uint8_t*>(&value), size, type, hex, str);
+                            chars += str.size();
+                        }
+                        return elapsed_ns(t0);
+                    });
+                    this->add(name, count * size, count, time_ns, chars);
+                }
+            }
+        }
+
+        /* Renders a search table into the buffer that Table::print writes, without writing it. */
+        void table(void)
+        {
+            struct RenderTable : public Table
+            {
+                using Table::render_buffer;
+            };
+
+            const std::string name = "table_print";
+            if (!this->selected(name)) return;
+            const uint32_t rows = this->_opt.quick ? TABLE_ROWS / 16 : TABLE_ROWS;
+
+            RenderTable table;
+            for (const char* title : { "PID", "Address", "Type", "Size", "Decimal", "Hexadecimal" })
+                table.add_column(title);
+            std::vector<std::string> entry(6);
+            for (uint32_t i = 0; i < rows; i++)
+            {
+                const uint32_t value = i * 2654435761u;
+                utility::to_dec_str<memory::pid_t>(1234, entry[0]);
+                utility::to_hex_str<address_t>(0x7FF600000000 + i * 4, entry[1]);
+                utility::strtype(MEMORY_TYPE_UINT32, entry[2]);
+                utility::to_dec_str<size_t>(sizeof(uint32_t), entry[3]);
+                utility::to_string(reinterpret_cast<const uint8_t*>(&value), sizeof(uint32_t), MEMORY_TYPE_UINT32, false, entry[4]);
+                utility::to_string(reinterpret_cast<const uint8_t*>(&value), sizeof(uint32_t), MEMORY_TYPE_UINT32, true, entry[5]);
+                table.add(entry);
+            }
+
+            std::string buffer;
+            const uint64_t time_ns = this->best_of([&]()
+            {
+                const clock_type::time_point t0 = clock_type::now();
+                table.render_buffer(buffer);
+                return elapsed_ns(t0);
+            });
+            this->add(name, buffer.size(), rows, time_ns, rows);
+        }
+
+        /*
+        * Starts memory_target with the ProcessHandler and measures the whole path against it: querying, reading and
+        * scanning its heap, updating the results, following its pointer chain and writing its slots.
+        * Every result is checked against the layout that the target sends over its control pipe.
+        */
+        bool target(const std::string& path)
+        {
+            uint64_t heap_size = this->_opt.quick ? TARGET_HEAP_QUICK : TARGET_HEAP;
+            const std::string pipe = std::string(target::PIPE_NAME) + std::to_string(GetCurrentProcessId());
+            std::stringstream args;
+            args << "\"" << path << "\" " << pipe << " " << TARGET_SEED << " " << heap_size;
+
+            ProcessHandler handler;
+            const memory::pid_t pid = handler.start_process(path, args.str());
+            if (pid == MEMORY_PID_INVALID) return false;
+
+            // the pipe exists as soon as the target has started
+            rpc::Connection connection;
+            const clock_type::time_point t0 = clock_type::now();
+            while (!connection.connect(pipe, TARGET_TIMEOUT) && elapsed_ns(t0) < TARGET_TIMEOUT * 1000000ull)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            rpc::FrameHeader header;
+            std::vector<uint8_t> payload, frame;
+            Process proc;
+            proc.init("", pid, 0, 0);
+            if (!connection.receive(header, payload) || header.op != MEMORY_TARGET_LAYOUT || !proc.open())
+            {
+                handler.stop_process(pid);
+                return false;
+            }
+
+            // layout of the target
+            struct Set
+            {
+                std::string name;
+                uint8_t type;
+                uint32_t size;
+                uint16_t alignment;
+                const uint8_t* a, * b;
+                std::vector<address_t> addresses;
+            };
+            rpc::Reader in(payload.data(), payload.size());
+            uint64_t heap_base = 0, chain_head = 0, chain_value = 0;
+            uint32_t chain_length = 0, n = 0;
+            in.get(heap_base);
+            in.get(heap_size);
+            in.get(chain_head);
+            in.get(chain_length);
+            in.get(chain_value);
+            std::vector<address_t> counters, slots;
+            for (std::vector<address_t>* addresses : { &counters, &slots })
+            {
+                in.get(n);
+                addresses->resize(std::min<size_t>(n, in.remaining() / sizeof(uint64_t)));
+                for (address_t& address : *addresses)
+                    in.get(address);
+            }
+            std::vector<Set> sets;
+            in.get(n);
+            for (uint32_t i = 0; i < n && in.ok(); i++)
+            {
+                Set set;
+                uint32_t m = 0;
+                in.get_string(set.name);
+                in.get(set.type);
+                in.get(set.size);
+                in.get(set.alignment);
+                set.a = in.get_bytes(set.size);
+                set.b = in.get_bytes(set.size);
+                in.get(m);
+                set.addresses.resize(std::min<size_t>(m, in.remaining() / sizeof(uint64_t)));
+                for (address_t& address : set.addresses)
+                    in.get(address);
+                sets.push_back(std::move(set));
+            }
+            if (!in.ok())
+            {
+                handler.stop_process(pid);
+                return false;
+            }
+
+            // scans of the heap, only the matches within the heap are compared with the expected ones
+            Buffer int_results;
+            for (const Set& set : sets)
+            {
+                const std::string name = "target/scan/" + set.name;
+                if (!this->selected(name) && !(set.type == MEMORY_TYPE_INT32 && this->selected("target/update/exact"))) continue;
+                const ScanSettings settings = { static_cast<type_t>(set.type), set.size, set.alignment, heap_base, heap_base + heap_size, SPLIT_SIZE };
+                Buffer out;
+                ScanProgress progress;
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    out = Buffer(0, (set.addresses.size() + 0x1000) * set.size);
+                    progress.reset();
+                    const clock_type::time_point t = clock_type::now();
+                    Scanner::scan(proc, settings, set.a, set.b, out, &progress, nullptr);
+                    return elapsed_ns(t);
+                });
+
+                std::vector<address_t> found;
+                for (const Buffer::Element& e : out.table())
+                {
+                    if (e.address >= heap_base && e.address + e.size <= heap_base + heap_size)
+                        found.push_back(e.address);
+                }
+                std::sort(found.begin(), found.end());
+                if (this->selected(name))
+                    this->add_checked(name, progress.bytes, progress.bytes / std::max<uint16_t>(set.alignment, 1), time_ns, found.size(), found == set.addresses);
+                if (set.type == MEMORY_TYPE_INT32)
+                    int_results = std::move(out);
+            }
+
+            // an exact update keeps every result of the int32 scan
+            const Set* int_set = nullptr;
+            for (const Set& set : sets)
+                int_set = (set.type == MEMORY_TYPE_INT32) ? &set : int_set;
+            if (int_set != nullptr && this->selected("target/update/exact"))
+            {
+                Buffer out;
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    out = Buffer(0, int_results.size());
+                    const clock_type::time_point t = clock_type::now();
+                    Scanner::filter(int_results, MEMORY_TYPE_INT32, int_set->a, int_set->b, sizeof(int32_t), out, nullptr, nullptr);
+                    return elapsed_ns(t);
+                });
+                this->add_checked("target/update/exact", int_results.size(), int_results.table().size(), time_ns, out.table().size(),
+                                  out.table().size() == int_results.table().size());
+            }
+
+            // rereading the counters twice, every counter must have been incremented in between
+            if (this->selected("target/update/counters"))
+            {
+                Buffer first, second;
+                for (address_t counter : counters)
+                    first.push(pid, counter, sizeof(uint32_t), MEMORY_TYPE_UINT32, nullptr);
+                Scanner::filter(first, MEMORY_TYPE_UINT32, nullptr, nullptr, 0, second, nullptr, nullptr);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                Buffer third;
+                const clock_type::time_point t = clock_type::now();
+                Scanner::filter(second, MEMORY_TYPE_UINT32, nullptr, nullptr, 0, third, nullptr, nullptr);
+                const uint64_t time_ns = elapsed_ns(t);
+
+                bool correct = (third.table().size() == counters.size() && second.table().size() == counters.size());
+                for (size_t i = 0; correct && i < counters.size(); i++)
+                {
+                    uint32_t before, after;
+                    memcpy(&before, second.table()[i].data, sizeof(uint32_t));
+                    memcpy(&after, third.table()[i].data, sizeof(uint32_t));
+                    correct = (after > before);
+                }
+                this->add_checked("target/update/counters", third.size(), counters.size(), time_ns, third.table().size(), correct);
+            }
+
+            // following the pointer chain, every node is read separately
+            if (this->selected("target/read/chain"))
+            {
+                uint32_t length = 0;
+                uint64_t node[2] = { 0, 0 };
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    length = 0;
+                    const clock_type::time_point t = clock_type::now();
+                    for (address_t next = chain_head; next != 0 && length <= chain_length; length++)
+                    {
+                        if (proc.read(next, sizeof(node), node) != sizeof(node)) break;
+                        next = node[0];
+                    }
+                    return elapsed_ns(t);
+                });
+                this->add_checked("target/read/chain", chain_length * sizeof(node), chain_length, time_ns, length,
+                                  length == chain_length && node[0] == 0 && node[1] == chain_value);
+            }
+
+            // writing the slots with one batch, the target counts the slots that hold the written value
+            if (this->selected("target/write/slots"))
+            {
+                const uint32_t value = TARGET_WRITE;
+                IoBatch batch;
+                for (address_t slot : slots)
+                    batch.add(slot, sizeof(uint32_t), &value);
+                const uint64_t time_ns = this->best_of([&]()
+                {
+                    const clock_type::time_point t = clock_type::now();
+                    batch.write(proc);
+                    return elapsed_ns(t);
+                });
+
+                uint32_t count = 0;
+                rpc::Writer out(frame, static_cast<rpc_op_t>(MEMORY_TARGET_CHECK), 1);
+                out.put<uint32_t>(value);
+                out.finish();
+                if (connection.send(frame) && connection.receive(header, payload) && header.op == MEMORY_TARGET_REPLY)
+                {
+                    rpc::Reader reply(payload.data(), payload.size());
+                    reply.get(count);
+                }
+                this->add_checked("target/write/slots", slots.size() * sizeof(uint32_t), slots.size(), time_ns, count, count == slots.size());
+            }
+
+            proc.close();
+            rpc::Writer out(frame, static_cast<rpc_op_t>(MEMORY_TARGET_EXIT), 2);
+            out.finish();
+            if (connection.send(frame))
+                connection.receive(header, payload);
+            handler.stop_process(pid);
+            return true;
+        }
+
+        /** @return 'false' if a checked result is not correct. */
+        bool correct(void) const noexcept
+        {
+            for (const Result& r : this->_results)
+            {
+                if (r.checked && !r.correct) return false;
+            }
+            return true;
+        }
+
+        /*
+        * Compares the results with the baseline, a result fails if it is slower than the baseline by more
+        * than the tolerance or if it reallocates more often. Results that are not in the baseline are not compared.
+        */
+        bool check_baseline(const std::map<std::string, Baseline>& baseline) const
+        {
+            bool passed = true;
+            for (const Result& r : this->_results)
+            {
+                const auto it = baseline.find(r.name);
+                if (it == baseline.end()) continue;
+                const Baseline& b = it->second;
+                const double ns_op = static_cast<double>(r.time_ns) / std::max<uint64_t>(r.ops, 1);
+                if (ns_op > b.ns_op * (1.0 + b.tolerance))
+                {
+                    std::stringstream ss;
+                    ss << std::fixed << std::setprecision(3) << "REGRESSION " << r.name << ": " << ns_op << " ns/op, baseline " << b.ns_op
+                       << " ns/op (+" << std::setprecision(1) << (ns_op / b.ns_op - 1.0) * 100.0 << "%, tolerance " << b.tolerance * 100.0 << "%)";
+                    std::cerr << ss.str() << std::endl;
+                    passed = false;
+                }
+                if (r.reallocations > b.reallocations)
+                {
+                    std::cerr << "REGRESSION " << r.name << ": " << r.reallocations << " reallocations, baseline " << b.reallocations << std::endl;
+                    passed = false;
+                }
+            }
+            return passed;
+        }
+
+        /*
+        * Writes the results as baseline. The tolerances of the previous baseline are kept, as well as the entries
+        * that have not been measured.
+        */
+        void write_baseline(std::ostream& out, const std::map<std::string, Baseline>& previous) const
+        {
+            std::map<std::string, Baseline> baseline = previous;
+            for (const Result& r : this->_results)
+            {
+                const auto it = previous.find(r.name);
+                const double tolerance = (it != previous.end()) ? it->second.tolerance : BASELINE_TOLERANCE;
+                baseline[r.name] = { static_cast<double>(r.time_ns) / std::max<uint64_t>(r.ops, 1), r.reallocations, tolerance };
+            }
+
+            out << "# memory_bench baseline, " << (this->_opt.quick ? "quick" : "full") << " inputs, written with --update-baseline\n"
+                << "# <name> <ns/op> <reallocations> [<tolerance>]\n"
+                << "# The times depend on the machine, the tolerances are kept when the baseline is updated.\n" << std::setprecision(6);
+            for (const std::pair<const std::string, Baseline>& e : baseline)
+            {
+                out << e.first << " " << e.second.ns_op << " " << e.second.reallocations;
+                if (e.second.tolerance != BASELINE_TOLERANCE)
+                    out << " " << e.second.tolerance;
+                out << "\n";
+            }
+            out.flush();
+        }
+
+        /** @brief Writes all results as one JSON object. */
+        void write_json(std::ostream& out) const
+        {
+            out << "{\n  \"version\": " << JSON_VERSION << ",\n  \"repetitions\": " << this->_opt.repetitions
+                << ",\n  \"quick\": " << (this->_opt.quick ? "true" : "false") << ",\n  \"results\": [";
+            for (size_t i = 0; i < this->_results.size(); i++)
+            {
+                const Result& r = this->_results[i];
+                const double time = static_cast<double>(std::max<uint64_t>(r.time_ns, 1));
+                out << (i > 0 ? ",\n" : "\n") << std::fixed << std::setprecision(3)
+                    << "    { \"name\": \"" << r.name << "\", \"bytes\": " << r.bytes << ", \"ops\": " << r.ops
+                    << ", \"hits\": " << r.hits << ", \"reallocations\": " << r.reallocations << ", \"time_ns\": " << r.time_ns
+                    << ", \"gb_s\": " << r.bytes / time << ", \"ns_op\": " << time / std::max<uint64_t>(r.ops, 1);
+                if (r.checked)
+                    out << ", \"correct\": " << (r.correct ? "true" : "false");
+                out << " }";
+            }
+            out << "\n  ]\n}" << std::endl;
+        }
+    };
+
+    /**
+    * @return 'false' if the file has an invalid line or if it is missing and 'optional' is not set,
+    *   a missing optional file is an empty baseline.
+    */
+    bool read_baseline(const std::string& path, bool optional, std::map<std::string, Baseline>& baseline)
+    {
+        baseline.clear();
+        std::ifstream file(path);
+        if (!file)
+        {
+            if (optional) return true;
+            std::cerr << "Failed to open the baseline \"" << path << "\"." << std::endl;
+            return false;
+        }
+        std::string line;
+        for (uint32_t n = 1; std::getline(file, line); n++)
+        {
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos)
+                line.erase(comment);
+            std::istringstream in(line);
+            std::string name;
+            if (!(in >> name)) continue;
+
+            Baseline b = { 0.0, 0, BASELINE_TOLERANCE };
+            if (!(in >> b.ns_op >> b.reallocations) || b.ns_op <= 0.0)
+            {
+                std::cerr << path << ":" << n << ": invalid baseline entry." << std::endl;
+                return false;
+            }
+            in >> b.tolerance;
+            baseline[name] = b;
+        }
+        return true;
+    }
+
+    bool parse_arguments(const int argc, const char* const * const argv, Options& opt)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-o" && i + 1 < argc)
+                opt.output = argv[++i];
+            else if (arg == "-f" && i + 1 < argc)
+                opt.filter = argv[++i];
+            else if (arg == "-r" && i + 1 < argc)
+            {
+                uint64_t n;
+                const std::string str = argv[++i];
+                if (utility::to_bytes(str, sizeof(uint64_t), MEMORY_TYPE_UINT64, false, reinterpret_cast<uint8_t*>(&n)) != MEMORY_PARSE_OK || n == 0 || n > UINT32_MAX)
+                    return false;
+                opt.repetitions = static_cast<uint32_t>(n);
+            }
+            else if (arg == "-q" || arg == "--quick")
+                opt.quick = true;
+            else if (arg == "-t" && i + 1 < argc)
+                opt.target = argv[++i];
+            else if (arg == "-b" && i + 1 < argc)
+                opt.baseline = argv[++i];
+            else if (arg == "--update-baseline")
+                opt.update_baseline = true;
+            else
+                return false;
+        }
+        return !opt.update_baseline || !opt.baseline.empty();
+    }
+}
+
+int main(const int argc, const char* const * const argv)
+{
+    Options opt;
+    if (!parse_arguments(argc, argv, opt))
+    {
+        std::cerr << USAGE << std::endl;
+        return EXIT_USAGE;
+    }
+
+    // the progress of the benchmarks is written to the error output
+    Bench bench(opt);
+    bench.scan();
+    bench.push();
+    bench.update();
+    bench.format();
+    bench.table();
+    if (!opt.target.empty() && !bench.target(opt.target))
+    {
+        std::cerr << "Failed to start the target \"" << opt.target << "\"." << std::endl;
+        return EXIT_CHECK;
+    }
+
+    if (opt.output.empty())
+        bench.write_json(std::cout);
+    else
+    {
+        std::ofstream file(opt.output);
+        if (!file)
+        {
+            std::cerr << "Failed to open the file \"" << opt.output << "\"." << std::endl;
+            return EXIT_USAGE;
+        }
+        bench.write_json(file);
+    }
+    bool passed = bench.correct();
+
+    if (!opt.baseline.empty())
+    {
+        std::map<std::string, Baseline> baseline;
+        // only an update may create the baseline, a missing baseline would pass every result
+        if (!read_baseline(opt.baseline, opt.update_baseline, baseline))
+            return EXIT_USAGE;
+        if (opt.update_baseline)
+        {
+            std::ofstream file(opt.baseline);
+            if (!file)
+            {
+                std::cerr << "Failed to open the file \"" << opt.baseline << "\"." << std::endl;
+                return EXIT_USAGE;
+            }
+            bench.write_baseline(file, baseline);
+        }
+        else
+            passed = bench.check_baseline(baseline) && passed;
+    }
+    return passed ? 0 : EXIT_CHECK;
+}
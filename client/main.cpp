@@ -0,0 +1,386 @@
+/**
+* @file     client/main.cpp
+* @brief    Main function of the client sub-program. Sends one request to a memory server.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "../src/memory/memory.h"
+#include <iostream>
+
+/*
+* Syntax: memory_client <name> <request> [arguments]
+* The reply is written to the standard output, progress events are written to the error output.
+* Returns 0 if the request has succeeded, 1 if the server has answered with an error and 2 if the
+* arguments are invalid or the connection has failed.
+*/
+namespace
+{
+    using namespace memory;
+
+    constexpr uint32_t CONNECT_TIMEOUT  = 5000;
+    constexpr uint32_t REQUEST_ID       = 1;
+    constexpr int EXIT_ERROR            = 1;
+    constexpr int EXIT_USAGE            = 2;
+
+    const char USAGE[] =
+        "Usage: memory_client <name> <request> [arguments]\n"
+        "   scan <type> <value> [max=<value>] [pid=<pid>]... [align=<n>] [begin=<address>] [end=<address>]\n"
+        "   update [<type> <value> [max=<value>]]   (without arguments the values are reread)\n"
+        "   results [<first> [<count>]]\n"
+        "   read <pid> <address> <size>\n"
+        "   write <pid> <address> <type> <value>\n"
+        "   watch start [<interval> [<count>]] | stop | stats\n"
+        "   export text|csv|jsonl|binary <path>\n"
+        "   cancel\n"
+        "Numbers with the prefix \"0x\" are hexadecimal.";
+
+    inline bool is_hex(const std::string& str) noexcept
+    {
+        return str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
+    }
+
+    bool parse_type(const std::string& str, type_t& type)
+    {
+        std::string name;
+        for (uint8_t t = MEMORY_TYPE_INT8; t <= MEMORY_TYPE_STRING; t++)
+        {
+            utility::strtype(static_cast<type_t>(t), name);
+            if (name == str)
+            {
+                type = static_cast<type_t>(t);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parse_number(const std::string& str, uint64_t max, uint64_t& x)
+    {
+        return utility::to_bytes(str, sizeof(uint64_t), MEMORY_TYPE_UINT64, is_hex(str), reinterpret_cast<uint8_t*>(&x)) == MEMORY_PARSE_OK && x <= max;
+    }
+
+    /** @brief Converts a value of a type, strings are taken as they are. */
+    bool parse_value(const std::string& str, type_t type, std::vector<uint8_t>& value)
+    {
+        if (type == MEMORY_TYPE_STRING)
+        {
+            value.assign(str.begin(), str.end());
+            return !value.empty();
+        }
+
+        size_t size;
+        switch (type)
+        {
+        case MEMORY_TYPE_INT8:
+        case MEMORY_TYPE_UINT8:     size = 1; break;
+        case MEMORY_TYPE_INT16:
+        case MEMORY_TYPE_UINT16:    size = 2; break;
+        case MEMORY_TYPE_INT32:
+        case MEMORY_TYPE_UINT32:
+        case MEMORY_TYPE_FLOAT:     size = 4; break;
+        default:                    size = 8; break;
+        }
+        value.resize(size);
+        return utility::to_bytes(str, size, type, is_hex(str), value.data()) == MEMORY_PARSE_OK;
+    }
+
+    void print_value(const uint8_t* value, size_t size, type_t type)
+    {
+        if (type == MEMORY_TYPE_STRING || size > sizeof(uint64_t))
+            std::cout << std::string(reinterpret_cast<const char*>(value), size);
+        else
+        {
+            char str[utility::MAX_VALUE_CHARS];
+            std::cout << std::string(str, utility::format_value(value, type, false, str));
+        }
+    }
+
+    /** @brief Builds the request of the arguments after the request name. */
+    bool build_request(const std::string& request, const std::vector<std::string>& args, std::vector<uint8_t>& frame, bool& job)
+    {
+        job = false;
+        uint64_t x, y, z;
+        type_t type;
+        std::vector<uint8_t> a, b;
+
+        if (request == "scan")
+        {
+            if (args.size() < 2 || !parse_type(args[0], type) || !parse_value(args[1], type, a)) return false;
+            b = a;
+            std::vector<uint32_t> pids;
+            uint64_t alignment = 1, begin = 0, end = 0x8000000000000000;
+            for (size_t i = 2; i < args.size(); i++)
+            {
+                const size_t eq = args[i].find('=');
+                const std::string key = args[i].substr(0, eq), value = (eq != std::string::npos) ? args[i].substr(eq + 1) : "";
+                if (key == "max" && parse_value(value, type, b) && b.size() == a.size()) continue;
+                if (key == "pid" && parse_number(value, UINT32_MAX, x)) { pids.push_back(static_cast<uint32_t>(x)); continue; }
+                if (key == "align" && parse_number(value, UINT16_MAX, alignment)) continue;
+                if (key == "begin" && parse_number(value, UINT64_MAX, begin)) continue;
+                if (key == "end" && parse_number(value, UINT64_MAX, end)) continue;
+                return false;
+            }
+
+            rpc::Writer out(frame, MEMORY_RPC_SCAN, REQUEST_ID);
+            out.put<uint8_t>(type);
+            out.put<uint32_t>(static_cast<uint32_t>(a.size()));
+            out.put<uint16_t>(static_cast<uint16_t>(alignment));
+            out.put<uint64_t>(begin);
+            out.put<uint64_t>(end);
+            out.put<uint32_t>(static_cast<uint32_t>(pids.size()));
+            for (uint32_t pid : pids)
+                out.put<uint32_t>(pid);
+            out.put(a.data(), a.size());
+            out.put(b.data(), b.size());
+            out.finish();
+            job = true;
+            return true;
+        }
+        if (request == "update")
+        {
+            type = MEMORY_TYPE_VOID;
+            if (!args.empty())
+            {
+                if (args.size() < 2 || args.size() > 3 || !parse_type(args[0], type) || !parse_value(args[1], type, a)) return false;
+                b = a;
+                if (args.size() == 3 && (args[2].compare(0, 4, "max=") != 0 || !parse_value(args[2].substr(4), type, b) || b.size() != a.size())) return false;
+            }
+
+            rpc::Writer out(frame, MEMORY_RPC_UPDATE, REQUEST_ID);
+            out.put<uint8_t>(args.empty() ? 0 : 1);
+            out.put<uint8_t>(type);
+            out.put<uint32_t>(static_cast<uint32_t>(a.size()));
+            out.put(a.data(), a.size());
+            out.put(b.data(), b.size());
+            out.finish();
+            job = true;
+            return true;
+        }
+        if (request == "results")
+        {
+            x = 0;
+            y = 100;
+            if (args.size() > 2 || (args.size() > 0 && !parse_number(args[0], UINT64_MAX, x)) || (args.size() > 1 && !parse_number(args[1], UINT32_MAX, y))) return false;
+
+            rpc::Writer out(frame, MEMORY_RPC_RESULTS, REQUEST_ID);
+            out.put<uint64_t>(x);
+            out.put<uint32_t>(static_cast<uint32_t>(y));
+            out.finish();
+            return true;
+        }
+        if (request == "read")
+        {
+            if (args.size() != 3 || !parse_number(args[0], UINT32_MAX, x) || !parse_number(args[1], UINT64_MAX, y) || !parse_number(args[2], UINT32_MAX, z)) return false;
+
+            rpc::Writer out(frame, MEMORY_RPC_READ, REQUEST_ID);
+            out.put<uint32_t>(static_cast<uint32_t>(x));
+            out.put<uint64_t>(y);
+            out.put<uint32_t>(static_cast<uint32_t>(z));
+            out.finish();
+            return true;
+        }
+        if (request == "write")
+        {
+            if (args.size() != 4 || !parse_number(args[0], UINT32_MAX, x) || !parse_number(args[1], UINT64_MAX, y) || !parse_type(args[2], type) || !parse_value(args[3], type, a)) return false;
+
+            rpc::Writer out(frame, MEMORY_RPC_WRITE, REQUEST_ID);
+            out.put<uint32_t>(static_cast<uint32_t>(x));
+            out.put<uint64_t>(y);
+            out.put<uint32_t>(static_cast<uint32_t>(a.size()));
+            out.put(a.data(), a.size());
+            out.finish();
+            return true;
+        }
+        if (request == "watch")
+        {
+            if (args.empty()) return false;
+            rpc::Writer out(frame, MEMORY_RPC_WATCH, REQUEST_ID);
+            if (args[0] == "start")
+            {
+                x = 100;
+                y = 100;
+                if (args.size() > 3 || (args.size() > 1 && !parse_number(args[1], UINT32_MAX, x)) || (args.size() > 2 && !parse_number(args[2], UINT32_MAX, y))) return false;
+                out.put<uint8_t>(MEMORY_RPC_WATCH_START);
+                out.put<uint32_t>(static_cast<uint32_t>(x));
+                out.put<uint32_t>(static_cast<uint32_t>(y));
+            }
+            else if (args[0] == "stop" && args.size() == 1)
+                out.put<uint8_t>(MEMORY_RPC_WATCH_STOP);
+            else if (args[0] == "stats" && args.size() == 1)
+                out.put<uint8_t>(MEMORY_RPC_WATCH_STATISTICS);
+            else
+                return false;
+            out.finish();
+            return true;
+        }
+        if (request == "export")
+        {
+            if (args.size() != 2) return false;
+            uint8_t format;
+            if      (args[0] == "text")     format = MEMORY_EXPORT_TEXT;
+            else if (args[0] == "csv")      format = MEMORY_EXPORT_CSV;
+            else if (args[0] == "jsonl")    format = MEMORY_EXPORT_JSONL;
+            else if (args[0] == "binary")   format = rpc::EXPORT_BINARY;
+            else                            return false;
+
+            rpc::Writer out(frame, MEMORY_RPC_EXPORT, REQUEST_ID);
+            out.put<uint8_t>(format);
+            out.put_string(args[1]);
+            out.finish();
+            job = true;
+            return true;
+        }
+        if (request == "cancel" && args.empty())
+        {
+            rpc::Writer out(frame, MEMORY_RPC_CANCEL, REQUEST_ID);
+            out.finish();
+            return true;
+        }
+        return false;
+    }
+
+    /** @brief Prints the reply of a request. */
+    void print_reply(const std::string& request, const std::vector<std::string>& args, rpc::Reader& in)
+    {
+        uint32_t n = 0;
+        if (request == "results")
+        {
+            uint64_t total = 0;
+            in.get(total);
+            in.get(n);
+            const uint8_t* records = in.get_bytes(n * sizeof(rpc::ResultRecord));
+            if (records == nullptr) return;
+            std::cout << "total: " << total << std::endl;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                rpc::ResultRecord record;
+                memcpy(&record, records + i * sizeof(rpc::ResultRecord), sizeof(rpc::ResultRecord));
+                const uint8_t* value = in.get_bytes(record.size);
+                if (value == nullptr) return;
+
+                std::string type;
+                utility::strtype(static_cast<type_t>(record.type), type);
+                std::cout << record.pid << " 0x" << std::hex << std::uppercase << record.address << std::dec << " " << type << " " << record.size << " ";
+                print_value(value, record.size, static_cast<type_t>(record.type));
+                std::cout << std::endl;
+            }
+        }
+        else if (request == "read")
+        {
+            in.get(n);
+            const uint8_t* data = in.get_bytes(n);
+            if (data == nullptr) return;
+            constexpr static char table[] = "0123456789ABCDEF";
+            std::string line = "read " + std::to_string(n) + " bytes:";
+            for (uint32_t i = 0; i < n; i++)
+            {
+                line.push_back(' ');
+                line.push_back(table[data[i] >> 4]);
+                line.push_back(table[data[i] & 0xF]);
+            }
+            std::cout << line << std::endl;
+        }
+        else if (request == "write")
+        {
+            in.get(n);
+            std::cout << "written " << n << " bytes" << std::endl;
+        }
+        else if (request == "watch" && args[0] == "start")
+        {
+            in.get(n);
+            std::cout << "watching " << n << " addresses" << std::endl;
+        }
+        else if (request == "watch" && args[0] == "stats")
+        {
+            in.get(n);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                rpc::WatchRecord record;
+                if (!in.get(record)) return;
+                std::cout << record.pid << " 0x" << std::hex << std::uppercase << record.address << std::dec << " ";
+                print_value(record.last, record.size, static_cast<type_t>(record.type));
+                std::cout << " min=" << record.min << " max=" << record.max << " mean=" << record.mean << " samples=" << record.samples
+                          << " failed=" << record.failed << " changes=" << record.changes << " rate=" << record.change_rate << std::endl;
+            }
+        }
+    }
+}
+
+int main(const int argc, const char* const * const argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << USAGE << std::endl;
+        return EXIT_USAGE;
+    }
+    const std::string name = argv[1], request = argv[2];
+    const std::vector<std::string> args(argv + 3, argv + argc);
+
+    std::vector<uint8_t> frame;
+    bool job;
+    if (!build_request(request, args, frame, job))
+    {
+        std::cerr << USAGE << std::endl;
+        return EXIT_USAGE;
+    }
+
+    rpc::Connection connection;
+    if (!connection.connect(name, CONNECT_TIMEOUT) || !connection.send(frame))
+    {
+        std::cerr << "Failed to connect to the server \"" << name << "\"." << std::endl;
+        return EXIT_USAGE;
+    }
+
+    // scans, updates and exports are finished by a DONE event, all other requests by their reply
+    rpc::FrameHeader header;
+    std::vector<uint8_t> payload;
+    while (connection.receive(header, payload))
+    {
+        if (header.id != REQUEST_ID) continue;
+        rpc::Reader in(payload.data(), payload.size());
+        switch (header.op)
+        {
+        case MEMORY_RPC_ERROR:
+        {
+            std::string msg;
+            in.get_string(msg);
+            std::cerr << "Error: " << msg << std::endl;
+            return EXIT_ERROR;
+        }
+        case MEMORY_RPC_REPLY:
+            print_reply(request, args, in);
+            if (!job) return 0;
+            break;
+        case MEMORY_RPC_PROGRESS:
+        {
+            uint64_t bytes_total = 0, bytes = 0, regions_total = 0, regions = 0, hits = 0;
+            in.get(bytes_total);
+            in.get(bytes);
+            in.get(regions_total);
+            in.get(regions);
+            in.get(hits);
+            std::cerr << "progress: " << bytes << "/" << bytes_total << " bytes, " << regions << "/" << regions_total << " regions, " << hits << " hits" << std::endl;
+            break;
+        }
+        case MEMORY_RPC_DONE:
+        {
+            uint8_t status = MEMORY_SCAN_DONE;
+            uint64_t count = 0;
+            in.get(status);
+            in.get(count);
+            const char* const status_str[] = { "done", "limit reached", "cancelled" };
+            std::cout << ((status <= MEMORY_SCAN_CANCELLED) ? status_str[status] : "unknown") << ": " << count << std::endl;
+            return 0;
+        }
+        default:
+            break;
+        }
+    }
+    std::cerr << "The connection to the server \"" << name << "\" has been lost." << std::endl;
+    return EXIT_USAGE;
+}
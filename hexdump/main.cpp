@@ -12,34 +12,64 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "../src/memory/memory.h"
+#include <algorithm>
+#include <cstring>
 #include <thread>
 #include <inttypes.h>
 
-/* 
-* Syntax: hexdump.exe <pid> <begin> <range> <byte width> <update speed [ms]>
-* 
+/*
+* Syntax: hexdump.exe <pid> <begin> <range> <byte width> <update speed [ms]> <highlight changes> <ascii column> [<file>]
+*
 * INFO:
 *   <pid>               : DECIMAL
 *   <begin>             : HEXADECIMAL
 *   <range>             : HEXADECIMAL
 *   <byte width>        : HEXADECIMAL
 *   <update speed [ms]> : DECIMAL
+*   <highlight changes> : 0 or 1
+*   <ascii column>      : 0 or 1
+*   <file>              : snapshot or core dump that is shown instead of the process
+*/
+
+/*
+* Only the lines that fit into the console window are read. The readable regions of the process
+* are queried once per second and every read is split at the region boundaries, so that unmapped
+* memory only hides the bytes that are actually unreadable.
 */
+struct Viewport
+{
+    memory::address_t begin;
+    size_t size;
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> readable;  // 1 if the byte could be read
+};
+
+struct RegionMap
+{
+    memory::address_t begin, end;   // queried address range
+    std::vector<memory::MemoryInfo> regions;
+    std::chrono::time_point<std::chrono::high_resolution_clock> time;
+};
 
 void key_thread_func(const std::atomic_bool* running, std::atomic<memory::address_t>* begin, uint32_t width);
+uint32_t visible_lines(uint32_t max_lines);
+void update_regions(memory::MemorySource& proc, memory::address_t begin, size_t size, RegionMap& map);
+void fetch(memory::MemorySource& proc, const RegionMap& map, memory::address_t begin, size_t size, uint8_t* bytes, uint8_t* readable);
+void scroll(memory::MemorySource& proc, RegionMap& map, memory::address_t begin, Viewport& view);
+void show(const Viewport& view, uint32_t width, memory::HexDump& dump, memory::Screen& screen, std::vector<std::string>& lines);
 
 int main(const int argc, const char* const * const argv)
 {
     using namespace std::chrono;
 
-    // check correct argument length
-    if (argc != 6) return -1;   // -1: invalid argument length
+    // check correct argument length, the last argument is optional
+    if (argc != 8 && argc != 9) return -1;   // -1: invalid argument length
 
     // convert arguments
     memory::pid_t pid;
     std::atomic<memory::address_t> begin;
     memory::address_t tmp_begin, range;
-    uint32_t width, tmp_update_speed;
+    uint32_t width, tmp_update_speed, highlight, ascii;
     milliseconds update_speed;
     std::atomic_bool running = true;
 
@@ -48,59 +78,200 @@ int main(const int argc, const char* const * const argv)
     sscanf(argv[3], "%" PRIx64, &range);
     sscanf(argv[4], "%" PRIx32, &width);
     sscanf(argv[5], "%" PRIu32, &tmp_update_speed);
+    sscanf(argv[6], "%" PRIu32, &highlight);
+    sscanf(argv[7], "%" PRIu32, &ascii);
     begin = tmp_begin;
     update_speed = milliseconds(tmp_update_speed);
+    if (width == 0) return -1;
 
-    // open process
-    memory::Process proc;
-    proc.init("", pid, 0, 0);     // other information are irrelevent
-    if (!proc.open()) return -2;    // -2: failed to open process
-
-    // create buffer
-    uint8_t* buff = new uint8_t[range];
+    // open process, or the snapshot or core dump that is shown instead of the process
+    memory::Process process;
+    std::unique_ptr<memory::MappedSource> file;
+    if (argc == 9)
+    {
+        file = memory::MappedSource::open_file(argv[8]);
+        if (file == nullptr) return -2;
+    }
+    else
+    {
+        process.init("", pid, 0, 0);     // other information are irrelevent
+        if (!process.open()) return -2;    // -2: failed to open process
+    }
+    memory::MemorySource& proc = (file != nullptr) ? static_cast<memory::MemorySource&>(*file) : process;
 
     // initialize hex dump
-    memory::HexDump dump(range / width, width);
+    const uint32_t max_lines = range / width;
+    memory::HexDump dump(visible_lines(max_lines), width, ascii != 0);
+    std::vector<std::string> lines;
+    Viewport view = { begin, 0, {}, {} };
+    RegionMap map = { 0, 0, {}, {} };
+
+    // only the changed characters are written, changed bytes stay highlighted for about one second
+    memory::Screen screen;
+    memory::Screen::enable_virtual_terminal();
+    if (highlight != 0)
+        screen.set_highlight((tmp_update_speed > 0 && tmp_update_speed < 1000) ? 1000 / tmp_update_speed : 1);
 
     // start key handler thread
     std::thread key_handler(key_thread_func, &running, &begin, width);
 
     // NOTE: This program is not returning, it gets started and terminated by the memory application.
     // However, it is cleaned up correctly as if it would return.
+    const milliseconds scroll_time(10);
     time_point<high_resolution_clock> tp;
     while (true)
     {
         tp = high_resolution_clock::now() + update_speed;
 
-        // read memory from process
-        if (proc.read(begin, range, buff) == 0)
-            memset(buff, 0xFF, range);
+        // the dump shrinks or grows with the console window
+        const uint32_t n_lines = visible_lines(max_lines);
+        if (n_lines != dump.line_count())
+            dump.resize(n_lines, width);
 
-        // build hex dump table
-        dump.front();
-        for (uint32_t i = 0; i < dump.line_count(); i++)
+        // read the visible memory
+        view.begin = begin;
+        view.size = static_cast<size_t>(n_lines) * width;
+        view.bytes.resize(view.size);
+        view.readable.resize(view.size);
+        update_regions(proc, view.begin, view.size, map);
+        fetch(proc, map, view.begin, view.size, view.bytes.data(), view.readable.data());
+        show(view, width, dump, screen, lines);
+
+        // wait for tick to end, scrolling only reads the lines that have become visible
+        while (high_resolution_clock::now() < tp)
         {
-            dump.set(begin + i * width, buff + i * width);
-            dump.inc();
+            std::this_thread::sleep_until(std::min(tp, high_resolution_clock::now() + scroll_time));
+            if (begin != view.begin)
+            {
+                scroll(proc, map, begin, view);
+                show(view, width, dump, screen, lines);
+            }
         }
-
-        // print table
-        SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), { 0, 0 });
-        dump.print();
-
-        // wait for tick to end
-        std::this_thread::sleep_until(tp);
     }
 
     // stop key handler thread
     running = false;
     key_handler.join();
-
-    // destroy buffer
-    delete[] buff;
     return 0;
 }
 
+uint32_t visible_lines(uint32_t max_lines)
+{
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+        return max_lines;
+
+    // the first and the last line are separator lines
+    const int32_t rows = info.srWindow.Bottom - info.srWindow.Top + 1 - 2;
+    if (rows <= 0) return 1;
+    return (static_cast<uint32_t>(rows) < max_lines) ? static_cast<uint32_t>(rows) : max_lines;
+}
+
+void update_regions(memory::MemorySource& proc, memory::address_t begin, size_t size, RegionMap& map)
+{
+    using namespace std::chrono;
+    constexpr static milliseconds refresh_time(1000);
+    constexpr static memory::address_t margin = 0x100000;    // scrolling within the margin does not need a new query
+
+    const time_point<high_resolution_clock> now = high_resolution_clock::now();
+    if (begin >= map.begin && begin + size <= map.end && now - map.time < refresh_time)
+        return;
+
+    map.begin = (begin > margin) ? begin - margin : 0;
+    map.end = begin + size + margin;
+    map.time = now;
+    proc.query(map.begin, map.end, map.regions);
+}
+
+void fetch(memory::MemorySource& proc, const RegionMap& map, memory::address_t begin, size_t size, uint8_t* bytes, uint8_t* readable)
+{
+    constexpr static memory::address_t page_size = memory::IoBatch::PAGE_SIZE;
+
+    memset(readable, 0, size);
+    const memory::address_t end = begin + size;
+    for (const memory::MemoryInfo& region : map.regions)
+    {
+        const memory::address_t first = std::max(begin, region.base);
+        const memory::address_t last = std::min(end, region.base + region.size);
+        if (first >= last) continue;
+
+        // a region is read at once, it has the same state and protection for all of its pages
+        if (proc.read(first, last - first, bytes + (first - begin)) == last - first)
+        {
+            memset(readable + (first - begin), 1, last - first);
+            continue;
+        }
+
+        // the region has changed since it has been queried, its pages are read one by one
+        for (memory::address_t page = first; page < last;)
+        {
+            const memory::address_t next = std::min(last, (page & ~(page_size - 1)) + page_size);
+            if (proc.read(page, next - page, bytes + (page - begin)) == next - page)
+                memset(readable + (page - begin), 1, next - page);
+            page = next;
+        }
+    }
+}
+
+void scroll(memory::MemorySource& proc, RegionMap& map, memory::address_t begin, Viewport& view)
+{
+    // the overlapping part of the previous fetch is moved, only the new lines are read
+    if (begin > view.begin && begin - view.begin < view.size)
+    {
+        const size_t shift = begin - view.begin;
+        memmove(view.bytes.data(), view.bytes.data() + shift, view.size - shift);
+        memmove(view.readable.data(), view.readable.data() + shift, view.size - shift);
+        update_regions(proc, begin, view.size, map);
+        fetch(proc, map, begin + view.size - shift, shift, view.bytes.data() + view.size - shift, view.readable.data() + view.size - shift);
+    }
+    else if (begin < view.begin && view.begin - begin < view.size)
+    {
+        const size_t shift = view.begin - begin;
+        memmove(view.bytes.data() + shift, view.bytes.data(), view.size - shift);
+        memmove(view.readable.data() + shift, view.readable.data(), view.size - shift);
+        update_regions(proc, begin, view.size, map);
+        fetch(proc, map, begin, shift, view.bytes.data(), view.readable.data());
+    }
+    else
+    {
+        update_regions(proc, begin, view.size, map);
+        fetch(proc, map, begin, view.size, view.bytes.data(), view.readable.data());
+    }
+    view.begin = begin;
+}
+
+void show(const Viewport& view, uint32_t width, memory::HexDump& dump, memory::Screen& screen, std::vector<std::string>& lines)
+{
+    // build hex dump table
+    dump.front();
+    for (uint32_t i = 0; i < dump.line_count(); i++)
+    {
+        const size_t offset = static_cast<size_t>(i) * width;
+        dump.set(view.begin + offset, view.bytes.data() + offset);
+
+        // mark the unreadable bytes of the line
+        for (uint32_t b = 0; b < width;)
+        {
+            if (view.readable[offset + b])
+            {
+                b++;
+                continue;
+            }
+            uint32_t n = 1;
+            while (b + n < width && !view.readable[offset + b + n])
+                n++;
+            dump.set_unreadable(b, n);
+            b += n;
+        }
+        dump.inc();
+    }
+
+    // print table
+    dump.render(lines);
+    screen.set_lines(lines);
+    screen.present();
+}
+
 void key_thread_func(const std::atomic_bool* running, std::atomic<memory::address_t>* begin, uint32_t width)
 {
     using namespace std::chrono;
@@ -10,27 +10,27 @@
 */
 
 #define _CRT_SECURE_NO_WARNINGS
-#define ELEMENT_FILE_PATH   "live_memory/elements.dat"
 #define MAX_BUFFER_SIZE     2048
 
 #include "../src/memory/memory.h"
 #include <inttypes.h>
 #include <thread>
 
-// syntax: live_memory <begin entry> <end entry> <update speed [ms]>
+// syntax: live_memory <begin entry> <amount> <update speed [ms]> <shared memory name> <highlight changes (0 or 1)>
 int main(const int argc, const char* const * const argv)
 {
     using namespace std::chrono;
 
     // check for corrent arguments
-    if (argc != 4) return -1;
+    if (argc != 6) return -1;
 
     // convert parameters
-    uint32_t update_speed, begin_entry, end_entry, amount;
+    uint32_t update_speed, begin_entry, end_entry, amount, highlight;
 
     sscanf(argv[1], "%" PRIu32, &begin_entry);
     sscanf(argv[2], "%" PRIu32, &amount);
     sscanf(argv[3], "%" PRIu32, &update_speed);
+    sscanf(argv[5], "%" PRIu32, &highlight);
     end_entry = begin_entry + amount;
 
     // initialize table
@@ -42,13 +42,21 @@ int main(const int argc, const char* const * const argv)
     table.add_column("Decimal");
     table.add_column("Hexadecimal");
 
-    // read elements from file
-    std::vector<memory::Buffer::Element> elements;
-    if (!memory::utility::read_addresses_from_file(ELEMENT_FILE_PATH, elements))
+    // attach to the addresses of the memory application, no elements are copied at this point
+    memory::SharedResults results;
+    if (!results.open(argv[4]))
         return -2;
 
+    // only the changed characters are written, changed values stay highlighted for about one second
+    memory::Screen screen;
+    memory::Screen::enable_virtual_terminal();
+    if (highlight != 0)
+        screen.set_highlight((update_speed > 0 && update_speed < 1000) ? 1000 / update_speed : 1);
+
     time_point<high_resolution_clock> tp;
-    std::vector<std::string> entry(table.col_count());
+    std::vector<std::string> entry(table.col_count()), lines;
+    std::vector<memory::Buffer::Element> elements;
+    uint64_t total, generation = 0;
     memory::Process cur_p;
     uint8_t buff[MAX_BUFFER_SIZE];
 
@@ -59,8 +67,13 @@ int main(const int argc, const char* const * const argv)
         tp = high_resolution_clock::now() + milliseconds(update_speed);
         table.clear_entries();
 
+        // only the shown elements are copied, they are copied again if the application has changed them
+        results.follow();
+        if (results.generation() != generation)
+            generation = results.read(begin_entry, end_entry - begin_entry, elements, total);
+
         // iterate through every element
-        for (uint32_t i = begin_entry; i < end_entry && i < elements.size(); i++)
+        for (uint32_t i = 0; i < elements.size(); i++)
         {
             const memory::Buffer::Element& e = elements[i];
 
@@ -89,8 +102,9 @@ int main(const int argc, const char* const * const argv)
             table.add(entry);
         }
 
-        SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), { 0, 0 });
-        table.print();
+        table.render(lines);
+        screen.set_lines(lines);
+        screen.present();
         std::this_thread::sleep_until(tp);
     }
 
@@ -1,4 +1,4 @@
-g/**
+/**
 * @file     main.cpp
 * @brief    Main function of memory application.
 * @author   Michael Reim / Github: R-Michi
@@ -10,24 +10,123 @@ g/**
 */
 
 #include "src/application/app.h"
+#include "src/application/app_msg.h"
+#include "src/application/script.h"
+#include "src/application/server.h"
+#include <fstream>
 #include <iostream>
 
-int main()
+/*
+* Syntax: memory.exe [-s <script file>] [-m] [-d <name>=<value>]...
+*         memory.exe --serve <name>
+*
+* Without a script file the commands are read from the console. If the standard input is redirected
+* (e.g. "type commands.txt | memory.exe"), it is run as script. In server mode clients connect to the
+* named pipe "\\.\pipe\<name>".
+*/
+struct Arguments
 {
+    std::string script;
+    std::string serve;
+    bool machine;
+    std::vector<std::pair<std::string, std::string>> variables;
+};
+
+bool parse_arguments(const int argc, const char* const * const argv, Arguments& args);
+
+int main(const int argc, const char* const * const argv)
+{
+    Arguments args = { "", "", false, {} };
+    if (!parse_arguments(argc, argv, args) || (!args.serve.empty() && (!args.script.empty() || args.machine || !args.variables.empty())))
+    {
+        std::cerr << memory::app::msg_script_usage() << std::endl;
+        return memory::app::MEMORY_SCRIPT_ERROR;
+    }
+
+    // commands are only read interactively from a console
+    if (args.serve.empty() && args.script.empty() && GetFileType(GetStdHandle(STD_INPUT_HANDLE)) != FILE_TYPE_CHAR)
+        args.script = "-";
+
     try
     {
-        memory::app::Application app;
-        memory::Command cmd;
-        bool running = true;
-        while (running)
+        if (!args.serve.empty())
+        {
+            memory::app::Server server;
+            std::cout << memory::app::msg_server_start(args.serve) << std::endl;
+            if (server.run(args.serve)) return 0;
+            std::cerr << memory::app::msg_server_failure(args.serve) << std::endl;
+            return memory::app::MEMORY_SCRIPT_ERROR;
+        }
+
+        if (args.script.empty())
+        {
+            // the prompt stays usable while a scan or update is running
+            memory::app::Application app;
+            app.set_background(true);
+            memory::Command cmd;
+            bool running = true;
+            while (running)
+            {
+                app.get_command(cmd);
+                running = app.on_command(cmd);
+            }
+            return 0;
+        }
+
+        std::ifstream file;
+        if (args.script != "-")
         {
-            app.get_command(cmd);
-            running = app.on_command(cmd);
+            file.open(args.script);
+            if (!file)
+            {
+                std::cerr << memory::app::msg_script_file_failure(args.script) << std::endl;
+                return memory::app::MEMORY_SCRIPT_ERROR;
+            }
         }
+
+        // in machine mode the standard output only contains the results of the commands
+        std::ostream status(std::cout.rdbuf());
+        if (args.machine)
+            std::cout.rdbuf(std::cerr.rdbuf());
+
+        memory::app::script_exit_t code;
+        {
+            memory::app::Application app;
+            memory::app::Script script(app, args.machine ? &status : nullptr);
+            for (const auto& var : args.variables)
+                script.define(var.first, var.second);
+            code = script.run((args.script == "-") ? std::cin : file);
+        }
+        std::cout.rdbuf(status.rdbuf());
+        return code;
     }
     catch (std::exception& e)
     {
         std::cout << "Error occured: " << e.what() << std::endl;
     }
-    return 0;
+    return memory::app::MEMORY_SCRIPT_ERROR;
+}
+
+bool parse_arguments(const int argc, const char* const * const argv, Arguments& args)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-m" || arg == "--machine")
+            args.machine = true;
+        else if ((arg == "-s" || arg == "--script") && i + 1 < argc)
+            args.script = argv[++i];
+        else if (arg == "--serve" && i + 1 < argc)
+            args.serve = argv[++i];
+        else if ((arg == "-d" || arg == "--define") && i + 1 < argc)
+        {
+            const std::string def = argv[++i];
+            const size_t eq = def.find('=');
+            if (eq == std::string::npos || eq == 0) return false;
+            args.variables.emplace_back(def.substr(0, eq), def.substr(eq + 1));
+        }
+        else
+            return false;
+    }
+    return true;
 }
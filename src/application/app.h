@@ -13,6 +13,11 @@
 
 #include "../memory/memory.h"
 #include "config.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
 
 namespace memory
 {
@@ -21,18 +26,54 @@ namespace memory
         class Application : public CommandEngineBase
         {
         private:
-            constexpr static char LIVE_MEMORY_FILE_PATH[]       = "live_memory/elements.dat";
+            constexpr static char LIVE_MEMORY_SEGMENT_NAME[]    = "Local\\memory_results_";    // followed by the PID of the application
             constexpr static char LIVE_MEMORY_PROCESS_PATH[]    = "live_memory/LiveMemory.exe";
             constexpr static char LIVE_MEMORY_PROCESS_NAME[]    = "LiveMemory.exe";
             constexpr static char DUMP_PROCESS_PATH[]           = "hexdump/HexDump.exe";
             constexpr static char DUMP_PROCESS_NAME[]           = "HexDump.exe";
 
             Config cfg;
-            Table search_table, process_table;
+            Table search_table, process_table, watch_table;
             Buffer search_buffer, undo_buffer, redo_buffer;
             Process current_process;
             ProcessHandler process_handler;
+            SharedResults shared_results;
+            uint64_t published_generation;          // generation of the search buffer that is in the shared segment
+            Watch watch;
+            Recorder recorder;
+            std::unique_ptr<MappedSource> source;   // snapshot or core dump that is read instead of the process while it is open
+            std::string source_path;
             pid_t pid_live_memory, pid_dump, pid_this;
+            bool command_failed;
+            bool background;
+
+            // scan or update that runs on a worker thread and writes into the search buffer
+            struct Job
+            {
+                std::thread thread;
+                std::atomic_bool cancel, finished;
+                ScanProgress progress;
+                std::string command;
+                std::chrono::high_resolution_clock::time_point start, end;
+                scan_status_t status;
+                uint32_t skipped;           // processes that could not be opened
+                bool search;                // 'true' for a scan, 'false' for an update
+                bool active;                // the thread has not been joined yet
+                Stats::Snapshot stats;      // counters of the worker thread, valid when finished
+                std::function<void(void)> report;   // prints the result of the job after it has been joined, may be empty
+            } job;
+
+            // statistics of the last finished scan or update
+            struct LastStats
+            {
+                Stats::Snapshot stats;
+                std::string command;
+                uint64_t time_ns;
+                bool valid;
+                std::ofstream log;          // every finished job appends one JSON line if it is open
+            } last_stats;
+            std::string trace_path;         // trace events are written to this file after every command, if not empty
+            uint64_t trace_begin;           // begin of the command or of the command that started the job, older events are not written
 
             // utility functions
             /**
@@ -58,6 +99,18 @@ namespace memory
             */
             static bool is_input_hex(const std::string& inp);
 
+            /**
+            * @brief Converts an argument of a command into a value of the set data-type and prints
+            *   a message if the argument could not be converted.
+            * @param[in] cmd: command of the argument
+            * @param[in] arg: index of the argument
+            * @param[in] size: size of the value
+            * @param[in] hex: is the argument a hexadecimal number
+            * @param[out] buff: bytes of the value
+            * @return 'true' if the argument has been converted.
+            */
+            bool convert_argument(const Command& cmd, uint32_t arg, size_t size, bool hex, uint8_t* buff);
+
             /**
             * @brief Adds time prefix to message.
             * @param[in] msg: message to print
@@ -65,6 +118,13 @@ namespace memory
             */
             static std::string make_msg(std::string msg);
 
+            /**
+            * @brief Adds time prefix to an error message and marks the current command as failed.
+            * @param[in] msg: message to print
+            * @return message to print with time prefix
+            */
+            std::string make_error(std::string msg);
+
             /**
             * @brief Makes an entry for search table.
             * @param[in] element: buffer element
@@ -79,46 +139,123 @@ namespace memory
             */
             static void make_process_entry(const Process& p, std::vector<std::string>& entry);
 
+            /**
+            * @brief Makes an entry for the watch table.
+            * @param[in] s: statistics of a watched address
+            * @param[out] entry: final entry, ready to be added to the table
+            */
+            static void make_watch_entry(const Watch::Statistics& s, std::vector<std::string>& entry);
+
             /** @brief Makes an backup for the search buffer. */
             void make_backup(void);
 
             /**
-            * @brief Checks if the reference-value is between two values.
-            * @param[in] a: lower limit
-            * @param[in] b: upper limit
-            * @param[in] ref: reference-value
-            * @return 'true' if the check was successful
+            * @brief Starts a scan or an update on the worker thread.
+            * @param[in] command: name of the command that started the job
+            * @param[in] search: 'true' for a scan, 'false' for an update
+            * @param[in] fn: function of the job, returns the status of the job
             */
-            bool is_between(uint8_t* a, uint8_t* b, uint8_t* ref);
+            template<typename Fn>
+            void start_job(const std::string& command, bool search, Fn fn);
+
+            /** @brief Joins the finished job and prints its result. */
+            void finish_job(void);
 
             /**
-            * @brief Scans memory of a process.
-            * @param[in] proc: process to scan
+            * @brief Waits until the job has finished.
+            * @param[in] show_progress: prints the progress while waiting
+            */
+            void wait_job(bool show_progress);
+
+            /** @brief Prints the statistics of the last finished job. */
+            void print_stats(void) const;
+
+            /** @return Statistics of the last finished job as JSON object. */
+            std::string stats_json(void) const;
+
+            /** @brief Writes and clears the recorded trace events, if there are any and no job is running. */
+            void export_trace(void);
+
+            /** @return Progress of the running job as message. */
+            std::string job_status(void) const;
+
+            /**
+            * @brief Starts a job that scans the memory of processes into the search buffer.
+            *   The own process and processes that can not be opened are skipped.
+            * @param[in] command: name of the command
+            * @param[in] processes: processes to scan
             * @param[in] a: lower limit of the value-range to search for
             * @param[in] b: upper limit of the value-range to search for
             * @param[in] size: size of the value or string
-            * @param[out] limit: indicator if the buffer ran out of memory while scanning
-            * @return number of found matches
             */
-            uint64_t scan(Process& proc, uint8_t* a, uint8_t* b, size_t size, bool& limit);
+            void scan(const std::string& command, std::vector<Process>&& processes, const uint8_t* a, const uint8_t* b, size_t size);
 
             /**
-            * @brief Updates all stored values.
+            * @brief Starts a job that scans the open snapshot or core dump into the search buffer.
+            * @param[in] command: name of the command
+            * @param[in] a: lower limit of the value-range to search for
+            * @param[in] b: upper limit of the value-range to search for
+            * @param[in] size: size of the value or string
+            */
+            void scan_source(const std::string& command, const uint8_t* a, const uint8_t* b, size_t size);
+
+            /**
+            * @brief Starts a job that compares two snapshots or core dumps and stores the changed values into
+            *   the search buffer. The runs of changed bytes are printed when the job has finished.
+            * @param[in] command: name of the command
+            * @param[in] old_source: older snapshot or core dump
+            * @param[in] new_source: newer snapshot or core dump
+            * @param[in] op: how the values must have changed
+            * @param[in] value: the values must have changed by exactly this value, may be nullptr
+            */
+            void diff(const std::string& command, std::unique_ptr<MappedSource>&& old_source, std::unique_ptr<MappedSource>&& new_source,
+                      diff_t op, const uint8_t* value);
+
+            /**
+            * @brief Starts a job that updates all values of the undo buffer into the search buffer.
+            *   While a snapshot or core dump is open, the values are read from it instead of the processes.
+            * @param[in] command: name of the command
             * @param[in] a: lower limit of the value-range to search for
             * @param[in] b: upper limit of the value-range to search for
             * @param[in] size: size of the value or string
-            * @return number of updated values
             * NOTE: If a or b is 'nullptr', all values will only be re-read.
             */
-            uint64_t update(uint8_t* a, uint8_t* b, size_t size);
+            void update(const std::string& command, const uint8_t* a, const uint8_t* b, size_t size);
 
             /**
             * @brief Writes to all stored addresses.
+            *   The addresses are grouped by process and every process is written with one batch.
+            * @param[in] x: value to write
+            * @param[in] size: size of the value or string
+            * @param[out] batches: statistics of every batch
+            * @return number of written values
+            */
+            uint64_t write(const uint8_t* x, size_t size, std::vector<IoBatch::Result>& batches);
+
+            /**
+            * @brief Writes a value to every aligned address of a range of the current process.
+            * @param[in] start: first address to write to
+            * @param[in] end: last address to write to
             * @param[in] x: value to write
             * @param[in] size: size of the value or string
+            * @param[out] result: statistics of the batch
             * @return number of written values
             */
-            uint64_t write(uint8_t* x, size_t size);
+            uint64_t write_range(address_t start, address_t end, const uint8_t* x, size_t size, IoBatch::Result& result);
+
+            /**
+            * @brief Transforms all stored values of the set type (read-modify-write).
+            *   The addresses are grouped by process and every process is read and written with one batch.
+            *   The stored values are replaced by the written values.
+            * @param[in] op: transformation to apply
+            * @param[in] a: first operand
+            * @param[in] b: second operand, may be nullptr if not required
+            * @param[in] saturate: saturating arithmetic for integral types
+            * @param[out] reads: statistics of every read batch
+            * @param[out] writes: statistics of every write batch
+            * @return number of transformed values
+            */
+            uint64_t transform(transform_t op, const uint8_t* a, const uint8_t* b, bool saturate, std::vector<IoBatch::Result>& reads, std::vector<IoBatch::Result>& writes);
 
             // commands in separate functions
             void cmd_help(const Command& cmd);
@@ -135,6 +272,7 @@ namespace memory
             void cmd_write_all(const Command& cmd);
             void cmd_write_single(const Command& cmd);
             void cmd_write_range(const Command& cmd);
+            void cmd_transform(const Command& cmd);
             void cmd_update(const Command& cmd);
             void cmd_update_exact(const Command& cmd);
             void cmd_update_range(const Command& cmd);
@@ -142,12 +280,34 @@ namespace memory
             void cmd_redo(const Command& cmd);
             void cmd_show(const Command& cmd);
             void cmd_show_live(const Command& cmd);
+            void cmd_watch(const Command& cmd);
+            void cmd_record(const Command& cmd);
             void cmd_dump(const Command& cmd);
             void cmd_save(const Command& cmd);
+            void cmd_load(const Command& cmd);
+            void cmd_status(const Command& cmd);
+            void cmd_cancel(const Command& cmd);
+            void cmd_wait(const Command& cmd);
+            void cmd_stats(const Command& cmd);
+            void cmd_trace(const Command& cmd);
+            void cmd_snapshot(const Command& cmd);
+            void cmd_diff(const Command& cmd);
         public:
             Application(void);
             virtual ~Application(void);
             virtual bool on_command(const Command& cmd);
+
+            /**
+            * @brief Scans and updates run in the background if enabled, otherwise every command waits for them.
+            * @param[in] enable: run scans and updates in the background
+            */
+            void set_background(bool enable) noexcept { this->background = enable; }
+
+            /** @return 'true' if the last command has failed. */
+            bool failed(void) const noexcept { return this->command_failed; }
+
+            /** @return Number of currently stored addresses. */
+            size_t result_count(void) const noexcept { return this->search_buffer.table().size(); }
         };
     }
 }
\ No newline at end of file
@@ -20,6 +20,8 @@
 #include <cmath>
 #include <algorithm>
 #include <fstream>
+#include <iomanip>
+#include <ctime>
 
 using namespace memory::app;
 
@@ -29,7 +31,7 @@ void Application::cmd_help(const Command& cmd)
     // syntax check
     if (cmd.args().size() > 1)
     {
-        std::cout << make_msg(msg_help_syntax()) << std::endl;
+        std::cout << this->make_error(msg_help_syntax()) << std::endl;
         return;
     }
 
@@ -38,7 +40,7 @@ void Application::cmd_help(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -63,6 +65,7 @@ void Application::cmd_help(const Command& cmd)
         else if (cmd.args().at(0) == "write_all"    || cmd.args().at(0) == "wa")    { std::cout << msg_help_wa()            << std::endl; }
         else if (cmd.args().at(0) == "write_single" || cmd.args().at(0) == "ws")    { std::cout << msg_help_ws()            << std::endl; }
         else if (cmd.args().at(0) == "write_range"  || cmd.args().at(0) == "wr")    { std::cout << msg_help_wr()            << std::endl; }
+        else if (cmd.args().at(0) == "transform")                                   { std::cout << msg_help_transform()     << std::endl; }
         else if (cmd.args().at(0) == "update")                                      { std::cout << msg_help_update()        << std::endl; }
         else if (cmd.args().at(0) == "update_exact" || cmd.args().at(0) == "ue")    { std::cout << msg_help_update_exact()  << std::endl; }
         else if (cmd.args().at(0) == "update_range" || cmd.args().at(0) == "ur")    { std::cout << msg_help_update_range()  << std::endl; }
@@ -70,9 +73,19 @@ void Application::cmd_help(const Command& cmd)
         else if (cmd.args().at(0) == "redo")                                        { std::cout << msg_help_redo()          << std::endl; }
         else if (cmd.args().at(0) == "show")                                        { std::cout << msg_help_show()          << std::endl; }
         else if (cmd.args().at(0) == "show_live"    || cmd.args().at(0) == "sl")    { std::cout << msg_help_sl()            << std::endl; }
+        else if (cmd.args().at(0) == "watch")                                       { std::cout << msg_help_watch()         << std::endl; }
+        else if (cmd.args().at(0) == "record")                                      { std::cout << msg_help_record()        << std::endl; }
         else if (cmd.args().at(0) == "dump")                                        { std::cout << msg_help_dump()          << std::endl; }
         else if (cmd.args().at(0) == "save")                                        { std::cout << msg_help_save()          << std::endl;}
-        else                                                                        { std::cout << make_msg(msg_help_invalid(cmd.args().at(0))) << std::endl; }
+        else if (cmd.args().at(0) == "load")                                        { std::cout << msg_help_load()          << std::endl;}
+        else if (cmd.args().at(0) == "status")                                      { std::cout << msg_help_status()        << std::endl; }
+        else if (cmd.args().at(0) == "cancel")                                      { std::cout << msg_help_cancel()        << std::endl; }
+        else if (cmd.args().at(0) == "wait")                                        { std::cout << msg_help_wait()          << std::endl; }
+        else if (cmd.args().at(0) == "stats")                                       { std::cout << msg_help_stats()         << std::endl; }
+        else if (cmd.args().at(0) == "trace")                                       { std::cout << msg_help_trace()         << std::endl; }
+        else if (cmd.args().at(0) == "snapshot")                                    { std::cout << msg_help_snapshot()      << std::endl; }
+        else if (cmd.args().at(0) == "diff")                                        { std::cout << msg_help_diff()          << std::endl; }
+        else                                                                        { std::cout << this->make_error(msg_help_invalid(cmd.args().at(0))) << std::endl; }
     }
 }
 
@@ -81,7 +94,7 @@ void Application::cmd_config(const Command& cmd)
     // syntax check
     if (cmd.args().size() > 2)
     {
-        std::cout << make_msg(msg_config_syntax()) << std::endl;
+        std::cout << this->make_error(msg_config_syntax()) << std::endl;
         return;
     }
 
@@ -91,7 +104,7 @@ void Application::cmd_config(const Command& cmd)
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -136,7 +149,7 @@ void Application::cmd_config(const Command& cmd)
                 else if (cmd.args().at(1) == "string")  new_type = MEMORY_TYPE_STRING;
                 else
                 {
-                    std::cout << make_msg(msg_unknown_type(cmd.args().at(1))) << std::endl;
+                    std::cout << this->make_error(msg_unknown_type(cmd.args().at(1))) << std::endl;
                     return;
                 }
                 this->cfg.set_type(new_type);
@@ -157,7 +170,7 @@ void Application::cmd_config(const Command& cmd)
                 uint16_t old_align = this->cfg.alignment(), new_align;
                 if (!utility::is_dec(cmd.args().at(1)))
                 {
-                    std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                    std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
                     return;
                 }
                 sscanf(cmd.args().at(1).c_str(), "%" PRIu16, &new_align);
@@ -165,7 +178,7 @@ void Application::cmd_config(const Command& cmd)
                 float x = log2f(static_cast<float>(new_align));
                 if ((x - std::floor(x)) > 0.0f)
                 {
-                    std::cout << make_msg(msg_config_alignment_power2()) << std::endl;
+                    std::cout << this->make_error(msg_config_alignment_power2()) << std::endl;
                     return;
                 }
 
@@ -187,7 +200,7 @@ void Application::cmd_config(const Command& cmd)
                 address_t old_sa = this->cfg.start_address(), new_sa;
                 if (!utility::is_hex(cmd.args().at(1)))
                 {
-                    std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                    std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
                     return;
                 }
                 sscanf(cmd.args().at(1).c_str(), "%" PRIX64, &new_sa);
@@ -210,7 +223,7 @@ void Application::cmd_config(const Command& cmd)
                 address_t old_ea = this->cfg.end_address(), new_ea;
                 if (!utility::is_hex(cmd.args().at(1)))
                 {
-                    std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                    std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
                     return;
                 }
                 sscanf(cmd.args().at(1).c_str(), "%" PRIX64, &new_ea);
@@ -233,7 +246,7 @@ void Application::cmd_config(const Command& cmd)
                 size_t old_sss = this->cfg.search_split_size(), new_sss;
                 if (!utility::is_dec(cmd.args().at(1)))
                 {
-                    std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                    std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
                     return;
                 }
                 sscanf(cmd.args().at(1).c_str(), "%zu", &new_sss);
@@ -265,7 +278,7 @@ void Application::cmd_config(const Command& cmd)
                 size_t old_sls = this->cfg.search_limit_size(), new_sls;
                 if (!utility::is_dec(cmd.args().at(1)))
                 {
-                    std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                    std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
                     return;
                 }
                 sscanf(cmd.args().at(1).c_str(), "%zu", &new_sls);
@@ -286,13 +299,18 @@ void Application::cmd_config(const Command& cmd)
         }
         else
         {
-            std::cout << make_msg(msg_unknown_argument(cmd.name(), cmd.args().at(0), 1)) << std::endl;
+            std::cout << this->make_error(msg_unknown_argument(cmd.name(), cmd.args().at(0), 1)) << std::endl;
             return;
         }
     }
     // save config if anything has changed
     if (reset || arg_size_2)
-        std::cout << make_msg(this->cfg.save() ? msg_config_save_success() : msg_config_save_failure()) << std::endl;
+    {
+        if (this->cfg.save())
+            std::cout << make_msg(msg_config_save_success()) << std::endl;
+        else
+            std::cout << this->make_error(msg_config_save_failure()) << std::endl;
+    }
 }
 
 void Application::cmd_list(const Command& cmd)
@@ -300,7 +318,7 @@ void Application::cmd_list(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_list_syntax()) << std::endl;
+        std::cout << this->make_error(msg_list_syntax()) << std::endl;
         return;
     }
 
@@ -310,7 +328,7 @@ void Application::cmd_list(const Command& cmd)
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -338,7 +356,7 @@ void Application::cmd_info(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_info_syntax()) << std::endl;
+        std::cout << this->make_error(msg_info_syntax()) << std::endl;
         return;
     }
 
@@ -347,7 +365,7 @@ void Application::cmd_info(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -427,7 +445,7 @@ void Application::cmd_open(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 1)
     {
-        std::cout << make_msg(msg_open_syntax()) << std::endl;
+        std::cout << this->make_error(msg_open_syntax()) << std::endl;
         return;
     }
 
@@ -437,7 +455,7 @@ void Application::cmd_open(const Command& cmd)
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -448,7 +466,7 @@ void Application::cmd_open(const Command& cmd)
         // pid must be a decimal number
         if (!memory::utility::is_dec(cmd.args().at(0)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
             return;
         }
         pid_t pid;
@@ -457,7 +475,7 @@ void Application::cmd_open(const Command& cmd)
         // find process ID
         if (!Process::find_process(pid, this->current_process))
         {
-            std::cout << make_msg(msg_open_find_pid_failure(pid)) << std::endl;
+            std::cout << this->make_error(msg_open_find_pid_failure(pid)) << std::endl;
             return;
         }
         std::cout << make_msg(msg_open_find_pid_success(pid)) << std::endl;
@@ -468,7 +486,7 @@ void Application::cmd_open(const Command& cmd)
         // find window and get process ID from window
         if (!Process::find_process(cmd.args().at(0), this->current_process))
         {
-            std::cout << make_msg(msg_open_find_window_failure(cmd.args().at(0))) << std::endl;
+            std::cout << this->make_error(msg_open_find_window_failure(cmd.args().at(0))) << std::endl;
             return;
         }
         std::cout << make_msg(msg_open_find_window_success(cmd.args().at(0))) << std::endl;
@@ -484,7 +502,7 @@ void Application::cmd_open(const Command& cmd)
     // open new process
     if (!this->current_process.open())
     {
-        std::cout << make_msg(msg_open_failure(this->current_process.pid())) << std::endl;
+        std::cout << this->make_error(msg_open_failure(this->current_process.pid())) << std::endl;
         return;
     }
     std::cout << make_msg(msg_open_success(this->current_process.pid())) << std::endl;
@@ -495,17 +513,17 @@ void Application::cmd_close(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_close_syntax()) << std::endl;
+        std::cout << this->make_error(msg_close_syntax()) << std::endl;
         return;
     }
 
     // check for invalid options
-    const std::vector<std::string> all_options = { "p", "-process", "l", "-live", "d", "-dump" };
+    const std::vector<std::string> all_options = { "p", "-process", "l", "-live", "d", "-dump", "w", "-watch", "r", "-record" };
     std::vector<std::string> unknown_options;
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -518,7 +536,7 @@ void Application::cmd_close(const Command& cmd)
             std::cout << make_msg(msg_close_process(this->current_process.pid())) << std::endl;
         }
         else if (cmd.options().size() > 0)
-            std::cout << make_msg(msg_close_process_failure()) << std::endl;
+            std::cout << this->make_error(msg_close_process_failure()) << std::endl;
     }
 
     // close live memory
@@ -531,7 +549,7 @@ void Application::cmd_close(const Command& cmd)
             this->pid_live_memory = MEMORY_PID_INVALID;
         }
         else if (cmd.options().size() > 0)
-            std::cout << make_msg(msg_close_live_memory_failure()) << std::endl;
+            std::cout << this->make_error(msg_close_live_memory_failure()) << std::endl;
     }
 
     // close memory dump
@@ -544,7 +562,31 @@ void Application::cmd_close(const Command& cmd)
             this->pid_dump = MEMORY_PID_INVALID;
         }
         else if (cmd.options().size() > 0)
-            std::cout << make_msg(msg_close_hex_dump_failure()) << std::endl;
+            std::cout << this->make_error(msg_close_hex_dump_failure()) << std::endl;
+    }
+
+    // stop watch
+    if (cmd.options().size() == 0 || cmd.options().find_any({ "w", "-watch" }, 0) != memory::CmdOpionList::NPOS)
+    {
+        if (this->watch.running())
+        {
+            this->watch.stop();
+            std::cout << make_msg(msg_close_watch()) << std::endl;
+        }
+        else if (cmd.options().size() > 0)
+            std::cout << this->make_error(msg_close_watch_failure()) << std::endl;
+    }
+
+    // stop recording
+    if (cmd.options().size() == 0 || cmd.options().find_any({ "r", "-record" }, 0) != memory::CmdOpionList::NPOS)
+    {
+        if (this->recorder.running())
+        {
+            this->recorder.stop();
+            std::cout << make_msg(msg_close_record()) << std::endl;
+        }
+        else if (cmd.options().size() > 0)
+            std::cout << this->make_error(msg_close_record_failure()) << std::endl;
     }
 }
 
@@ -553,7 +595,7 @@ void Application::cmd_clear(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_clear_syntax()) << std::endl;
+        std::cout << this->make_error(msg_clear_syntax()) << std::endl;
         return;
     }
 
@@ -562,7 +604,7 @@ void Application::cmd_clear(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -574,7 +616,7 @@ void Application::cmd_read_single(const Command& cmd)
     // syntax check
     if ((!utility::is_string(this->cfg.type()) && cmd.args().size() != 1) || (utility::is_string(this->cfg.type()) && cmd.args().size() != 2))
     {
-        std::cout << make_msg(msg_rs_syntax()) << std::endl;
+        std::cout << this->make_error(msg_rs_syntax()) << std::endl;
         return;
     }
 
@@ -583,26 +625,26 @@ void Application::cmd_read_single(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_hex(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (utility::is_string(this->cfg.type()) && !memory::utility::is_dec(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
 
     // check for open process
     if (!this->current_process.is_valid())
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
@@ -625,7 +667,7 @@ void Application::cmd_read_single(const Command& cmd)
     element.data = value;
     if (this->current_process.read(element.address, element.size, value) == 0)
     {
-        std::cout << make_msg(msg_rs_failed(element.address)) << std::endl;
+        std::cout << this->make_error(msg_rs_failed(element.address)) << std::endl;
         return;
     }
 
@@ -652,7 +694,7 @@ void Application::cmd_read_block(const Command& cmd)
     // syntax check
     if ((!utility::is_string(this->cfg.type()) && cmd.args().size() != 2) || (utility::is_string(this->cfg.type()) && cmd.args().size() != 3))
     {
-        std::cout << make_msg(msg_rb_syntax()) << std::endl;
+        std::cout << this->make_error(msg_rb_syntax()) << std::endl;
         return;
     }
 
@@ -661,31 +703,32 @@ void Application::cmd_read_block(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_hex(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_hex(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
     if (utility::is_string(this->cfg.type()) && !utility::is_dec(cmd.args().at(2)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
         return;
     }
 
-    // check for open process
-    if (!this->current_process.is_valid())
+    // check for open process, an open snapshot or core dump is read instead of the process
+    MemorySource* source = (this->source != nullptr) ? static_cast<MemorySource*>(this->source.get()) : &this->current_process;
+    if (!source->is_valid())
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
@@ -701,7 +744,7 @@ void Application::cmd_read_block(const Command& cmd)
     // range must not be smaller than type-size
     if (range < size)
     {
-        std::cout << make_msg(msg_read_minimum(size)) << std::endl;
+        std::cout << this->make_error(msg_read_minimum(size)) << std::endl;
         return;
     }
 
@@ -719,9 +762,9 @@ void Application::cmd_read_block(const Command& cmd)
     time_point<high_resolution_clock> t0 = high_resolution_clock::now();
     for (address_t a = start; a <= end; a += this->cfg.alignment())
     {
-        if (this->current_process.read(a, size, value) > 0)
+        if (source->read(a, size, value) > 0)
         {
-            this->search_buffer.push(this->current_process.pid(), a, size, this->cfg.type(), value);
+            this->search_buffer.push(source->pid(), a, size, this->cfg.type(), value);
             ++count;
         }
     }
@@ -732,12 +775,10 @@ void Application::cmd_read_block(const Command& cmd)
 
 void Application::cmd_search_exact(const Command& cmd)
 {
-    using namespace std::chrono;
-
     // syntax check
     if (cmd.args().size() != 1)
     {
-        std::cout << make_msg(msg_se_syntax()) << std::endl;
+        std::cout << this->make_error(msg_se_syntax()) << std::endl;
         return;
     }
 
@@ -747,7 +788,7 @@ void Application::cmd_search_exact(const Command& cmd)
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -757,36 +798,46 @@ void Application::cmd_search_exact(const Command& cmd)
     {
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(0)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex && !utility::is_dec(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex && !utility::is_hex(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
         }
     }
 
-    // check for open process
+    // check for open process, snapshot or core dump
     bool all = cmd.options().find_any(all_options, 0) != CmdOpionList::NPOS;
-    if (!all && !this->current_process.is_valid())
+    if (!all && !this->current_process.is_valid() && this->source == nullptr)
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
     // convert arguments
     size_t size = (utility::is_string(this->cfg.type())) ? cmd.args().at(0).size() : this->cfg.type_size();
     uint8_t in_value[size];
-    utility::to_bytes(cmd.args().at(0), size, this->cfg.type(), is_hex, in_value);
+    if (!this->convert_argument(cmd, 0, size, is_hex, in_value)) return;
+
+    // scan the open snapshot or core dump instead of the process
+    if (!all && this->source != nullptr)
+    {
+        this->make_backup();
+        this->search_buffer.resize(this->cfg.search_limit_size());
+        std::cout << make_msg(msg_search_source(this->source->format(), this->source_path)) << std::endl;
+        this->scan_source(cmd.name(), in_value, in_value, size);
+        return;
+    }
 
     // get processes
     std::vector<Process> processes;
@@ -797,41 +848,17 @@ void Application::cmd_search_exact(const Command& cmd)
     this->make_backup();
     this->search_buffer.resize(this->cfg.search_limit_size());
 
-    // scan processes
-    uint64_t sum_count = 0, sub_count;
-    bool limit = false;
-    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-
-    // iterate through all processes
-    uint32_t i = 1, n = processes.size();
+    // scan processes in the background
     std::cout << make_msg(msg_search_start(processes.size())) << std::endl;
-    for (auto proc = processes.begin(); proc != processes.end() && !limit; proc++)
-    {
-        std::cout << make_msg(msg_search_sub_start(proc->name(), proc->pid(), i++, n)) << std::endl;
-        // must not scan the own process
-        if (proc->open() && proc->pid() != this->pid_this)
-        {
-            sub_count = this->scan(*proc, in_value, in_value, size, limit);
-            sum_count += sub_count;
-            proc->close();
-            std::cout << make_msg(msg_search_sub_finish(proc->name(), proc->pid(), sub_count)) << std::endl;
-        }
-        else
-            std::cout << make_msg(msg_search_sub_failure(proc->name(), proc->pid())) << std::endl;
-    }
-    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
-    this->search_buffer.shrink_to_fit();
-    std::cout << make_msg(limit ? msg_search_interrupt() : msg_search_finish(sum_count, duration_cast<milliseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+    this->scan(cmd.name(), std::move(processes), in_value, in_value, size);
 }
 
 void Application::cmd_search_range(const Command& cmd)
 {
-    using namespace std::chrono;
-
     // syntax check
     if (cmd.args().size() != 2)
     {
-        std::cout << make_msg(msg_se_syntax()) << std::endl;
+        std::cout << this->make_error(msg_se_syntax()) << std::endl;
         return;
     }
 
@@ -841,14 +868,14 @@ void Application::cmd_search_range(const Command& cmd)
     list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // this command does not work with strings
     if (utility::is_string(this->cfg.type()))
     {
-        std::cout << make_msg(msg_sr_string()) << std::endl;
+        std::cout << this->make_error(msg_sr_string()) << std::endl;
         return;
     }
 
@@ -859,36 +886,46 @@ void Application::cmd_search_range(const Command& cmd)
         is_hex[i] = is_input_hex(cmd.args().at(i));
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(i)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex[i] && !utility::is_dec(cmd.args().at(i)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex[i] && !utility::is_hex(cmd.args().at(i)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
                 return;
             }
         }
     }
 
-    // check for open process
+    // check for open process, snapshot or core dump
     bool all = cmd.options().find_any(all_options, 0) != CmdOpionList::NPOS;
-    if (!all && !this->current_process.is_valid())
+    if (!all && !this->current_process.is_valid() && this->source == nullptr)
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
     // convert arguments
     uint8_t in_value1[this->cfg.type_size()], in_value2[this->cfg.type_size()];
-    utility::to_bytes(cmd.args().at(0), this->cfg.type_size(), this->cfg.type(), is_hex[0], in_value1);
-    utility::to_bytes(cmd.args().at(1), this->cfg.type_size(), this->cfg.type(), is_hex[1], in_value2);
+    if (!this->convert_argument(cmd, 0, this->cfg.type_size(), is_hex[0], in_value1)) return;
+    if (!this->convert_argument(cmd, 1, this->cfg.type_size(), is_hex[1], in_value2)) return;
+
+    // scan the open snapshot or core dump instead of the process
+    if (!all && this->source != nullptr)
+    {
+        this->make_backup();
+        this->search_buffer.resize(this->cfg.search_limit_size());
+        std::cout << make_msg(msg_search_source(this->source->format(), this->source_path)) << std::endl;
+        this->scan_source(cmd.name(), in_value1, in_value2, this->cfg.type_size());
+        return;
+    }
 
     // get processes
     std::vector<Process> processes;
@@ -899,31 +936,9 @@ void Application::cmd_search_range(const Command& cmd)
     this->make_backup();
     this->search_buffer.resize(this->cfg.search_limit_size());
 
-    // scan processes
-    uint64_t sum_count = 0, sub_count;
-    bool limit = false;
-    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-
-    // iterate through all processes
-    uint32_t i = 1, n = processes.size();
+    // scan processes in the background
     std::cout << make_msg(msg_search_start(processes.size())) << std::endl;
-    for (auto proc = processes.begin(); proc != processes.end() && !limit; proc++)
-    {
-        std::cout << make_msg(msg_search_sub_start(proc->name(), proc->pid(), i++, n)) << std::endl;
-        // must not scan the own process
-        if (proc->open() && proc->pid() != this->pid_this)
-        {
-            sub_count = this->scan(*proc, in_value1, in_value2, this->cfg.type_size(), limit);
-            sum_count += sub_count;
-            proc->close();
-            std::cout << make_msg(msg_search_sub_finish(proc->name(), proc->pid(), sub_count)) << std::endl;
-        }
-        else
-            std::cout << make_msg(msg_search_sub_failure(proc->name(), proc->pid())) << std::endl;
-    }
-    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
-    this->search_buffer.shrink_to_fit();
-    std::cout << make_msg(limit ? msg_search_interrupt() : msg_search_finish(sum_count, duration_cast<milliseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+    this->scan(cmd.name(), std::move(processes), in_value1, in_value2, this->cfg.type_size());
 }
 
 void Application::cmd_write_all(const Command& cmd)
@@ -933,7 +948,7 @@ void Application::cmd_write_all(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 1)
     {
-        std::cout << make_msg(msg_wa_syntax()) << std::endl;
+        std::cout << this->make_error(msg_wa_syntax()) << std::endl;
         return;
     }
 
@@ -942,7 +957,7 @@ void Application::cmd_write_all(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -952,19 +967,19 @@ void Application::cmd_write_all(const Command& cmd)
     {
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(0)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex && !utility::is_dec(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex && !utility::is_hex(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
         }
@@ -973,20 +988,27 @@ void Application::cmd_write_all(const Command& cmd)
     // check for open process
     if (!this->current_process.is_valid())
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
     // convert arguments
     size_t size = (utility::is_string(this->cfg.type())) ? cmd.args().at(0).size() : this->cfg.type_size();
     uint8_t in_value[size];
-    utility::to_bytes(cmd.args().at(0), size, this->cfg.type(), is_hex, in_value);
+    if (!this->convert_argument(cmd, 0, size, is_hex, in_value)) return;
 
     // write memory
     std::cout << make_msg(msg_wa_start()) << std::endl;
+    std::vector<IoBatch::Result> batches;
     time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-    uint64_t count = this->write(in_value, size);
+    uint64_t count = this->write(in_value, size, batches);
     time_point<high_resolution_clock> t1 = high_resolution_clock::now();
+    // a failed value fails the command, so that a script stops with an error
+    for (const IoBatch::Result& r : batches)
+    {
+        const std::string msg = msg_write_batch(r.pid, r.requests, r.failed, r.bytes, r.calls);
+        std::cout << ((r.failed > 0) ? this->make_error(msg) : make_msg(msg)) << std::endl;
+    }
     std::cout << make_msg(msg_write_finish(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
 }
  
@@ -995,7 +1017,7 @@ void Application::cmd_write_single(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 2)
     {
-        std::cout << make_msg(msg_ws_syntax()) << std::endl;
+        std::cout << this->make_error(msg_ws_syntax()) << std::endl;
         return;
     }
 
@@ -1004,7 +1026,7 @@ void Application::cmd_write_single(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1012,26 +1034,26 @@ void Application::cmd_write_single(const Command& cmd)
     bool is_hex = is_input_hex(cmd.args().at(1));
     if (!utility::is_hex(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name()));
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name()));
         return;
     }
     if (!utility::is_string(this->cfg.type()))
     {
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(1)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex && !utility::is_dec(cmd.args().at(1)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex && !utility::is_hex(cmd.args().at(1)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
                 return;
             }
         }
@@ -1040,7 +1062,7 @@ void Application::cmd_write_single(const Command& cmd)
     // check for open process
     if (!this->current_process.is_valid())
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
@@ -1049,11 +1071,11 @@ void Application::cmd_write_single(const Command& cmd)
     sscanf(cmd.args().at(0).c_str(), "%" PRIx64, &addr);
     size_t size = (utility::is_string(this->cfg.type())) ? cmd.args().at(1).size() : this->cfg.type_size();
     uint8_t in_value[size];
-    utility::to_bytes(cmd.args().at(1), size, this->cfg.type(), is_hex, in_value);
+    if (!this->convert_argument(cmd, 1, size, is_hex, in_value)) return;
 
     // write memory
     if (this->current_process.write(addr, size, in_value) == 0)
-        std::cout << make_msg(msg_ws_failure(addr)) << std::endl;
+        std::cout << this->make_error(msg_ws_failure(addr)) << std::endl;
     else
         std::cout << make_msg(msg_ws_success(addr)) << std::endl;
 }
@@ -1065,7 +1087,7 @@ void Application::cmd_write_range(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 3)
     {
-        std::cout << make_msg(msg_wr_syntax()) << std::endl;
+        std::cout << this->make_error(msg_wr_syntax()) << std::endl;
         return;
     }
 
@@ -1074,7 +1096,7 @@ void Application::cmd_write_range(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1082,31 +1104,31 @@ void Application::cmd_write_range(const Command& cmd)
     bool is_hex = is_input_hex(cmd.args().at(2));
     if (!utility::is_hex(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name()));
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name()));
         return;
     }
     if (!utility::is_hex(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name()));
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name()));
         return;
     }
     if (!utility::is_string(this->cfg.type()))
     {
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(2)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex && !utility::is_dec(cmd.args().at(2)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex && !utility::is_hex(cmd.args().at(2)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(2), 3, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(2), 3, cmd.name())) << std::endl;
                 return;
             }
         }
@@ -1115,7 +1137,7 @@ void Application::cmd_write_range(const Command& cmd)
     // check for open process
     if (!this->current_process.is_valid())
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
@@ -1125,12 +1147,12 @@ void Application::cmd_write_range(const Command& cmd)
     sscanf(cmd.args().at(1).c_str(), "%" PRIx64, &range);
     size_t size = (utility::is_string(this->cfg.type())) ? cmd.args().at(2).size() : this->cfg.type_size();
     uint8_t in_value[size];
-    utility::to_bytes(cmd.args().at(2), size, this->cfg.type(), is_hex, in_value);
+    if (!this->convert_argument(cmd, 2, size, is_hex, in_value)) return;
 
     // range must not be smaller than type-size
     if (range < size)
     {
-        std::cout << make_msg(msg_read_minimum(size)) << std::endl;
+        std::cout << this->make_error(msg_read_minimum(size)) << std::endl;
         return;
     }
 
@@ -1139,26 +1161,116 @@ void Application::cmd_write_range(const Command& cmd)
     end = start + ((range % this->cfg.alignment() > 0) ? (range - range % this->cfg.alignment()) : range) - size;
 
     // write memory
-    uint64_t count = 0;
+    IoBatch::Result result;
     std::cout << make_msg(msg_wr_start(start, end + size)) << std::endl;
     time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-    for (address_t a = start; a <= end; a += this->cfg.alignment())
+    uint64_t count = this->write_range(start, end, in_value, size, result);
+    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
+    const std::string msg = msg_write_batch(result.pid, result.requests, result.failed, result.bytes, result.calls);
+    std::cout << ((result.failed > 0) ? this->make_error(msg) : make_msg(msg)) << std::endl;
+    std::cout << make_msg(msg_write_finish(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+}
+
+void Application::cmd_transform(const Command& cmd)
+{
+    using namespace std::chrono;
+
+    // syntax check
+    if (cmd.args().size() < 2 || cmd.args().size() > 3)
     {
-        if (this->current_process.write(a, size, in_value))
-            ++count;
+        std::cout << this->make_error(msg_transform_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "s", "-saturate" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // check for correct arguments
+    transform_t op = to_transform(cmd.args().at(0));
+    if (op == MEMORY_TRANSFORM_INVALID)
+    {
+        std::cout << this->make_error(msg_transform_invalid(cmd.args().at(0))) << std::endl;
+        return;
+    }
+    if (cmd.args().size() != transform_operands(op) + 1)
+    {
+        std::cout << this->make_error(msg_transform_syntax()) << std::endl;
+        return;
+    }
+    if (utility::is_string(this->cfg.type()))
+    {
+        std::cout << this->make_error(msg_transform_string()) << std::endl;
+        return;
+    }
+    for (uint32_t i = 1; i < cmd.args().size(); i++)
+    {
+        bool is_hex = is_input_hex(cmd.args().at(i));
+        if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(i)))
+        {
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+            return;
+        }
+        else if (utility::is_integral(this->cfg.type()))
+        {
+            if (!is_hex && !utility::is_dec(cmd.args().at(i)))
+            {
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                return;
+            }
+            if (is_hex && !utility::is_hex(cmd.args().at(i)))
+            {
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                return;
+            }
+        }
+    }
+
+    // convert arguments
+    bool saturate = (cmd.options().find_any(all_options, 0) != CmdOpionList::NPOS);
+    size_t size = this->cfg.type_size();
+    uint8_t in_a[size], in_b[size];
+    if (!this->convert_argument(cmd, 1, size, is_input_hex(cmd.args().at(1)), in_a)) return;
+    if (cmd.args().size() == 3 && !this->convert_argument(cmd, 2, size, is_input_hex(cmd.args().at(2)), in_b)) return;
+
+    // check if the transformation is supported for the type
+    uint8_t probe[size];
+    memset(probe, 0, size);
+    if (!memory::transform(this->cfg.type(), op, in_a, (cmd.args().size() == 3) ? in_b : nullptr, saturate, probe, 1))
+    {
+        std::cout << this->make_error(msg_transform_unsupported(cmd.args().at(0))) << std::endl;
+        return;
     }
+
+    // transform memory
+    std::cout << make_msg(msg_transform_start()) << std::endl;
+    std::vector<IoBatch::Result> reads, writes;
+    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
+    uint64_t count = this->transform(op, in_a, (cmd.args().size() == 3) ? in_b : nullptr, saturate, reads, writes);
     time_point<high_resolution_clock> t1 = high_resolution_clock::now();
+    for (size_t i = 0; i < reads.size(); i++)
+    {
+        // a value that could not be read or written fails the command
+        const std::string read_msg = msg_transform_read_batch(reads[i].pid, reads[i].requests, reads[i].failed, reads[i].bytes, reads[i].calls);
+        const std::string write_msg = msg_write_batch(writes[i].pid, writes[i].requests, writes[i].failed, writes[i].bytes, writes[i].calls);
+        std::cout << ((reads[i].failed > 0) ? this->make_error(read_msg) : make_msg(read_msg)) << std::endl;
+        std::cout << ((writes[i].failed > 0) ? this->make_error(write_msg) : make_msg(write_msg)) << std::endl;
+    }
     std::cout << make_msg(msg_write_finish(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
 }
 
 void Application::cmd_update(const Command& cmd)
 {
-    using namespace std::chrono;
-
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_update_syntax()) << std::endl;
+        std::cout << this->make_error(msg_update_syntax()) << std::endl;
         return;
     }
 
@@ -1167,7 +1279,7 @@ void Application::cmd_update(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1175,23 +1287,16 @@ void Application::cmd_update(const Command& cmd)
     this->make_backup();
     this->search_buffer.resize(this->undo_buffer.size());
 
-    // update values
-    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-    uint64_t count = this->update(nullptr, nullptr, 0);
-    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
-
-    this->search_buffer.shrink_to_fit();
-    std::cout << make_msg(msg_update_success(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+    // update values in the background
+    this->update(cmd.name(), nullptr, nullptr, 0);
 }
 
 void Application::cmd_update_exact(const Command& cmd)
 {
-    using namespace std::chrono;
-
     // syntax check
     if (cmd.args().size() != 1)
     {
-        std::cout << make_msg(msg_ue_syntax()) << std::endl;
+        std::cout << this->make_error(msg_ue_syntax()) << std::endl;
         return;
     }
 
@@ -1200,7 +1305,7 @@ void Application::cmd_update_exact(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1210,19 +1315,19 @@ void Application::cmd_update_exact(const Command& cmd)
     {
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(0)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex && !utility::is_dec(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex && !utility::is_hex(cmd.args().at(0)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
                 return;
             }
         }
@@ -1231,29 +1336,22 @@ void Application::cmd_update_exact(const Command& cmd)
     // convert arguments
     size_t size = (utility::is_string(this->cfg.type())) ? cmd.args().at(0).size() : this->cfg.type_size();
     uint8_t in_value[size];
-    utility::to_bytes(cmd.args().at(0), size, this->cfg.type(), is_hex, in_value);
+    if (!this->convert_argument(cmd, 0, size, is_hex, in_value)) return;
 
     // backup buffer
     this->make_backup();
     this->search_buffer.resize(this->undo_buffer.size());
 
-    // search for new values in buffer
-    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-    uint64_t count = this->update(in_value, in_value, size);
-    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
-
-    this->search_buffer.shrink_to_fit();
-    std::cout << make_msg(msg_update_success(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+    // search for new values in buffer in the background
+    this->update(cmd.name(), in_value, in_value, size);
 }
 
 void Application::cmd_update_range(const Command& cmd)
 {
-    using namespace std::chrono;
-
     // syntax check
     if (cmd.args().size() != 2)
     {
-        std::cout << make_msg(msg_sr_syntax()) << std::endl;
+        std::cout << this->make_error(msg_sr_syntax()) << std::endl;
         return;
     }
 
@@ -1262,14 +1360,14 @@ void Application::cmd_update_range(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // this command does not work with strings
     if (utility::is_string(this->cfg.type()))
     {
-        std::cout << make_msg(msg_ur_string()) << std::endl;
+        std::cout << this->make_error(msg_ur_string()) << std::endl;
         return;
     }
 
@@ -1280,19 +1378,19 @@ void Application::cmd_update_range(const Command& cmd)
         is_hex[i] = is_input_hex(cmd.args().at(i));
         if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(i)))
         {
-            std::cout << make_msg(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
             return;
         }
         else if (utility::is_integral(this->cfg.type()))
         {
             if (!is_hex[i] && !utility::is_dec(cmd.args().at(i)))
             {
-                std::cout << make_msg(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
                 return;
             }
             if (is_hex[i] && !utility::is_hex(cmd.args().at(i)))
             {
-                std::cout << make_msg(msg_not_hex(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
                 return;
             }
         }
@@ -1300,20 +1398,15 @@ void Application::cmd_update_range(const Command& cmd)
 
     // convert arguments
     uint8_t in_value1[this->cfg.type_size()], in_value2[this->cfg.type_size()];
-    utility::to_bytes(cmd.args().at(0), this->cfg.type_size(), this->cfg.type(), is_hex[0], in_value1);
-    utility::to_bytes(cmd.args().at(1), this->cfg.type_size(), this->cfg.type(), is_hex[1], in_value2);
+    if (!this->convert_argument(cmd, 0, this->cfg.type_size(), is_hex[0], in_value1)) return;
+    if (!this->convert_argument(cmd, 1, this->cfg.type_size(), is_hex[1], in_value2)) return;
 
     // backup buffer
     this->make_backup();
     this->search_buffer.resize(this->undo_buffer.size());
 
-    // search for new values in buffer
-    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
-    uint64_t count = this->update(in_value1, in_value2, this->cfg.type_size());
-    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
-
-    this->search_buffer.shrink_to_fit();
-    std::cout << make_msg(msg_update_success(count, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+    // search for new values in buffer in the background
+    this->update(cmd.name(), in_value1, in_value2, this->cfg.type_size());
 }
 
 void Application::cmd_undo(const Command& cmd)
@@ -1323,7 +1416,7 @@ void Application::cmd_undo(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_undo_syntax()) << std::endl;
+        std::cout << this->make_error(msg_undo_syntax()) << std::endl;
         return;
     }
 
@@ -1332,7 +1425,7 @@ void Application::cmd_undo(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1346,7 +1439,7 @@ void Application::cmd_undo(const Command& cmd)
         std::cout << make_msg(msg_undo_done(duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
     }
     else
-        std::cout << make_msg(msg_undo_none()) << std::endl;
+        std::cout << this->make_error(msg_undo_none()) << std::endl;
 }
 
 void Application::cmd_redo(const Command& cmd)
@@ -1356,7 +1449,7 @@ void Application::cmd_redo(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 0)
     {
-        std::cout << make_msg(msg_redo_syntax()) << std::endl;
+        std::cout << this->make_error(msg_redo_syntax()) << std::endl;
         return;
     }
 
@@ -1365,7 +1458,7 @@ void Application::cmd_redo(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
@@ -1379,7 +1472,7 @@ void Application::cmd_redo(const Command& cmd)
         std::cout << make_msg(msg_redo_done(duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
     }
     else
-        std::cout << make_msg(msg_redo_none()) << std::endl;
+        std::cout << this->make_error(msg_redo_none()) << std::endl;
 }
 
 void Application::cmd_show(const Command& cmd)
@@ -1387,7 +1480,7 @@ void Application::cmd_show(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 2)
     {
-        std::cout << make_msg(msg_show_syntax()) << std::endl;
+        std::cout << this->make_error(msg_show_syntax()) << std::endl;
         return;
     }
 
@@ -1396,19 +1489,19 @@ void Application::cmd_show(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_dec(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_dec(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
 
@@ -1434,33 +1527,34 @@ void Application::cmd_show_live(const Command& cmd)
     // syntax check
     if (cmd.args().size() != 3)
     {
-        std::cout << make_msg(msg_sl_syntax()) << std::endl;
+        std::cout << this->make_error(msg_sl_syntax()) << std::endl;
         return;
     }
 
-    // check for invalid options (all options)
+    // check for invalid options
+    const std::vector<std::string> all_options = { "c", "-changes" };
     std::vector<std::string> unknown_options;
-    list_unknown_options(cmd, {}, unknown_options);
+    list_unknown_options(cmd, all_options, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_dec(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_dec(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_dec(cmd.args().at(2)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(2), 3, cmd.name())) << std::endl;
         return;
     }
 
@@ -1472,35 +1566,130 @@ void Application::cmd_show_live(const Command& cmd)
         std::cout << make_msg(msg_close_live_memory(this->pid_live_memory)) << std::endl;
     }
 
-    // build command for live memory process
-    std::stringstream live_memory_cmd;
-    live_memory_cmd << LIVE_MEMORY_PROCESS_NAME << " " << cmd.args().at(0) << " " << cmd.args().at(1) << " " << cmd.args().at(2);
-
-    // print addresses to file
-    std::cout << make_msg(msg_sl_print_start(LIVE_MEMORY_FILE_PATH)) << std::endl;
-    if (!utility::write_addresses_to_file(LIVE_MEMORY_FILE_PATH, this->search_buffer))
+    // publish addresses to shared memory, the segment is created once and reused by every live memory view
+    if (!this->shared_results.is_valid())
+    {
+        std::stringstream segment_name;
+        segment_name << LIVE_MEMORY_SEGMENT_NAME << this->pid_this;
+        if (!this->shared_results.create(segment_name.str(), this->search_buffer.table().size()))
+        {
+            std::cout << this->make_error(msg_sl_segment_failure(segment_name.str())) << std::endl;
+            return;
+        }
+    }
+    if (!this->shared_results.publish(this->search_buffer))
     {
-        std::cout << make_msg(msg_sl_print_failure(LIVE_MEMORY_FILE_PATH)) << std::endl;
+        std::cout << this->make_error(msg_sl_segment_failure(this->shared_results.name())) << std::endl;
         return;
     }
-    std::cout << make_msg(msg_sl_print_finish(LIVE_MEMORY_FILE_PATH)) << std::endl;
+    this->published_generation = this->search_buffer.generation();
+
+    // build command for live memory process
+    std::stringstream live_memory_cmd;
+    live_memory_cmd << LIVE_MEMORY_PROCESS_NAME << " " << cmd.args().at(0) << " " << cmd.args().at(1) << " " << cmd.args().at(2) << " " << this->shared_results.name()
+                    << " " << ((cmd.options().find_any({ "c", "-changes" }, 0) != CmdOpionList::NPOS) ? 1 : 0);
 
     // start live memory view process
     this->pid_live_memory = this->process_handler.start_process(LIVE_MEMORY_PROCESS_PATH, live_memory_cmd.str());
     if (this->pid_live_memory == MEMORY_PID_INVALID)
     {
-        std::cout << make_msg(msg_sl_process_failure()) << std::endl;
+        std::cout << this->make_error(msg_sl_process_failure()) << std::endl;
         return;
     }
     std::cout << make_msg(msg_sl_process_success(this->pid_live_memory)) << std::endl;
 }
 
-void Application::cmd_dump(const Command& cmd)
+void Application::cmd_watch(const Command& cmd)
 {
     // syntax check
-    if (cmd.args().size() != 4)
+    if (cmd.args().size() != 0 && cmd.args().size() != 3)
+    {
+        std::cout << this->make_error(msg_watch_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "r", "-rate" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // show statistics of the watched addresses
+    if (cmd.args().size() == 0)
+    {
+        if (this->watch.size() == 0)
+        {
+            std::cout << make_msg(msg_watch_none()) << std::endl;
+            return;
+        }
+
+        std::vector<Watch::Statistics> stats;
+        this->watch.statistics(stats);
+        if (cmd.options().find_any(all_options, 0) != CmdOpionList::NPOS)
+            std::stable_sort(stats.begin(), stats.end(), [](const Watch::Statistics& a, const Watch::Statistics& b) { return a.change_rate > b.change_rate; });
+
+        std::vector<std::string> entry(this->watch_table.col_count());
+        for (const Watch::Statistics& s : stats)
+        {
+            make_watch_entry(s, entry);
+            this->watch_table.add(entry);
+        }
+        std::cout << make_msg(msg_watch_status(this->watch.running(), this->watch.ticks(), this->watch.interval())) << std::endl;
+        this->watch_table.print();
+        this->watch_table.clear_entries();
+        return;
+    }
+
+    // check for correct arguments
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        if (!utility::is_dec(cmd.args().at(i)))
+        {
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+            return;
+        }
+    }
+
+    // convert arguments
+    uint32_t start, end, interval;
+    sscanf(cmd.args().at(0).c_str(), "%" PRIu32, &start);
+    sscanf(cmd.args().at(1).c_str(), "%" PRIu32, &end); // end = amount
+    sscanf(cmd.args().at(2).c_str(), "%" PRIu32, &interval);
+    end += start;
+
+    // a running watch is replaced
+    if (this->watch.running())
+        std::cout << make_msg(msg_close_watch()) << std::endl;
+    this->watch.clear();
+
+    uint64_t skipped = 0;
+    for (uint32_t i = start; i < end && i < this->search_buffer.table().size(); i++)
+    {
+        const Buffer::Element& e = this->search_buffer.table()[i];
+        if (!this->watch.add(e.pid, e.address, e.type, e.size))
+            ++skipped;
+    }
+    if (skipped > 0)
+        std::cout << make_msg(msg_watch_skipped(skipped)) << std::endl;
+
+    if (!this->watch.start(interval))
     {
-        std::cout << make_msg(msg_dump_syntax()) << std::endl;
+        std::cout << this->make_error(msg_watch_failure()) << std::endl;
+        return;
+    }
+    std::cout << make_msg(msg_watch_start(this->watch.size(), this->watch.interval())) << std::endl;
+}
+
+void Application::cmd_record(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() != 0 && cmd.args().size() != 4)
+    {
+        std::cout << this->make_error(msg_record_syntax()) << std::endl;
         return;
     }
 
@@ -1509,36 +1698,113 @@ void Application::cmd_dump(const Command& cmd)
     list_unknown_options(cmd, {}, unknown_options);
     if (unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // show status of the recording
+    if (cmd.args().size() == 0)
+    {
+        if (this->recorder.size() == 0)
+        {
+            std::cout << make_msg(msg_record_none()) << std::endl;
+            return;
+        }
+        Recorder::Status status = this->recorder.status();
+        std::cout << make_msg(msg_record_status(status.running, this->recorder.size(), status.samples, status.failed, status.chunks, status.raw_bytes, status.file_bytes)) << std::endl;
+        return;
+    }
+
+    // check for correct arguments
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        if (!utility::is_dec(cmd.args().at(i)))
+        {
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(i), i + 1, cmd.name())) << std::endl;
+            return;
+        }
+    }
+
+    // convert arguments
+    uint32_t start, end, rate;
+    sscanf(cmd.args().at(0).c_str(), "%" PRIu32, &start);
+    sscanf(cmd.args().at(1).c_str(), "%" PRIu32, &end); // end = amount
+    sscanf(cmd.args().at(2).c_str(), "%" PRIu32, &rate);
+    end += start;
+    if (rate == 0 || rate > 1000000)
+    {
+        std::cout << this->make_error(msg_record_rate()) << std::endl;
+        return;
+    }
+
+    // a running recording is finished first
+    if (this->recorder.running())
+        std::cout << make_msg(msg_close_record()) << std::endl;
+    this->recorder.clear();
+
+    uint64_t skipped = 0;
+    for (uint32_t i = start; i < end && i < this->search_buffer.table().size(); i++)
+    {
+        const Buffer::Element& e = this->search_buffer.table()[i];
+        if (!this->recorder.add(e.pid, e.address, e.type, e.size))
+            ++skipped;
+    }
+    if (skipped > 0)
+        std::cout << make_msg(msg_record_skipped(skipped)) << std::endl;
+
+    if (!this->recorder.start(cmd.args().at(3), rate))
+    {
+        std::cout << this->make_error(msg_record_failure(cmd.args().at(3))) << std::endl;
+        return;
+    }
+    std::cout << make_msg(msg_record_start(this->recorder.size(), rate, cmd.args().at(3))) << std::endl;
+}
+
+void Application::cmd_dump(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() != 4)
+    {
+        std::cout << this->make_error(msg_dump_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "c", "-changes", "a", "-ascii" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_hex(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_hex(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_hex(cmd.args().at(2)))
     {
-        std::cout << make_msg(msg_not_hex(cmd.args().at(1), 3, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_hex(cmd.args().at(1), 3, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_dec(cmd.args().at(3)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(3), 4, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(3), 4, cmd.name())) << std::endl;
         return;
     }
 
-    // check for open process
-    if (!this->current_process.is_valid())
+    // check for open process, an open snapshot or core dump is shown instead of the process
+    if (!this->current_process.is_valid() && this->source == nullptr)
     {
-        std::cout << make_msg(msg_close_process_failure()) << std::endl;    // reuse message
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
         return;
     }
 
@@ -1552,12 +1818,17 @@ void Application::cmd_dump(const Command& cmd)
 
     // build memory dump command
     std::stringstream dump_cmd;
-    dump_cmd << DUMP_PROCESS_NAME << " " << this->current_process.pid() << " " << cmd.args().at(0) << " " << cmd.args().at(1) << " " << cmd.args().at(2) << " " << cmd.args().at(3);
+    const pid_t pid = (this->source != nullptr) ? this->source->pid() : this->current_process.pid();
+    dump_cmd << DUMP_PROCESS_NAME << " " << pid << " " << cmd.args().at(0) << " " << cmd.args().at(1) << " " << cmd.args().at(2) << " " << cmd.args().at(3)
+             << " " << ((cmd.options().find_any({ "c", "-changes" }, 0) != CmdOpionList::NPOS) ? 1 : 0)
+             << " " << ((cmd.options().find_any({ "a", "-ascii" }, 0) != CmdOpionList::NPOS) ? 1 : 0);
+    if (this->source != nullptr)
+        dump_cmd << " \"" << this->source_path << "\"";     // the dump maps the file itself
 
     // start memory dump
     this->pid_dump = this->process_handler.start_process(DUMP_PROCESS_PATH, dump_cmd.str());
     if (this->pid_dump == MEMORY_PID_INVALID)
-        std::cout << make_msg(msg_dump_failure()) << std::endl;
+        std::cout << this->make_error(msg_dump_failure()) << std::endl;
     else
         std::cout << make_msg(msg_dump_success(this->pid_dump)) << std::endl;
 }
@@ -1567,38 +1838,45 @@ void Application::cmd_save(const Command& cmd)
     // syntax check
     if(cmd.args().size() != 3)
     {
-        std::cout << make_msg(msg_save_syntax()) << std::endl;
+        std::cout << this->make_error(msg_save_syntax()) << std::endl;
         return;
     }
 
     // check for invalid options (all options)
-    const std::vector<std::string> all_options = {"b", "-binary", "csv"};
+    const std::vector<std::string> all_options = {"b", "-binary", "c", "-compress", "csv", "j", "-jsonl"};
     std::vector<std::string> unknown_options;
     list_unknown_options(cmd, all_options, unknown_options);
     if(unknown_options.size() > 0)
     {
-        std::cout << make_msg(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
         return;
     }
 
     // check if there are no conflicting options
     const bool opt_binary   = (cmd.options().find_any({"b", "-binary"}, 0) != memory::CmdOpionList::NPOS);
     const bool opt_csv      = (cmd.options().find("csv", 0) != memory::CmdOpionList::NPOS);
-    if(opt_binary && opt_csv)
+    const bool opt_jsonl    = (cmd.options().find_any({"j", "-jsonl"}, 0) != memory::CmdOpionList::NPOS);
+    const bool opt_compress = (cmd.options().find_any({"c", "-compress"}, 0) != memory::CmdOpionList::NPOS);
+    if((opt_binary ? 1 : 0) + (opt_csv ? 1 : 0) + (opt_jsonl ? 1 : 0) > 1)
+    {
+        std::cout << this->make_error(msg_save_option_conflict()) << std::endl;
+        return;
+    }
+    if(opt_compress && !opt_binary)
     {
-        std::cout << make_msg(msg_save_option_conflict()) << std::endl;
+        std::cout << this->make_error(msg_save_compress_conflict()) << std::endl;
         return;
     }
 
     // check for correct arguments
     if (!utility::is_dec(cmd.args().at(0)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(0), 1, cmd.name())) << std::endl;
         return;
     }
     if (!utility::is_dec(cmd.args().at(1)))
     {
-        std::cout << make_msg(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
+        std::cout << this->make_error(msg_not_dec(cmd.args().at(1), 2, cmd.name())) << std::endl;
         return;
     }
 
@@ -1607,55 +1885,545 @@ void Application::cmd_save(const Command& cmd)
     sscanf(cmd.args().at(0).c_str(), "%" PRIu32, &start);
     sscanf(cmd.args().at(1).c_str(), "%" PRIu32, &end);     // end = amount
     end += start;
+    if (end > this->search_buffer.table().size() || end < start)
+        end = this->search_buffer.table().size();
 
-    // plane text file
-    if(cmd.options().size() == 0)
+    // binary result file, it can be loaded again with the command "load"
+    if(opt_binary)
     {
         const std::string file_name = cmd.args().at(2);
-        std::fstream file(file_name, std::ios::out | std::ios::trunc);
-        if(!file)
-        {
-            std::cout << make_msg(msg_save_file_failure(file_name)) << std::endl; 
-            return;
-        }
-
-        // write entries to file
-        for(uint32_t i = start; i < end && this->search_buffer.table().size(); i++)
-        {
-            const Buffer::Element& e = this->search_buffer.table()[i];
-            std::string value;
-            utility::to_string(reinterpret_cast<uint8_t*>(e.data), e.size, this->cfg.type(), false, value);
-            file    << e.pid 
-                    << "," 
-                    << e.address
-                    << "," 
-                    << e.size
-                    << ","
-                    << static_cast<uint32_t>(e.type)
-                    << std::endl;
-        }
-        file.close();
+        if (results::write(file_name, this->search_buffer, start, end - start, opt_compress))
+            std::cout << make_msg(msg_save_success(end - start, file_name)) << std::endl;
+        else
+            std::cout << this->make_error(msg_save_write_failure(file_name)) << std::endl;
+        return;
     }
 
-    // binary file
-    if(opt_binary)
+    // plane text, csv or json-lines file, the file type is added automatically for csv and json-lines
+    export_format_t format = MEMORY_EXPORT_TEXT;
+    std::string file_name = cmd.args().at(2);
+    if (opt_csv || opt_jsonl)
     {
-        const std::string file_name = cmd.args().at(2);
-        utility::write_addresses_to_file(file_name, this->search_buffer);
+        const std::string file_type = opt_csv ? ".csv" : ".jsonl";
+        format = opt_csv ? MEMORY_EXPORT_CSV : MEMORY_EXPORT_JSONL;
+        if (file_name.size() < file_type.size() || file_name.compare(file_name.size() - file_type.size(), file_type.size(), file_type) != 0)
+            file_name += file_type;
     }
 
-    // csv file
-    if(opt_csv)
+    Exporter exporter;
+    if (!exporter.open(file_name, format))
     {
-        
+        std::cout << this->make_error(msg_save_file_failure(file_name)) << std::endl;
+        return;
+    }
+
+    // modules are enumerated once per process, addresses are then saved module-relative
+    for (uint32_t i = start; i < end; i++)
+    {
+        const Buffer::Element& e = this->search_buffer.table()[i];
+        if (format != MEMORY_EXPORT_TEXT && !exporter.has_modules(e.pid))
+        {
+            std::vector<ModuleInfo> modules;
+            Process::enum_modules(e.pid, modules);
+            exporter.add_modules(e.pid, std::move(modules));
+        }
+        exporter.write(e);
+    }
+
+    if (exporter.close())
+        std::cout << make_msg(msg_save_success(exporter.rows(), file_name)) << std::endl;
+    else
+        std::cout << this->make_error(msg_save_write_failure(file_name)) << std::endl;
+}
+
+void Application::cmd_load(const Command& cmd)
+{
+    using namespace std::chrono;
+
+    // syntax check
+    if (cmd.args().size() != 1)
+    {
+        std::cout << this->make_error(msg_load_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options (all options)
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, {}, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // the file is mapped, the elements point to the values inside of the file
+    const std::string& file_name = cmd.args().at(0);
+    time_point<high_resolution_clock> t0 = high_resolution_clock::now();
+    ResultFile file;
+    std::vector<Buffer::Element> elements;
+    if (!file.open(file_name))
+    {
+        std::cout << this->make_error(msg_load_file_failure(file_name)) << std::endl;
+        return;
+    }
+    if (!file.read(elements))
+    {
+        std::cout << this->make_error(msg_load_corrupt(file_name)) << std::endl;
+        return;
+    }
+
+    // the values must fit into the search buffer
+    size_t total_size = 0;
+    for (const Buffer::Element& e : elements)
+        total_size += e.size;
+    if (total_size > this->cfg.search_limit_size())
+    {
+        std::cout << this->make_error(msg_load_limit(total_size, this->cfg.search_limit_size())) << std::endl;
+        return;
     }
-}   
 
+    // backup buffer
+    this->make_backup();
+    this->search_buffer.resize(total_size);
+
+    // files of the old format contain no values, they are read from the processes
+    Process cur_p;
+    std::vector<uint8_t> value;
+    for (const Buffer::Element& e : elements)
+    {
+        if (!file.legacy())
+        {
+            this->search_buffer.push(e.pid, e.address, e.size, e.type, e.data);
+            continue;
+        }
+
+        if (e.pid != cur_p.pid() || !cur_p.is_valid())
+        {
+            cur_p.close();
+            cur_p.init("", e.pid, 0, 0);
+            cur_p.open();
+        }
+        value.assign(e.size, 0);
+        if (cur_p.is_valid())
+            cur_p.read(e.address, e.size, value.data());
+        this->search_buffer.push(e.pid, e.address, e.size, e.type, value.data());
+    }
+    cur_p.close();
+    time_point<high_resolution_clock> t1 = high_resolution_clock::now();
+
+    this->search_buffer.shrink_to_fit();
+    std::cout << make_msg(msg_load_success(elements.size(), file_name, duration_cast<microseconds>(t1 - t0).count() / 1000.0)) << std::endl;
+}
+
+void Application::cmd_status(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() != 0)
+    {
+        std::cout << this->make_error(msg_status_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options (all options)
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, {}, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    if (this->job.active)
+        std::cout << make_msg(this->job_status()) << std::endl;
+    else
+        std::cout << make_msg(msg_job_none()) << std::endl;
+}
+
+void Application::cmd_cancel(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() != 0)
+    {
+        std::cout << this->make_error(msg_cancel_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options (all options)
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, {}, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    if (!this->job.active)
+    {
+        std::cout << this->make_error(msg_job_none()) << std::endl;
+        return;
+    }
+
+    // the job stops within one chunk, the results found so far are kept
+    this->job.cancel = true;
+    this->wait_job(false);
+}
+
+void Application::cmd_wait(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() != 0)
+    {
+        std::cout << this->make_error(msg_wait_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options (all options)
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, {}, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    if (this->job.active)
+        this->wait_job(true);
+    else
+        std::cout << make_msg(msg_job_none()) << std::endl;
+}
+
+void Application::cmd_stats(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() > 1)
+    {
+        std::cout << this->make_error(msg_stats_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "j", "-json", "c", "-close" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // stop appending to the file
+    if (cmd.options().find_any({ "c", "-close" }, 0) != memory::CmdOpionList::NPOS)
+    {
+        if (!this->last_stats.log.is_open())
+        {
+            std::cout << this->make_error(msg_stats_log_none()) << std::endl;
+            return;
+        }
+        this->last_stats.log.close();
+        std::cout << make_msg(msg_stats_log_close()) << std::endl;
+        return;
+    }
+
+    // start appending to a file, a file that is already open is closed
+    if (cmd.args().size() == 1)
+    {
+        if (this->last_stats.log.is_open())
+            this->last_stats.log.close();
+        this->last_stats.log.open(cmd.args().at(0), std::ios::out | std::ios::app);
+        if (!this->last_stats.log.is_open())
+        {
+            std::cout << this->make_error(msg_stats_log_failure(cmd.args().at(0))) << std::endl;
+            return;
+        }
+        std::cout << make_msg(msg_stats_log_start(cmd.args().at(0))) << std::endl;
+        return;
+    }
+
+    if (!this->last_stats.valid)
+    {
+        std::cout << make_msg(msg_stats_none()) << std::endl;
+        return;
+    }
+
+    if (cmd.options().find_any({ "j", "-json" }, 0) != memory::CmdOpionList::NPOS)
+        std::cout << this->stats_json() << std::endl;
+    else
+        this->print_stats();
+}
+
+void Application::cmd_trace(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() > 1)
+    {
+        std::cout << this->make_error(msg_trace_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "c", "-close" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    if (!Trace::ENABLED)
+    {
+        std::cout << this->make_error(msg_trace_disabled()) << std::endl;
+        return;
+    }
+
+    // stop tracing
+    if (cmd.options().find_any({ "c", "-close" }, 0) != memory::CmdOpionList::NPOS)
+    {
+        if (this->trace_path.empty())
+        {
+            std::cout << this->make_error(msg_trace_none()) << std::endl;
+            return;
+        }
+        this->trace_path.clear();
+        std::cout << make_msg(msg_trace_close()) << std::endl;
+        return;
+    }
+
+    if (cmd.args().size() == 0)
+    {
+        if (this->trace_path.empty())
+            std::cout << make_msg(msg_trace_none()) << std::endl;
+        else
+            std::cout << make_msg(msg_trace_start(this->trace_path)) << std::endl;
+        return;
+    }
+
+    // events that have been recorded before are not part of the trace
+    if (!this->job.active)
+        Trace::clear();
+    this->trace_path = cmd.args().at(0);
+    std::cout << make_msg(msg_trace_start(this->trace_path)) << std::endl;
+}
+
+void Application::cmd_snapshot(const Command& cmd)
+{
+    using namespace std::chrono;
+
+    // syntax check
+    if (cmd.args().size() > 1)
+    {
+        std::cout << this->make_error(msg_snapshot_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    const std::vector<std::string> all_options = { "o", "-open", "c", "-close" };
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, all_options, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+    const bool open = cmd.options().find_any({ "o", "-open" }, 0) != memory::CmdOpionList::NPOS;
+    const bool close = cmd.options().find_any({ "c", "-close" }, 0) != memory::CmdOpionList::NPOS;
+    if ((open && close) || (open && cmd.args().size() != 1) || (close && cmd.args().size() != 0))
+    {
+        std::cout << this->make_error(msg_snapshot_syntax()) << std::endl;
+        return;
+    }
+
+    auto print_source = [this]()
+    {
+        // core dumps do not store the time
+        const time_t time = static_cast<time_t>(this->source->time());
+        std::stringstream time_str;
+        if (time > 0)
+            time_str << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
+        else
+            time_str << "unknown";
+        std::string prefix;
+        const double bytes = auto_SI(this->source->bytes(), prefix);
+        std::cout << make_msg(msg_snapshot_info(this->source->format(), this->source_path, this->source->pid(), time_str.str(),
+                                                this->source->regions().size(), bytes, prefix)) << std::endl;
+    };
+
+    // show the open snapshot or core dump
+    if (cmd.args().size() == 0 && !close)
+    {
+        if (this->source != nullptr)
+            print_source();
+        else
+            std::cout << make_msg(msg_snapshot_none()) << std::endl;
+        return;
+    }
+
+    // close the snapshot or core dump, the process is read again
+    if (close)
+    {
+        if (this->source == nullptr)
+        {
+            std::cout << this->make_error(msg_snapshot_none()) << std::endl;
+            return;
+        }
+        this->source.reset();
+        std::cout << make_msg(msg_snapshot_close(this->source_path)) << std::endl;
+        this->source_path.clear();
+        return;
+    }
+
+    // open a snapshot or core dump, the format is detected by the file
+    if (open)
+    {
+        this->source.reset();
+        this->source_path.clear();
+        this->source = MappedSource::open_file(cmd.args().at(0));
+        if (this->source == nullptr)
+        {
+            std::cout << this->make_error(msg_snapshot_open_failure(cmd.args().at(0))) << std::endl;
+            return;
+        }
+        this->source_path = cmd.args().at(0);
+        print_source();
+        return;
+    }
+
+    // write a snapshot of the open process
+    if (!this->current_process.is_valid())
+    {
+        std::cout << this->make_error(msg_close_process_failure()) << std::endl;    // reuse message
+        return;
+    }
+    std::cout << make_msg(msg_snapshot_start(this->current_process.pid(), cmd.args().at(0))) << std::endl;
+    snapshot::WriteResult result;
+    const time_point<high_resolution_clock> t0 = high_resolution_clock::now();
+    if (!snapshot::write(cmd.args().at(0), this->current_process, this->cfg.start_address(), this->cfg.end_address(), 0, result))
+    {
+        std::cout << this->make_error(msg_snapshot_failure(cmd.args().at(0))) << std::endl;
+        return;
+    }
+    const double time_s = duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000000.0;
+
+    std::string bytes_prefix, failed_prefix, rate_prefix;
+    const double bytes = auto_SI(result.bytes, bytes_prefix);
+    const double failed = auto_SI(result.failed_bytes, failed_prefix);
+    const double rate = auto_SI((time_s > 0.0) ? static_cast<uint64_t>(result.bytes / time_s) : 0, rate_prefix);
+    std::cout << make_msg(msg_snapshot_success(result.regions, bytes, bytes_prefix, failed, failed_prefix, time_s, rate, rate_prefix)) << std::endl;
+}
+
+void Application::cmd_diff(const Command& cmd)
+{
+    // syntax check
+    if (cmd.args().size() < 2 || cmd.args().size() > 4)
+    {
+        std::cout << this->make_error(msg_diff_syntax()) << std::endl;
+        return;
+    }
+
+    // check for invalid options
+    std::vector<std::string> unknown_options;
+    list_unknown_options(cmd, {}, unknown_options);
+    if (unknown_options.size() > 0)
+    {
+        std::cout << this->make_error(msg_unknown_options(cmd.name(), unknown_options)) << std::endl;
+        return;
+    }
+
+    // check for correct arguments
+    const diff_t op = (cmd.args().size() > 2) ? to_diff(cmd.args().at(2)) : MEMORY_DIFF_CHANGED;
+    if (op == MEMORY_DIFF_INVALID)
+    {
+        std::cout << this->make_error(msg_diff_invalid(cmd.args().at(2))) << std::endl;
+        return;
+    }
+    const bool by_value = (cmd.args().size() == 4);
+    if (by_value && op == MEMORY_DIFF_CHANGED)
+    {
+        std::cout << this->make_error(msg_diff_syntax()) << std::endl;
+        return;
+    }
+    if (utility::is_string(this->cfg.type()))
+    {
+        std::cout << this->make_error(msg_diff_string()) << std::endl;
+        return;
+    }
+    bool is_hex = false;
+    if (by_value)
+    {
+        is_hex = is_input_hex(cmd.args().at(3));
+        if (utility::is_floating_point(this->cfg.type()) && !utility::is_floating_point(cmd.args().at(3)))
+        {
+            std::cout << this->make_error(msg_not_dec(cmd.args().at(3), 4, cmd.name())) << std::endl;
+            return;
+        }
+        else if (utility::is_integral(this->cfg.type()))
+        {
+            if (!is_hex && !utility::is_dec(cmd.args().at(3)))
+            {
+                std::cout << this->make_error(msg_not_dec(cmd.args().at(3), 4, cmd.name())) << std::endl;
+                return;
+            }
+            if (is_hex && !utility::is_hex(cmd.args().at(3)))
+            {
+                std::cout << this->make_error(msg_not_hex(cmd.args().at(3), 4, cmd.name())) << std::endl;
+                return;
+            }
+        }
+    }
+
+    // convert arguments
+    const size_t size = this->cfg.type_size();
+    uint8_t in_value[size];
+    if (by_value && !this->convert_argument(cmd, 3, size, is_hex, in_value)) return;
+
+    // open both files, the format of each file is detected separately
+    std::unique_ptr<MappedSource> sources[2];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        sources[i] = MappedSource::open_file(cmd.args().at(i));
+        if (sources[i] == nullptr)
+        {
+            std::cout << this->make_error(msg_snapshot_open_failure(cmd.args().at(i))) << std::endl;
+            return;
+        }
+    }
+
+    this->make_backup();
+    this->search_buffer.resize(this->cfg.search_limit_size());
+    std::cout << make_msg(msg_diff_start(cmd.args().at(0), cmd.args().at(1))) << std::endl;
+    this->diff(cmd.name(), std::move(sources[0]), std::move(sources[1]), op, by_value ? in_value : nullptr);
+}
 
 bool Application::on_command(const Command& cmd)
 {
+    this->command_failed = false;
     if (cmd.name() == "")                                           return true;
-    if (cmd.name() == "exit")                                       return false;
+
+    // the trace of a command begins with the command, a job keeps the begin of the command that has started it
+    if (!this->job.active)
+        this->trace_begin = Trace::now();
+
+    // the result of a finished job is printed before the next command
+    if (this->job.active && this->job.finished)
+        this->finish_job();
+    if (cmd.name() == "exit")
+    {
+        if (this->job.active)
+        {
+            this->job.cancel = true;
+            this->finish_job();
+        }
+        return false;
+    }
+
+    // only commands that do not use the stored results can run while the job writes them
+    const static std::vector<std::string> job_commands = { "help", "status", "cancel", "wait", "stats", "trace", "list", "info", "clear", "cls", "read_single", "rs", "read_block", "rb" };
+    if (this->job.active && std::find(job_commands.begin(), job_commands.end(), cmd.name()) == job_commands.end())
+    {
+        std::cout << this->make_error(msg_job_running(this->job.command)) << std::endl;
+        return true;
+    }
+
     if (cmd.name() == "help")                                       this->cmd_help(cmd);
     else if (cmd.name() == "config")                                this->cmd_config(cmd);
     else if (cmd.name() == "list")                                  this->cmd_list(cmd);
@@ -1670,6 +2438,7 @@ bool Application::on_command(const Command& cmd)
     else if (cmd.name() == "write_all"      || cmd.name() == "wa")  this->cmd_write_all(cmd);
     else if (cmd.name() == "write_single"   || cmd.name() == "ws")  this->cmd_write_single(cmd);
     else if (cmd.name() == "write_range"    || cmd.name() == "wr")  this->cmd_write_range(cmd);
+    else if (cmd.name() == "transform")                             this->cmd_transform(cmd);
     else if (cmd.name() == "update")                                this->cmd_update(cmd);
     else if (cmd.name() == "update_exact"   || cmd.name() == "ue")  this->cmd_update_exact(cmd);
     else if (cmd.name() == "update_range"   || cmd.name() == "ur")  this->cmd_update_range(cmd);
@@ -1677,8 +2446,29 @@ bool Application::on_command(const Command& cmd)
     else if (cmd.name() == "redo")                                  this->cmd_redo(cmd);
     else if (cmd.name() == "show")                                  this->cmd_show(cmd);
     else if (cmd.name() == "show_live"      || cmd.name() == "sl")  this->cmd_show_live(cmd);
+    else if (cmd.name() == "watch")                                 this->cmd_watch(cmd);
+    else if (cmd.name() == "record")                                this->cmd_record(cmd);
     else if (cmd.name() == "dump")                                  this->cmd_dump(cmd);
     else if (cmd.name() == "save")                                  this->cmd_save(cmd);
-    else                                                            std::cout << make_msg(msg_unknown_command(cmd.name())) << std::endl;
+    else if (cmd.name() == "load")                                  this->cmd_load(cmd);
+    else if (cmd.name() == "status")                                this->cmd_status(cmd);
+    else if (cmd.name() == "cancel")                                this->cmd_cancel(cmd);
+    else if (cmd.name() == "wait")                                  this->cmd_wait(cmd);
+    else if (cmd.name() == "stats")                                 this->cmd_stats(cmd);
+    else if (cmd.name() == "trace")                                 this->cmd_trace(cmd);
+    else if (cmd.name() == "snapshot")                              this->cmd_snapshot(cmd);
+    else if (cmd.name() == "diff")                                  this->cmd_diff(cmd);
+    else                                                            std::cout << this->make_error(msg_unknown_command(cmd.name())) << std::endl;
+
+    // the live memory view picks up the changes of the stored addresses, a running job is still writing them
+    if (this->pid_live_memory != MEMORY_PID_INVALID && !this->process_handler.is_running(this->pid_live_memory))
+        this->pid_live_memory = MEMORY_PID_INVALID;     // the view has been closed by the user
+    if (!this->job.active && this->pid_live_memory != MEMORY_PID_INVALID && this->shared_results.is_valid()
+        && this->search_buffer.generation() != this->published_generation)
+    {
+        if (this->shared_results.publish(this->search_buffer))
+            this->published_generation = this->search_buffer.generation();
+    }
+    this->export_trace();
     return true;
 }
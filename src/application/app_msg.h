@@ -12,7 +12,9 @@
 #pragma once
 
 #include "../memory/types.h"
+#include "../memory/utility.h"
 #include <sstream>
+#include <iomanip>
 
 namespace memory
 {
@@ -41,6 +43,7 @@ namespace memory
                     "write_all or wa        Writes to all addresses that are currently stored.\n"
                     "write_single or ws     Writes to a single memory address.\n"
                     "write_range or wr      Writes to a range of memory addresses.\n"
+                    "transform              Applies an arithmetic operation to all addresses that are currently stored.\n"
                     "upate                  Updates the currently stored values.\n"
                     "upate_exact or ue      Searches for an exact new value in the currently stored values.\n"
                     "upate_range or ur      Searches for an range of values in the currently stored values.\n"
@@ -48,8 +51,18 @@ namespace memory
                     "redo                   Redoes the current read or search operation.\n"
                     "show                   Showes the currently read addresses and values.\n"
                     "show_live or sl        Showes the currently read addresses and values with live update.\n"
+                    "watch                  Samples the currently read addresses in the background and shows statistics.\n"
+                    "record                 Records the currently read addresses with a fixed rate to a file.\n"
                     "dump                   Makes a memory dump.\n"
-                    "save                   Saves the last read/updated addresses and values to a file.\n\n";
+                    "save                   Saves the last read/updated addresses and values to a file.\n"
+                    "load                   Loads addresses and values that have been saved in binary.\n"
+                    "status                 Shows the progress of the running scan or update.\n"
+                    "cancel                 Cancels the running scan or update.\n"
+                    "wait                   Waits for the running scan or update and shows its progress.\n"
+                    "stats                  Shows counters and phase times of the last scan or update.\n"
+                    "trace                  Writes a timeline of the scans, updates and writes to a file.\n"
+                    "snapshot               Writes the memory of the opened process to a file, opens snapshots and core dumps.\n"
+                    "diff                   Compares two snapshots or core dumps and stores the changed values.\n\n";
         }
         inline std::string msg_help_exit(void)
         {
@@ -142,7 +155,9 @@ namespace memory
                     "   - NO OPTION:            closes everything that has been opened\n"
                     "   - -p or --process       only closes the current open process\n"
                     "   - -l or --live          only closes live memory showcase\n"
-                    "   - -d or --dump          only closes hex dump\n\n";
+                    "   - -d or --dump          only closes hex dump\n"
+                    "   - -w or --watch         only stops the watch\n"
+                    "   - -r or --record        only stops the recording\n\n";
         }
         inline std::string msg_help_clear(void)
         {
@@ -228,6 +243,30 @@ namespace memory
                     "   - <range>           8B HEXADECIMAL          number of bytes that should be written\n"
                     "   - <value>           set data-type           value that should be written\n\n";
         }
+        inline std::string msg_help_transform(void)
+        {
+            return  "\n------------------------------------------------- Command: transform -------------------------------------------------\n"
+                    "Command: transform\n"
+                    "Syntax: transform <operation> <value> [<value 2>]\n"
+                    "Description: applies an arithmetic operation to all addresses that are currently stored\n"
+                    "Arguments:\n"
+                    "   - <operation>       STRING                  operation that should be applied\n"
+                    "   - <value>           set data-type           operand of the operation\n"
+                    "   - <value 2>         set data-type           upper limit, only for the operation clamp\n"
+                    "Options:\n"
+                    "   - NO OPTION                                 integers wrap around on overflow\n"
+                    "   - -s or --saturate                          integers are limited to the range of the set type\n"
+                    "Aviable operations:\n"
+                    "   - add                                       x = x + value\n"
+                    "   - sub                                       x = x - value\n"
+                    "   - mul                                       x = x * value\n"
+                    "   - xor                                       x = x ^ value, integers only\n"
+                    "   - and                                       x = x & value, integers only\n"
+                    "   - or                                        x = x | value, integers only\n"
+                    "   - min                                       x = min(x, value)\n"
+                    "   - max                                       x = max(x, value)\n"
+                    "   - clamp                                     x = min(max(x, value), value 2)\n\n";
+        }
         inline std::string msg_help_update(void)
         {
             return  "\n-------------------------------------------------- Command: update --------------------------------------------------\n"
@@ -288,7 +327,36 @@ namespace memory
                     "Arguments:\n"
                     "   - <start_entry>     4B unsigned DECIMAL     ID of the start entry\n"
                     "   - <amount>          4B unsigned DECIMAL     amount of entries that should be shown\n"
-                    "   - <update speed>    4B unsigned DECIMAL     update speed in milliseconds\n\n";
+                    "   - <update speed>    4B unsigned DECIMAL     update speed in milliseconds\n"
+                    "Options:\n"
+                    "   - -c or --changes                           highlights values that have changed within the last second\n\n";
+        }
+        inline std::string msg_help_watch(void)
+        {
+            return  "\n--------------------------------------------------- Command: watch ---------------------------------------------------\n"
+                    "Command: watch\n"
+                    "Syntax: watch [<start entry> <amount> <interval>]\n"
+                    "Description: samples the currently read addresses in the background and shows statistics\n"
+                    "Arguments:\n"
+                    "   - NO ARGUMENT                               shows the statistics of the watched addresses\n"
+                    "   - <start_entry>     4B unsigned DECIMAL     ID of the start entry\n"
+                    "   - <amount>          4B unsigned DECIMAL     amount of entries that should be watched\n"
+                    "   - <interval>        4B unsigned DECIMAL     sampling interval in milliseconds\n"
+                    "Options:\n"
+                    "   - -r or --rate                              sorts the statistics by the change rate\n\n";
+        }
+        inline std::string msg_help_record(void)
+        {
+            return  "\n-------------------------------------------------- Command: record --------------------------------------------------\n"
+                    "Command: record\n"
+                    "Syntax: record [<start entry> <amount> <rate> <file name>]\n"
+                    "Description: records the currently read addresses with a fixed rate to a compressed file\n"
+                    "Arguments:\n"
+                    "   - NO ARGUMENT                               shows the status of the recording\n"
+                    "   - <start_entry>     4B unsigned DECIMAL     ID of the start entry\n"
+                    "   - <amount>          4B unsigned DECIMAL     amount of entries that should be recorded\n"
+                    "   - <rate>            4B unsigned DECIMAL     samples per second\n"
+                    "   - <file name>       STRING                  name of the file where the recording is saved\n\n";
         }
         inline std::string msg_help_dump(void)
         {
@@ -300,7 +368,10 @@ namespace memory
                     "   - <begin address>       8B HEXADECIMAL          start address of the memory dump\n"
                     "   - <range>               8B HEXADECIMAL          number of bytes that should be dumped\n"
                     "   - <width>               4B HEXADECIMAL          number of bytes that are contained by one line of the memory dump\n"
-                    "   - <update speed>        4B unsigned DECIMAL     update speed in milliseconds\n\n";
+                    "   - <update speed>        4B unsigned DECIMAL     update speed in milliseconds\n"
+                    "Options:\n"
+                    "   - -c or --changes                               highlights bytes that have changed within the last second\n"
+                    "   - -a or --ascii                                 shows the bytes as ASCII characters next to the hexadecimal values\n\n";
         }
         inline std::string msg_help_save(void)
         {
@@ -313,8 +384,111 @@ namespace memory
                     "   - <file name>       STRING                  name of the file where the entries are saved\n"
                     "Options:\n"
                     "   - NO OPTION:                                saves the entries in plane text, where each column is separated by comma ','\n"
-                    "   - -b or --binary                            saves the entries in binary\n"
-                    "   - -csv                                      saves the entries in csv format (this option uses an automatic file-type \".csv\")\n\n";
+                    "   - -b or --binary                            saves the entries in binary, the file can be loaded with the command \"load\"\n"
+                    "   - -c or --compress                          compresses the addresses of a binary file, only in combination with \"-b\"\n"
+                    "   - -csv                                      saves the entries in csv format (this option uses an automatic file-type \".csv\")\n"
+                    "   - -j or --jsonl                             saves the entries as one JSON object per line (this option uses an automatic file-type \".jsonl\")\n\n";
+        }
+        inline std::string msg_help_load(void)
+        {
+            return  "\n--------------------------------------------------- Command: load ---------------------------------------------------\n"
+                    "Command: load\n"
+                    "Syntax: load <file name>\n"
+                    "Description: loads addresses and values that have been saved with \"save -b\", the loaded entries replace the\n"
+                    "             currently stored entries and can be undone, the values of files of older versions are read from\n"
+                    "             the processes\n"
+                    "   - <file name>       STRING                  name of the file to load\n\n";
+        }
+        inline std::string msg_help_status(void)
+        {
+            return  "\n-------------------------------------------------- Command: status --------------------------------------------------\n"
+                    "Command: status\n"
+                    "Syntax: status\n"
+                    "Description: shows the progress of the running scan or update: scanned bytes, scanned regions (updated\n"
+                    "             results for updates), matches and throughput\n\n";
+        }
+        inline std::string msg_help_cancel(void)
+        {
+            return  "\n-------------------------------------------------- Command: cancel --------------------------------------------------\n"
+                    "Command: cancel\n"
+                    "Syntax: cancel\n"
+                    "Description: cancels the running scan or update, the matches that have been found so far are kept and\n"
+                    "             the previous results can be restored with \"undo\"\n\n";
+        }
+        inline std::string msg_help_wait(void)
+        {
+            return  "\n--------------------------------------------------- Command: wait ---------------------------------------------------\n"
+                    "Command: wait\n"
+                    "Syntax: wait\n"
+                    "Description: waits until the running scan or update has finished and shows its progress\n\n";
+        }
+        inline std::string msg_help_stats(void)
+        {
+            return  "\n-------------------------------------------------- Command: stats ---------------------------------------------------\n"
+                    "Command: stats\n"
+                    "Syntax: stats [<file name>]\n"
+                    "Description: shows the counters and the time of every phase of the last scan or update: enumerated and\n"
+                    "             skipped regions, read calls, read bytes, failed reads, compared bytes, matches and buffer\n"
+                    "             reallocations, the phases are query, read, compare and push\n"
+                    "Arguments:\n"
+                    "   - <file name>       STRING                  appends the statistics of every following scan or update\n"
+                    "                                               to the file, as one JSON object per line\n"
+                    "Options:\n"
+                    "   - -j or --json                              prints the statistics as JSON object\n"
+                    "   - -c or --close                             stops appending the statistics to the file\n\n";
+        }
+        inline std::string msg_help_trace(void)
+        {
+            return  "\n-------------------------------------------------- Command: trace ---------------------------------------------------\n"
+                    "Command: trace\n"
+                    "Syntax: trace [<file name>]\n"
+                    "Description: writes the begin and end of every region, read, compare and push of the scans and updates,\n"
+                    "             and of the batched reads and writes, with address, bytes and thread as Chrome trace-event\n"
+                    "             JSON, which can be opened with chrome://tracing or Perfetto, the file is overwritten after\n"
+                    "             every command that has recorded events, only if the application has been built with the\n"
+                    "             CMake option MEMORY_TRACE\n"
+                    "Arguments:\n"
+                    "   - <file name>       STRING                  file to write the trace to\n"
+                    "Options:\n"
+                    "   - NO ARGUMENT:                              shows the file the trace is written to\n"
+                    "   - -c or --close                             stops writing the trace\n\n";
+        }
+        inline std::string msg_help_snapshot(void)
+        {
+            return  "\n------------------------------------------------- Command: snapshot -------------------------------------------------\n"
+                    "Command: snapshot\n"
+                    "Syntax: snapshot [<file name>]\n"
+                    "Description: writes all readable memory of the opened process between the start and end address of the\n"
+                    "             configuration to a file, an opened snapshot or ELF core dump is read by search_exact,\n"
+                    "             search_range, read_block, update, update_exact, update_range and dump instead of the\n"
+                    "             process, until it is closed, writes always go to the process\n"
+                    "Arguments:\n"
+                    "   - <file name>       STRING                  file to write the snapshot to\n"
+                    "Options:\n"
+                    "   - NO ARGUMENT:                              shows the opened snapshot\n"
+                    "   - -o or --open                              opens the snapshot or core dump <file name> instead of\n"
+                    "                                               writing it\n"
+                    "   - -c or --close                             closes the opened snapshot or core dump\n\n";
+        }
+        inline std::string msg_help_diff(void)
+        {
+            return  "\n--------------------------------------------------- Command: diff ---------------------------------------------------\n"
+                    "Command: diff\n"
+                    "Syntax: diff <old file> <new file> [<operation> [<value>]]\n"
+                    "Description: compares the memory of two snapshots or core dumps between the start and end address of the\n"
+                    "             configuration, prints the number of changed bytes and the largest ranges of changed bytes and\n"
+                    "             stores all values of the set data-type that have changed with their new value, the stored values\n"
+                    "             belong to the process of the new file\n"
+                    "Arguments:\n"
+                    "   - <old file>        STRING                  older snapshot or core dump\n"
+                    "   - <new file>        STRING                  newer snapshot or core dump\n"
+                    "   - <operation>       STRING                  how the values must have changed, default is changed\n"
+                    "   - <value>           set data-type           the values must have changed by exactly this value,\n"
+                    "                                               only for the operations increased and decreased\n"
+                    "Aviable operations:\n"
+                    "   - changed                                   new != old\n"
+                    "   - increased                                 new > old, or new - old = value\n"
+                    "   - decreased                                 new < old, or old - new = value\n\n";
         }
         inline std::string msg_help_invalid(const std::string& cmd)
         {
@@ -579,6 +753,22 @@ namespace memory
         {
             return "Memory dump has not been started.";
         }
+        inline std::string msg_close_watch(void)
+        {
+            return "Stopped watch.";
+        }
+        inline std::string msg_close_watch_failure(void)
+        {
+            return "Watch has not been started.";
+        }
+        inline std::string msg_close_record(void)
+        {
+            return "Stopped recording.";
+        }
+        inline std::string msg_close_record_failure(void)
+        {
+            return "Recording has not been started.";
+        }
 
         // messaged for command clear
         inline std::string msg_clear_syntax(void) noexcept
@@ -647,22 +837,10 @@ namespace memory
         {
             return "Interrupted scanning! Buffer out of memory.";
         }
-        inline std::string msg_search_sub_start(const std::string& name, pid_t pid, uint32_t i, uint32_t n)
+        inline std::string msg_search_skipped(uint32_t n)
         {
             std::stringstream ss;
-            ss << "Scanning process " << name << " (PID: " << pid << ", " << i << "/" << n << ")...";
-            return ss.str();
-        }
-        inline std::string msg_search_sub_failure(const std::string& name, pid_t pid)
-        {
-            std::stringstream ss;
-            ss << "Failed to scan process " << name << " (PID: " << pid << ")!";
-            return ss.str();
-        }
-        inline std::string msg_search_sub_finish(const std::string& name, pid_t pid, uint64_t count)
-        {
-            std::stringstream ss;
-            ss << "Successfully scanned process " << name << " (PID: " << pid << "), found " << count << " matches.";
+            ss << "Skipped " << n << " processes that could not be opened.";
             return ss.str();
         }
 
@@ -690,6 +868,16 @@ namespace memory
             return ss.str();
         }
 
+        inline std::string msg_write_batch(pid_t pid, uint64_t requests, uint64_t failed, uint64_t bytes, uint64_t calls)
+        {
+            std::stringstream ss;
+            ss << "PID " << pid << ": written " << (requests - failed) << "/" << requests << " values (" << bytes << " bytes) with " << calls << " calls";
+            if (failed > 0)
+                ss << ", " << failed << " values failed";
+            ss << ".";
+            return ss.str();
+        }
+
         // messages for command write_all or wa
         inline std::string msg_wa_syntax(void)
         {
@@ -730,6 +918,41 @@ namespace memory
             return ss.str();
         }
 
+        // messages for command transform
+        inline std::string msg_transform_syntax(void)
+        {
+            return "Syntax: transform <operation> <value> [<value 2>]";
+        }
+        inline std::string msg_transform_invalid(const std::string& op)
+        {
+            std::stringstream ss;
+            ss << "Unknown operation: \"" << op << "\"";
+            return ss.str();
+        }
+        inline std::string msg_transform_string(void)
+        {
+            return "Command transform does not work with strings.";
+        }
+        inline std::string msg_transform_unsupported(const std::string& op)
+        {
+            std::stringstream ss;
+            ss << "Operation \"" << op << "\" is not supported for the set type.";
+            return ss.str();
+        }
+        inline std::string msg_transform_start(void)
+        {
+            return "Transforming memory...";
+        }
+        inline std::string msg_transform_read_batch(pid_t pid, uint64_t requests, uint64_t failed, uint64_t bytes, uint64_t calls)
+        {
+            std::stringstream ss;
+            ss << "PID " << pid << ": read " << (requests - failed) << "/" << requests << " values (" << bytes << " bytes) with " << calls << " calls";
+            if (failed > 0)
+                ss << ", " << failed << " values failed";
+            ss << ".";
+            return ss.str();
+        }
+
         // messages for command category update
         inline std::string msg_update_success(uint64_t count, double time_ms)
         {
@@ -771,17 +994,9 @@ namespace memory
         {
             return "Syntax: show_live | sl <start_entry> <amount> <update speed>";
         }
-        inline std::string msg_sl_print_start(const std::string& path)
-        {
-            return "Printing addresses to file \"" + path + "\"...";
-        }
-        inline std::string msg_sl_print_finish(const std::string& path)
+        inline std::string msg_sl_segment_failure(const std::string& name)
         {
-            return "Successfully printed addresses to file \"" + path + "\".";
-        }
-        inline std::string msg_sl_print_failure(const std::string& path)
-        {
-            return "Failed to print addresses to file \"" + path + "\".";
+            return "Failed to share addresses with live-memory-view (shared memory \"" + name + "\").";
         }
         inline std::string msg_sl_process_success(pid_t pid)
         {
@@ -794,6 +1009,75 @@ namespace memory
             return "Failed to start live-memory-view.";
         }
 
+        // messages for command watch
+        inline std::string msg_watch_syntax(void)
+        {
+            return "Syntax: watch [<start entry> <amount> <interval>]";
+        }
+        inline std::string msg_watch_none(void)
+        {
+            return "No addresses are watched.";
+        }
+        inline std::string msg_watch_skipped(uint64_t count)
+        {
+            std::stringstream ss;
+            ss << count << " addresses cannot be watched, only numeric values are supported.";
+            return ss.str();
+        }
+        inline std::string msg_watch_failure(void)
+        {
+            return "Failed to start watch, no addresses to watch.";
+        }
+        inline std::string msg_watch_start(size_t count, uint32_t interval)
+        {
+            std::stringstream ss;
+            ss << "Watching " << count << " addresses every " << interval << " ms.";
+            return ss.str();
+        }
+        inline std::string msg_watch_status(bool running, uint64_t ticks, uint32_t interval)
+        {
+            std::stringstream ss;
+            ss << "Watch " << (running ? "running" : "stopped") << ", " << ticks << " samples every " << interval << " ms.";
+            return ss.str();
+        }
+
+        // messages for command record
+        inline std::string msg_record_syntax(void)
+        {
+            return "Syntax: record [<start entry> <amount> <rate> <file name>]";
+        }
+        inline std::string msg_record_none(void)
+        {
+            return "No addresses are recorded.";
+        }
+        inline std::string msg_record_rate(void)
+        {
+            return "The rate must be between 1 and 1000000 samples per second.";
+        }
+        inline std::string msg_record_skipped(uint64_t count)
+        {
+            std::stringstream ss;
+            ss << count << " addresses cannot be recorded, only numeric values are supported.";
+            return ss.str();
+        }
+        inline std::string msg_record_failure(const std::string& path)
+        {
+            return "Failed to start recording to file \"" + path + "\".";
+        }
+        inline std::string msg_record_start(size_t count, uint32_t rate, const std::string& path)
+        {
+            std::stringstream ss;
+            ss << "Recording " << count << " addresses with " << rate << " samples per second to file \"" << path << "\".";
+            return ss.str();
+        }
+        inline std::string msg_record_status(bool running, size_t count, uint64_t samples, uint64_t failed, uint64_t chunks, uint64_t raw_bytes, uint64_t file_bytes)
+        {
+            std::stringstream ss;
+            ss << "Recording " << (running ? "running" : "stopped") << ": " << count << " addresses, " << samples << " samples, "
+               << failed << " failed values, " << chunks << " chunks, " << raw_bytes << " bytes sampled, " << file_bytes << " bytes written.";
+            return ss.str();
+        }
+
         // messages for command undo
         inline std::string msg_undo_syntax(void)
         {
@@ -849,12 +1133,286 @@ namespace memory
         }
         inline std::string msg_save_option_conflict(void)
         {
-            return "Conflicting options \"-csv\" and \"-b\" or \"-csv\" and \"--binary\" respectively.";
+            return "Conflicting options, only one of \"-b\" (\"--binary\"), \"-csv\" and \"-j\" (\"--jsonl\") can be used.";
         }
         inline std::string msg_save_file_failure(const std::string& name)
         {
             return std::string("Failed to open file \"") + name + std::string("\"");
         }
+        inline std::string msg_save_write_failure(const std::string& name)
+        {
+            return std::string("Failed to write file \"") + name + std::string("\"");
+        }
+        inline std::string msg_save_success(uint64_t rows, const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Saved " << rows << " entries to \"" << name << "\".";
+            return ss.str();
+        }
+        inline std::string msg_save_compress_conflict(void)
+        {
+            return "Option \"-c\" (\"--compress\") can only be used in combination with \"-b\" (\"--binary\").";
+        }
+
+        // messages for command load
+        inline std::string msg_load_syntax(void)
+        {
+            return "Syntax: load <file name>";
+        }
+        inline std::string msg_load_file_failure(const std::string& name)
+        {
+            return std::string("Failed to open file \"") + name + std::string("\"");
+        }
+        inline std::string msg_load_corrupt(const std::string& name)
+        {
+            return std::string("File \"") + name + std::string("\" is corrupt or not a result file.");
+        }
+        inline std::string msg_load_limit(size_t size, size_t limit)
+        {
+            std::stringstream ss;
+            ss << "The values of the file need " << size << " bytes, but the search limit size is " << limit << " bytes.";
+            return ss.str();
+        }
+        inline std::string msg_load_success(uint64_t count, const std::string& name, double time_ms)
+        {
+            std::stringstream ss;
+            ss << "Loaded " << count << " entries from \"" << name << "\" in " << time_ms << "ms.";
+            return ss.str();
+        }
+
+        // messages for scans and updates in the background
+        inline std::string msg_job_started(const std::string& cmd)
+        {
+            std::stringstream ss;
+            ss << "Command \"" << cmd << "\" is running in the background, use \"status\", \"wait\" or \"cancel\".";
+            return ss.str();
+        }
+        inline std::string msg_job_running(const std::string& cmd)
+        {
+            std::stringstream ss;
+            ss << "Command \"" << cmd << "\" is still running, use \"wait\" or \"cancel\" first.";
+            return ss.str();
+        }
+        inline std::string msg_job_none(void)
+        {
+            return "No scan or update is running.";
+        }
+        inline std::string msg_job_cancelled(const std::string& cmd, uint64_t count)
+        {
+            std::stringstream ss;
+            ss << "Cancelled command \"" << cmd << "\", kept " << count << " matches.";
+            return ss.str();
+        }
+        inline std::string msg_job_status(const std::string& cmd, bool search, double time_s, double bytes, const std::string& bytes_prefix,
+                                          double total, const std::string& total_prefix, uint64_t regions, uint64_t regions_total,
+                                          uint64_t hits, double rate, const std::string& rate_prefix)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2) << cmd << ": " << bytes << bytes_prefix << "/" << total << total_prefix << ", "
+               << regions << "/" << regions_total << (search ? " regions, " : " results, ") << hits << " matches, "
+               << rate << rate_prefix << "/s, " << time_s << "s";
+            return ss.str();
+        }
+
+        // messages for command status
+        inline std::string msg_status_syntax(void)
+        {
+            return "Syntax: status";
+        }
+
+        // messages for command cancel
+        inline std::string msg_cancel_syntax(void)
+        {
+            return "Syntax: cancel";
+        }
+
+        // messages for command wait
+        inline std::string msg_wait_syntax(void)
+        {
+            return "Syntax: wait";
+        }
+
+        // messages for command stats
+        inline std::string msg_stats_syntax(void)
+        {
+            return "Syntax: stats [<file name>]";
+        }
+        inline std::string msg_stats_none(void)
+        {
+            return "No scan or update has finished yet.";
+        }
+        inline std::string msg_stats_header(const std::string& cmd, double time_ms)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(3) << "Statistics of command \"" << cmd << "\" (" << time_ms << "ms):";
+            return ss.str();
+        }
+        inline std::string msg_stats_counter(const std::string& name, uint64_t value)
+        {
+            std::stringstream ss;
+            ss << "    " << std::left << std::setw(20) << name << value;
+            return ss.str();
+        }
+        inline std::string msg_stats_phase(const std::string& name, double time_ms, double percent, double rate, const std::string& rate_prefix)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(3) << "    " << std::left << std::setw(20) << name << time_ms << "ms ("
+               << std::setprecision(1) << percent << "%)";
+            if (rate > 0.0)
+                ss << std::setprecision(2) << ", " << rate << rate_prefix << "/s";
+            return ss.str();
+        }
+        inline std::string msg_stats_log_start(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Appending the statistics of every scan and update to \"" << name << "\".";
+            return ss.str();
+        }
+        inline std::string msg_stats_log_failure(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Failed to open \"" << name << "\".";
+            return ss.str();
+        }
+        inline std::string msg_stats_log_close(void)
+        {
+            return "Stopped appending the statistics.";
+        }
+        inline std::string msg_stats_log_none(void)
+        {
+            return "The statistics are not appended to a file.";
+        }
+
+        // messages for command trace
+        inline std::string msg_trace_syntax(void)
+        {
+            return "Syntax: trace [<file name>]";
+        }
+        inline std::string msg_trace_disabled(void)
+        {
+            return "Tracing is not available, the application has been built without the CMake option MEMORY_TRACE.";
+        }
+        inline std::string msg_trace_start(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Writing the trace of every command to \"" << name << "\".";
+            return ss.str();
+        }
+        inline std::string msg_trace_none(void)
+        {
+            return "No trace is written.";
+        }
+        inline std::string msg_trace_close(void)
+        {
+            return "Stopped writing the trace.";
+        }
+        inline std::string msg_trace_written(size_t events, uint64_t dropped, const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Wrote " << events << " trace events to \"" << name << "\"";
+            if (dropped > 0)
+                ss << ", " << dropped << " events have been dropped";
+            ss << ".";
+            return ss.str();
+        }
+        inline std::string msg_trace_failure(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Failed to write the trace to \"" << name << "\".";
+            return ss.str();
+        }
+
+        // messages for command snapshot
+        inline std::string msg_snapshot_syntax(void)
+        {
+            return "Syntax: snapshot [-o] [<file name>] | snapshot -c";
+        }
+        inline std::string msg_snapshot_start(pid_t pid, const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Writing snapshot of process " << pid << " to \"" << name << "\"...";
+            return ss.str();
+        }
+        inline std::string msg_snapshot_success(uint64_t regions, double bytes, const std::string& bytes_prefix, double failed,
+                                                const std::string& failed_prefix, double time_s, double rate, const std::string& rate_prefix)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2) << "Wrote " << regions << " regions, " << bytes << bytes_prefix << " in " << time_s << "s (" << rate << rate_prefix << "/s)";
+            if (failed > 0.0)
+                ss << ", " << failed << failed_prefix << " could not be read";
+            ss << ".";
+            return ss.str();
+        }
+        inline std::string msg_snapshot_failure(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Failed to write the snapshot to \"" << name << "\".";
+            return ss.str();
+        }
+        inline std::string msg_snapshot_open_failure(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Failed to open \"" << name << "\", the file does not exist or is neither a snapshot nor an ELF core dump.";
+            return ss.str();
+        }
+        inline std::string msg_snapshot_info(const std::string& format, const std::string& name, pid_t pid, const std::string& time, size_t regions,
+                                             double bytes, const std::string& prefix)
+        {
+            std::stringstream ss;
+            ss << "\"" << name << "\" (" << format << "): process " << pid << ", taken " << time << ", " << regions << " regions, " << std::fixed << std::setprecision(2) << bytes << prefix << ".";
+            return ss.str();
+        }
+        inline std::string msg_snapshot_none(void)
+        {
+            return "No snapshot or core dump has been opened.";
+        }
+        inline std::string msg_snapshot_close(const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Closed \"" << name << "\", the memory of the process is read again.";
+            return ss.str();
+        }
+        // messages for command diff
+        inline std::string msg_diff_syntax(void)
+        {
+            return "Syntax: diff <old file> <new file> [<operation> [<value>]]";
+        }
+        inline std::string msg_diff_invalid(const std::string& op)
+        {
+            std::stringstream ss;
+            ss << "Unknown operation: \"" << op << "\"";
+            return ss.str();
+        }
+        inline std::string msg_diff_string(void)
+        {
+            return "Command diff does not work with strings.";
+        }
+        inline std::string msg_diff_start(const std::string& old_name, const std::string& new_name)
+        {
+            std::stringstream ss;
+            ss << "Comparing \"" << old_name << "\" with \"" << new_name << "\"...";
+            return ss.str();
+        }
+        inline std::string msg_diff_report(uint64_t regions, double bytes, const std::string& bytes_prefix, double changed,
+                                           const std::string& changed_prefix, uint64_t runs)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2) << "Compared " << regions << " regions, " << bytes << bytes_prefix << ", "
+               << changed << changed_prefix << " have changed in " << runs << " ranges.";
+            return ss.str();
+        }
+        inline std::string msg_diff_run(address_t begin, size_t size)
+        {
+            std::stringstream ss;
+            ss << "    " << std::hex << begin << " - " << (begin + size) << std::dec << ": " << size << " bytes";
+            return ss.str();
+        }
+        inline std::string msg_search_source(const std::string& format, const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Scanning " << format << " \"" << name << "\"...";
+            return ss.str();
+        }
 
         // messages for number format checks
         inline std::string msg_not_dec(const std::string& arg, uint32_t arg_nr, const std::string& cmd_name)
@@ -869,6 +1427,16 @@ namespace memory
             ss << "Argument " << arg_nr << " of command \"" << cmd_name << "\" is not a hexadecimal number: \"" << arg << "\"";
             return ss.str();
         }
+        inline std::string msg_invalid_value(const std::string& arg, uint32_t arg_nr, const std::string& cmd_name, parse_result_t result)
+        {
+            std::stringstream ss;
+            ss << "Argument " << arg_nr << " of command \"" << cmd_name << "\" ";
+            if (result == MEMORY_PARSE_OUT_OF_RANGE)
+                ss << "is out of range of the set data-type: \"" << arg << "\"";
+            else
+                ss << "is not a valid number: \"" << arg << "\"";
+            return ss.str();
+        }
 
         // messages for something unknown
         inline std::string msg_unknown_command(const std::string& cmd)
@@ -898,5 +1466,87 @@ namespace memory
             ss << "Unknown type: " << type << std::endl;
             return ss.str();
         }
+
+        // messages for script mode
+        inline std::string msg_script_usage(void)
+        {
+            return  "Usage: memory [-s <script file> or --script <script file>] [-m or --machine] [-d <name>=<value> or --define <name>=<value>]\n"
+                    "   - without a script file the commands are read from the console, or from the standard input if it is redirected\n"
+                    "   - a script file \"-\" reads the commands from the standard input\n"
+                    "   - -m or --machine writes one JSON object per command to the standard output, all messages are written to the error output\n"
+                    "   - -d or --define defines a variable that can be used with $<name> in the script\n"
+                    "       memory --serve <name>\n"
+                    "   - serves clients over the named pipe \\\\.\\pipe\\<name> until the application is terminated";
+        }
+        inline std::string msg_script_file_failure(const std::string& name)
+        {
+            return std::string("Failed to open script file \"") + name + std::string("\"");
+        }
+        inline std::string msg_script_read_failure(void)
+        {
+            return "Failed to read the script.";
+        }
+        inline std::string msg_script_undefined(uint64_t line, const std::string& name)
+        {
+            std::stringstream ss;
+            ss << "Line " << line << ": variable \"" << name << "\" is not defined.";
+            return ss.str();
+        }
+        inline std::string msg_script_let_syntax(uint64_t line)
+        {
+            std::stringstream ss;
+            ss << "Line " << line << ": Syntax: let <name> <value>";
+            return ss.str();
+        }
+        inline std::string msg_script_failed(uint64_t line, const std::string& cmd)
+        {
+            std::stringstream ss;
+            ss << "Line " << line << ": command \"" << cmd << "\" has failed, the script is stopped.";
+            return ss.str();
+        }
+
+        // messages for server mode
+        inline std::string msg_server_start(const std::string& name)
+        {
+            return std::string("Serving clients on \\\\.\\pipe\\") + name;
+        }
+        inline std::string msg_server_failure(const std::string& name)
+        {
+            return std::string("Failed to create the pipe \\\\.\\pipe\\") + name + std::string(", is another server already running?");
+        }
+        inline std::string msg_rpc_malformed(uint16_t op)
+        {
+            std::stringstream ss;
+            ss << "Malformed request " << op << ".";
+            return ss.str();
+        }
+        inline std::string msg_rpc_unknown(uint16_t op)
+        {
+            std::stringstream ss;
+            ss << "Unknown request " << op << ".";
+            return ss.str();
+        }
+        inline std::string msg_rpc_job_running(void)
+        {
+            return "Another scan, update or export is running.";
+        }
+        inline std::string msg_rpc_no_job(void)
+        {
+            return "No job is running.";
+        }
+        inline std::string msg_rpc_process_failure(pid_t pid)
+        {
+            std::stringstream ss;
+            ss << "Failed to open process " << pid << ".";
+            return ss.str();
+        }
+        inline std::string msg_rpc_watch_failure(void)
+        {
+            return "Failed to start the watch, the results contain no watchable address or the watch is already running.";
+        }
+        inline std::string msg_rpc_export_failure(const std::string& path)
+        {
+            return std::string("Failed to write the file \"") + path + std::string("\".");
+        }
     }
 }
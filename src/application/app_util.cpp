@@ -12,10 +12,13 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "app.h"
+#include "app_msg.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
 
 using namespace memory::app;
 
@@ -34,6 +37,17 @@ Application::Application(void)
     this->process_table.add_column("Parent PID");
     this->process_table.add_column("Thread count");
 
+    this->watch_table.add_column("PID");
+    this->watch_table.add_column("Address");
+    this->watch_table.add_column("Value");
+    this->watch_table.add_column("Min");
+    this->watch_table.add_column("Max");
+    this->watch_table.add_column("Mean");
+    this->watch_table.add_column("Changes");
+    this->watch_table.add_column("Last change [s]");
+    this->watch_table.add_column("Changes/s");
+    this->watch_table.add_column("Failed");
+
     // init buffers
     this->search_buffer.set_limit(this->cfg.search_limit_size());
     this->undo_buffer.set_limit(this->cfg.search_limit_size());
@@ -41,12 +55,29 @@ Application::Application(void)
 
     // init others
     this->pid_live_memory = this->pid_dump = MEMORY_PID_INVALID;
+    this->published_generation = 0;
+    this->trace_begin = 0;
     this->pid_this = GetCurrentProcessId();
+    this->command_failed = false;
+    this->background = false;
+    this->job.cancel = false;
+    this->job.finished = false;
+    this->job.status = MEMORY_SCAN_DONE;
+    this->job.skipped = 0;
+    this->job.search = false;
+    this->job.active = false;
+    this->last_stats.time_ns = 0;
+    this->last_stats.valid = false;
 }
 
 Application::~Application(void)
 {
-
+    // the job writes into the search buffer, it must not outlive the application
+    if (this->job.active)
+    {
+        this->job.cancel = true;
+        this->job.thread.join();
+    }
 }
 
 
@@ -86,6 +117,20 @@ bool Application::is_input_hex(const std::string& inp)
     return (inp.substr(0, 2) == "0x");
 }
 
+std::string Application::make_error(std::string msg)
+{
+    this->command_failed = true;
+    return make_msg(msg);
+}
+
+bool Application::convert_argument(const Command& cmd, uint32_t arg, size_t size, bool hex, uint8_t* buff)
+{
+    const parse_result_t result = utility::to_bytes(cmd.args().at(arg), size, this->cfg.type(), hex, buff);
+    if (result != MEMORY_PARSE_OK)
+        std::cout << this->make_error(msg_invalid_value(cmd.args().at(arg), arg + 1, cmd.name(), result)) << std::endl;
+    return (result == MEMORY_PARSE_OK);
+}
+
 std::string Application::make_msg(std::string msg)
 {
     using namespace std::chrono;
@@ -102,11 +147,7 @@ void Application::make_search_entry(const Buffer::Element& element, std::vector<
     utility::to_dec_str<pid_t>(element.pid, entry[0]);
     utility::to_hex_str<address_t>(element.address, entry[1]);
     utility::strtype(element.type, entry[2]);
-    {
-        std::stringstream ss;
-        ss << element.size;
-        entry[3] = ss.str();
-    }
+    utility::to_dec_str<size_t>(element.size, entry[3]);
     const uint8_t* value = reinterpret_cast<const uint8_t*>(element.data);
     if (element.type == MEMORY_TYPE_STRING)
     {
@@ -136,211 +177,406 @@ void Application::make_process_entry(const Process& p, std::vector<std::string>&
     utility::to_dec_str(p.count_threads(), entry[3]);
 }
 
-void Application::make_backup(void)
-{
-    this->undo_buffer = std::move(this->search_buffer);
-    this->redo_buffer.clear();
-}
-
-bool Application::is_between(uint8_t* _a, uint8_t* _b, uint8_t* _ref)
+void Application::make_watch_entry(const Watch::Statistics& s, std::vector<std::string>& entry)
 {
-    switch (this->cfg.type())
-    {
-    case MEMORY_TYPE_INT8:
-    {
-        int8_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    case MEMORY_TYPE_UINT8:
-    {
-        uint8_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    case MEMORY_TYPE_INT16:
-    {
-        int16_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    case MEMORY_TYPE_UINT16:
-    {
-        uint16_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    case MEMORY_TYPE_INT32:
+    utility::to_dec_str<pid_t>(s.pid, entry[0]);
+    utility::to_hex_str<address_t>(s.address, entry[1]);
+    if (s.samples > 0)
     {
-        int32_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
+        std::stringstream ss_min, ss_max, ss_mean;
+        ss_min << s.min;
+        ss_max << s.max;
+        ss_mean << s.mean;
+        utility::to_string(s.last, s.size, s.type, false, entry[2]);
+        entry[3] = ss_min.str();
+        entry[4] = ss_max.str();
+        entry[5] = ss_mean.str();
     }
-    case MEMORY_TYPE_UINT32:
+    else
+        entry[2] = entry[3] = entry[4] = entry[5] = "---";
+    utility::to_dec_str<uint64_t>(s.changes, entry[6]);
     {
-        uint32_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
+        std::stringstream ss;
+        if (s.changes > 0)
+            ss << s.last_change / 1000.0;
+        else
+            ss << "---";
+        entry[7] = ss.str();
     }
-    case MEMORY_TYPE_INT64:
     {
-        int64_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
+        std::stringstream ss;
+        ss << s.change_rate;
+        entry[8] = ss.str();
     }
-    case MEMORY_TYPE_UINT64:
+    utility::to_dec_str<uint64_t>(s.failed, entry[9]);
+}
+
+void Application::make_backup(void)
+{
+    this->undo_buffer = std::move(this->search_buffer);
+    this->redo_buffer.clear();
+}
+
+template<typename Fn>
+void Application::start_job(const std::string& command, bool search, Fn fn)
+{
+    this->job.cancel = false;
+    this->job.finished = false;
+    this->job.progress.reset();
+    this->job.command = command;
+    this->job.status = MEMORY_SCAN_DONE;
+    this->job.skipped = 0;
+    this->job.search = search;
+    this->job.start = std::chrono::high_resolution_clock::now();
+    this->job.active = true;
+    if (!this->trace_path.empty())
+        Trace::clear();
+    this->job.thread = std::thread([this, fn]() mutable
     {
-        uint64_t a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    case MEMORY_TYPE_FLOAT:
+        // the worker counts only its own job
+        Stats::reset_thread();
+        this->job.status = fn();
+        Stats::thread_snapshot(this->job.stats);
+        this->job.end = std::chrono::high_resolution_clock::now();
+        this->job.finished = true;
+    });
+
+    // scripts wait for every command, only the interactive prompt returns immediately
+    if (this->background)
+        std::cout << make_msg(msg_job_started(command)) << std::endl;
+    else
+        this->wait_job(false);
+}
+
+void Application::finish_job(void)
+{
+    using namespace std::chrono;
+    if (!this->job.active) return;
+    this->job.thread.join();
+    this->job.active = false;
+    this->search_buffer.shrink_to_fit();
+    this->search_buffer.touch();
+
+    this->last_stats.stats = this->job.stats;
+    this->last_stats.command = this->job.command;
+    this->last_stats.time_ns = duration_cast<nanoseconds>(this->job.end - this->job.start).count();
+    this->last_stats.valid = true;
+    if (this->last_stats.log.is_open())
+        this->last_stats.log << this->stats_json() << std::endl;
+
+    const uint64_t count = this->search_buffer.table().size();
+    if (this->job.skipped > 0)
+        std::cout << make_msg(msg_search_skipped(this->job.skipped)) << std::endl;
+    if (this->job.status == MEMORY_SCAN_LIMIT)
+        std::cout << make_msg(msg_search_interrupt()) << std::endl;
+    else if (this->job.status == MEMORY_SCAN_CANCELLED)
+        std::cout << make_msg(msg_job_cancelled(this->job.command, count)) << std::endl;
+    else if (this->job.search)
+        std::cout << make_msg(msg_search_finish(count, duration_cast<milliseconds>(this->job.end - this->job.start).count() / 1000.0)) << std::endl;
+    else
+        std::cout << make_msg(msg_update_success(count, duration_cast<microseconds>(this->job.end - this->job.start).count() / 1000.0)) << std::endl;
+
+    if (this->job.report)
+        this->job.report();
+    this->job.report = nullptr;
+}
+
+void Application::wait_job(bool show_progress)
+{
+    using namespace std::chrono;
+    if (!this->job.active) return;
+
+    // the status line is overwritten every PROGRESS_INTERVAL milliseconds
+    constexpr milliseconds PROGRESS_INTERVAL(200);
+    time_point<high_resolution_clock> last = high_resolution_clock::now();
+    bool printed = false;
+    while (!this->job.finished)
     {
-        float a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
+        std::this_thread::sleep_for(milliseconds(10));
+        if (show_progress && high_resolution_clock::now() - last >= PROGRESS_INTERVAL)
+        {
+            std::cout << "\r" << make_msg(this->job_status()) << "   " << std::flush;
+            last = high_resolution_clock::now();
+            printed = true;
+        }
     }
-    case MEMORY_TYPE_DOUBLE:
+    if (printed)
+        std::cout << std::endl;
+    this->finish_job();
+}
+
+void Application::print_stats(void) const
+{
+    const Stats::Snapshot& s = this->last_stats.stats;
+    std::cout << make_msg(msg_stats_header(this->last_stats.command, this->last_stats.time_ns / 1e6)) << std::endl;
+    for (uint8_t i = 0; i < MEMORY_STAT_COUNT; i++)
+        std::cout << msg_stats_counter(Stats::name(static_cast<stat_t>(i)), s.counters[i]) << std::endl;
+
+    // the read phase is measured by the read bytes, the compare phase by the compared bytes
+    const uint64_t total_ns = std::max<uint64_t>(this->last_stats.time_ns, 1);
+    for (uint8_t i = 0; i < MEMORY_PHASE_COUNT; i++)
     {
-        double a, b, ref;
-        memcpy(&a, _a, this->cfg.type_size());
-        memcpy(&b, _b, this->cfg.type_size());
-        memcpy(&ref, _ref, this->cfg.type_size());
-        return (ref >= a) && (ref <= b);
-    }
-    default: return false;
+        const uint64_t ns = s.phase_ns[i];
+        uint64_t bytes = 0;
+        if (i == MEMORY_PHASE_READ)     bytes = s.counters[MEMORY_STAT_BYTES_READ];
+        if (i == MEMORY_PHASE_COMPARE)  bytes = s.counters[MEMORY_STAT_BYTES_COMPARED];
+        const uint64_t rate = (ns > 0) ? static_cast<uint64_t>(bytes * 1e9 / ns) : 0;
+
+        std::string rate_prefix;
+        const double rate_si = auto_SI(rate, rate_prefix);
+        std::cout << msg_stats_phase(Stats::name(static_cast<phase_t>(i)), ns / 1e6, 100.0 * ns / total_ns, rate_si, rate_prefix) << std::endl;
     }
+}
 
-    // The return is useless, but some compilers print a warning if the return is not there!
-    return false;
+std::string Application::stats_json(void) const
+{
+    std::string stats;
+    Stats::to_json(this->last_stats.stats, stats);
+    std::stringstream ss;
+    ss << "{\"command\": \"" << this->last_stats.command << "\", \"time_ns\": " << this->last_stats.time_ns << ", \"stats\": " << stats << "}";
+    return ss.str();
 }
 
-uint64_t Application::scan(Process& proc, uint8_t* a, uint8_t* b, size_t size, bool& limit)
+void Application::export_trace(void)
 {
-    if (!proc.is_valid()) return 0;
-    if (a == nullptr || b == nullptr) return 0;
-    bool equal = (memcmp(a, b, size) == 0);
-    limit = false;
-
-    // query memory pages
-    std::vector<MemoryInfo> pages;
-    proc.query(this->cfg.start_address(), this->cfg.end_address(), pages);
-
-    // scan all memory pages
-    address_t cur_addr;
-    size_t rd_size;
-    uint64_t count = 0;
-    const size_t max_rd_size = this->cfg.search_split_size() + size - 1;
-    uint8_t* buff = new uint8_t[max_rd_size];
+    if (this->trace_path.empty() || this->job.active) return;
+    const size_t count = Trace::size(this->trace_begin);
+    if (count == 0) return;
 
-    for (auto page = pages.begin(); page != pages.end() && !limit; page++)
-    {
-        // if memory page is too big, split it
-        for (address_t i = 0; i < page->size && !limit; i += this->cfg.search_split_size())
-        {
-            cur_addr = page->base + i;
-            rd_size = ((page->size - i) < max_rd_size) ? (page->size - i) : max_rd_size; // dont read out of bounds of the page
+    if (Trace::write_json(this->trace_path, this->pid_this, this->trace_begin))
+        std::cout << make_msg(msg_trace_written(count, Trace::dropped(), this->trace_path)) << std::endl;
+    else
+        std::cout << this->make_error(msg_trace_failure(this->trace_path)) << std::endl;
+    Trace::clear();
+}
+
+std::string Application::job_status(void) const
+{
+    using namespace std::chrono;
+    const time_point<high_resolution_clock> now = this->job.finished ? this->job.end : high_resolution_clock::now();
+    const double time_s = duration_cast<milliseconds>(now - this->job.start).count() / 1000.0;
+    const uint64_t bytes = this->job.progress.bytes;
+    const uint64_t rate = (time_s > 0.0) ? static_cast<uint64_t>(bytes / time_s) : 0;
+
+    std::string bytes_prefix, total_prefix, rate_prefix;
+    const double bytes_si = auto_SI(bytes, bytes_prefix);
+    const double total_si = auto_SI(this->job.progress.bytes_total, total_prefix);
+    const double rate_si = auto_SI(rate, rate_prefix);
+    return msg_job_status(this->job.command, this->job.search, time_s, bytes_si, bytes_prefix, total_si, total_prefix,
+                          this->job.progress.regions, this->job.progress.regions_total, this->job.progress.hits, rate_si, rate_prefix);
+}
 
-            // read memory
-            proc.read(cur_addr, rd_size, buff);
+void Application::scan(const std::string& command, std::vector<Process>&& processes, const uint8_t* a, const uint8_t* b, size_t size)
+{
+    // the settings and limits are captured, the configuration may change while the job is running
+    const ScanSettings settings = { this->cfg.type(), size, this->cfg.alignment(), this->cfg.start_address(), this->cfg.end_address(), this->cfg.search_split_size() };
+    std::vector<uint8_t> limits(a, a + size);
+    limits.insert(limits.end(), b, b + size);
 
-            // scan memory for values
-            for (address_t j = 0; j <= (rd_size - size) && !limit; j += this->cfg.alignment())
+    this->start_job(command, true, [this, settings, limits, processes = std::move(processes)]() mutable
+    {
+        scan_status_t status = MEMORY_SCAN_DONE;
+        for (auto proc = processes.begin(); proc != processes.end() && status == MEMORY_SCAN_DONE; proc++)
+        {
+            // must not scan the own process
+            if (proc->pid() == this->pid_this || !proc->open())
             {
-                limit = (this->search_buffer.size() + size) > this->search_buffer.limit();
-                if (!limit && (equal ? (memcmp(a, buff + j, size) == 0) : this->is_between(a, b, buff + j)))
-                {
-                    this->search_buffer.push(proc.pid(), cur_addr + j, size, this->cfg.type(), buff + j);
-                    ++count;
-                }
+                this->job.skipped++;
+                continue;
             }
+            status = Scanner::scan(*proc, settings, limits.data(), limits.data() + settings.size, this->search_buffer, &this->job.progress, &this->job.cancel);
+            proc->close();
         }
-    }
-    delete[] buff;
-    return count;
+        return status;
+    });
 }
 
-uint64_t Application::update(uint8_t* a, uint8_t* b, size_t size)
+void Application::scan_source(const std::string& command, const uint8_t* a, const uint8_t* b, size_t size)
 {
-    if (this->undo_buffer.table().size() == 0) return 0;
-    bool equal = (memcmp(a, b, size) == 0);
+    const ScanSettings settings = { this->cfg.type(), size, this->cfg.alignment(), this->cfg.start_address(), this->cfg.end_address(), this->cfg.search_split_size() };
+    std::vector<uint8_t> limits(a, a + size);
+    limits.insert(limits.end(), b, b + size);
+
+    // the source cannot be closed while the job is running
+    this->start_job(command, true, [this, settings, limits]()
+    {
+        return Scanner::scan(*this->source, settings, limits.data(), limits.data() + settings.size, this->search_buffer, &this->job.progress, &this->job.cancel);
+    });
+}
 
-    // update all saved addresses
+void Application::diff(const std::string& command, std::unique_ptr<MappedSource>&& old_source, std::unique_ptr<MappedSource>&& new_source,
+                       diff_t op, const uint8_t* value)
+{
+    DiffSettings settings = {};
+    settings.scan = { this->cfg.type(), this->cfg.type_size(), this->cfg.alignment(), this->cfg.start_address(), this->cfg.end_address(), this->cfg.search_split_size() };
+    settings.op = op;
+    settings.by_value = (value != nullptr);
+    if (settings.by_value)
+        memcpy(settings.value, value, settings.scan.size);
+
+    // the sources and the report are shared by the job and the function that prints the report,
+    // the sources are closed when the job has finished
+    std::shared_ptr<MappedSource> sources[2] = { std::move(old_source), std::move(new_source) };
+    std::shared_ptr<DiffReport> report = std::make_shared<DiffReport>();
+    this->job.report = [this, report]()
+    {
+        std::string bytes_prefix, changed_prefix;
+        const double bytes = auto_SI(report->bytes, bytes_prefix);
+        const double changed = auto_SI(report->changed_bytes, changed_prefix);
+        std::cout << make_msg(msg_diff_report(report->regions, bytes, bytes_prefix, changed, changed_prefix, report->runs)) << std::endl;
+        for (const DiffRun& run : report->largest)
+            std::cout << msg_diff_run(run.begin, run.size) << std::endl;
+    };
+    this->start_job(command, true, [this, settings, report, old_source = sources[0], new_source = sources[1]]()
+    {
+        return Diff::diff(*old_source, *new_source, settings, this->search_buffer, *report, &this->job.progress, &this->job.cancel);
+    });
+}
+
+void Application::update(const std::string& command, const uint8_t* a, const uint8_t* b, size_t size)
+{
+    const bool reread = (a == nullptr || b == nullptr);
+    const type_t type = this->cfg.type();
+    std::vector<uint8_t> limits;
+    if (!reread)
+    {
+        limits.assign(a, a + size);
+        limits.insert(limits.end(), b, b + size);
+    }
+
+    this->start_job(command, false, [this, reread, type, size, limits]()
+    {
+        const uint8_t* _a = reread ? nullptr : limits.data();
+        const uint8_t* _b = reread ? nullptr : limits.data() + size;
+        return Scanner::filter(this->undo_buffer, type, _a, _b, size, this->search_buffer, &this->job.progress, &this->job.cancel, this->source.get());
+    });
+}
+
+uint64_t Application::write(const uint8_t* x, size_t size, std::vector<IoBatch::Result>& batches)
+{
+    batches.clear();
+    if (this->search_buffer.table().size() == 0) return 0;
+    const std::vector<Buffer::Element>& table = this->search_buffer.table();
+
+    // The value is padded with zeros to the size of the largest element.
+    // Every element uses the first bytes of the padded value, so all requests can share it.
+    size_t max_size = size;
+    for (const Buffer::Element& e : table)
+        max_size = std::max(max_size, e.size);
+    std::vector<uint8_t> padded(max_size, 0);
+    memcpy(padded.data(), x, size);
+
+    // group elements by process, the order within a process stays the same
+    std::vector<size_t> order(table.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&table](size_t a, size_t b) { return table[a].pid < table[b].pid; });
+
+    // write to all saved addresses, one batch per process
+    uint64_t count = 0;
     Process cur_p;
-    for (Buffer::Element& e : this->undo_buffer.table())
+    IoBatch batch;
+    for (size_t i = 0; i < order.size();)
     {
-        // find new process if old pid is different to the current pid
-        if (e.pid != cur_p.pid() || !cur_p.is_valid())
-        {
-            cur_p.close();                  // close old process
-            cur_p.init("", e.pid, 0, 0);    // init current process with stored PID, all other information are irelevent in this context, and is more efficient as Process::find_process
-            if (!cur_p.open()) continue;    // open new process to read data from
-        }
+        const pid_t pid = table[order[i]].pid;
+        for (; i < order.size() && table[order[i]].pid == pid; i++)
+            batch.add(table[order[i]].address, table[order[i]].size, padded.data());
 
-        // read new value from address
-        if (a != nullptr && b != nullptr)
+        cur_p.init("", pid, 0, 0);      // all other information are irelevent in this context, and is more efficient as Process::find_process
+        if (cur_p.open())
         {
-            // update address with new value
-            uint8_t ref[size];
-            cur_p.read(e.address, size, ref);
-            if (equal ? memcmp(a, ref, size) == 0 : is_between(a, b, ref))
-                this->search_buffer.push(e.pid, e.address, size, this->cfg.type(), ref);
+            IoBatch::Result result = batch.write(cur_p);
+            count += result.requests - result.failed;
+            batches.push_back(result);
+            cur_p.close();
         }
         else
+            batches.push_back({ pid, batch.size(), batch.size(), 0, 0 });
+        batch.clear();
+    }
+    return count;
+}
+
+uint64_t Application::write_range(address_t start, address_t end, const uint8_t* x, size_t size, IoBatch::Result& result)
+{
+    result = { this->current_process.pid(), 0, 0, 0, 0 };
+    if (start > end) return 0;
+
+    // If the alignment is larger than the value, the bytes between two values
+    // are merged into the same write and are written back unchanged.
+    const size_t alignment = this->cfg.alignment();
+    const size_t max_gap = (alignment > size) ? (alignment - size) : 0;
+    const uint64_t slots_per_batch = std::max<uint64_t>(IoBatch::MAX_RUN_SIZE / alignment, 1);
+
+    IoBatch batch;
+    uint64_t n = 0;
+    for (address_t a = start; a <= end && a >= start; a += alignment)
+    {
+        batch.add(a, size, x);
+        if (++n == slots_per_batch || a + alignment > end || a + alignment < a)
         {
-            // reread the current value
-            uint8_t ref[e.size];
-            cur_p.read(e.address, e.size, ref);
-            this->search_buffer.push(e.pid, e.address, e.size, e.type, ref);
+            IoBatch::Result sub = batch.write(this->current_process, max_gap);
+            result.requests += sub.requests;
+            result.failed += sub.failed;
+            result.bytes += sub.bytes;
+            result.calls += sub.calls;
+            batch.clear();
+            n = 0;
         }
     }
-
-    cur_p.close();
-    return this->search_buffer.table().size();
+    return result.requests - result.failed;
 }
 
-uint64_t Application::write(uint8_t* x, size_t size)
+uint64_t Application::transform(transform_t op, const uint8_t* a, const uint8_t* b, bool saturate, std::vector<IoBatch::Result>& reads, std::vector<IoBatch::Result>& writes)
 {
-    if (this->search_buffer.table().size() == 0) return 0;
+    reads.clear();
+    writes.clear();
+    std::vector<Buffer::Element>& table = this->search_buffer.table();
+    const size_t size = this->cfg.type_size();
+
+    // only elements of the set type can be transformed, group them by process
+    std::vector<size_t> order;
+    for (size_t i = 0; i < table.size(); i++)
+    {
+        if (table[i].type == this->cfg.type() && table[i].size == size)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&table](size_t x, size_t y) { return table[x].pid < table[y].pid; });
 
-    // write to all saved addresses
     uint64_t count = 0;
     Process cur_p;
-    for (Buffer::Element& e : this->search_buffer.table())
+    std::vector<address_t> addresses;
+    std::vector<uint8_t> values;
+    std::vector<bool> written;
+    for (size_t i = 0; i < order.size();)
     {
-        // find new process if old pid is different to the current pid
-        if (e.pid != cur_p.pid() || !cur_p.is_valid())
+        const pid_t pid = table[order[i]].pid;
+        const size_t first = i;
+        addresses.clear();
+        for (; i < order.size() && table[order[i]].pid == pid; i++)
+            addresses.push_back(table[order[i]].address);
+
+        cur_p.init("", pid, 0, 0);      // all other information are irelevent in this context, and is more efficient as Process::find_process
+        if (!cur_p.open())
         {
-            cur_p.close();                  // close old process
-            cur_p.init("", e.pid, 0, 0);    // init current process with stored PID, all other information are irelevent in this context, and is more efficient as Process::find_process
-            if (!cur_p.open()) continue;    // open new process to read data from
+            reads.push_back({ pid, addresses.size(), addresses.size(), 0, 0 });
+            writes.push_back({ pid, 0, 0, 0, 0 });
+            continue;
         }
 
-        // write to address
-        uint8_t buff[e.size];
-        memset(buff, 0, e.size);
-        memcpy(buff, x, (size > e.size) ? e.size : size);
-        cur_p.write(e.address, e.size, x);
-        ++count;
+        IoBatch::Result read_result, write_result;
+        count += memory::transform(cur_p, addresses, this->cfg.type(), size, op, a, b, saturate, values, written, read_result, write_result);
+        cur_p.close();
+        reads.push_back(read_result);
+        writes.push_back(write_result);
+
+        // the stored values are replaced by the values that have been written
+        for (size_t k = 0; k < addresses.size(); k++)
+        {
+            if (written[k])
+                memcpy(table[order[first + k]].data, values.data() + k * size, size);
+        }
     }
-    cur_p.close();
+    this->search_buffer.touch();
     return count;
 }
@@ -0,0 +1,185 @@
+/**
+* @file     script.cpp
+* @brief    Implementation of the Script-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "script.h"
+#include "app_msg.h"
+#include <chrono>
+#include <iostream>
+
+using namespace memory::app;
+
+namespace
+{
+    inline bool is_name_char(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    /** @brief Appends a quoted JSON string, control characters are escaped. */
+    void append_json(std::string& out, const std::string& str)
+    {
+        constexpr static char table[] = "0123456789ABCDEF";
+        out.push_back('"');
+        for (char ch : str)
+        {
+            const uint8_t c = static_cast<uint8_t>(ch);
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(ch);
+            }
+            else if (c < 0x20)
+            {
+                out += "\\u00";
+                out.push_back(table[c >> 4]);
+                out.push_back(table[c & 0xF]);
+            }
+            else
+                out.push_back(ch);
+        }
+        out.push_back('"');
+    }
+}
+
+Script::Script(Application& app, std::ostream* status) : _app(app)
+{
+    this->_status = status;
+    this->_line = 0;
+    this->_variables["count"] = "0";
+    this->_variables["time"] = "0";
+}
+
+void Script::define(const std::string& name, const std::string& value)
+{
+    this->_variables[name] = value;
+}
+
+bool Script::substitute(const std::string& line, std::string& out, std::string& undefined) const
+{
+    out.clear();
+    for (size_t i = 0; i < line.size();)
+    {
+        if (line[i] != '$')
+        {
+            out.push_back(line[i++]);
+            continue;
+        }
+
+        // "$name" or "${name}"
+        size_t begin = i + 1, end;
+        const bool braces = (begin < line.size() && line[begin] == '{');
+        if (braces)
+        {
+            end = line.find('}', ++begin);
+            if (end == std::string::npos) end = line.size();
+        }
+        else
+        {
+            end = begin;
+            while (end < line.size() && is_name_char(line[end]))
+                end++;
+        }
+
+        const std::string name = line.substr(begin, end - begin);
+        const auto iter = this->_variables.find(name);
+        if (iter == this->_variables.end())
+        {
+            undefined = name;
+            return false;
+        }
+        out += iter->second;
+        i = braces ? end + 1 : end;
+    }
+    return true;
+}
+
+void Script::write_status(const std::string& line, bool failed, double time_ms)
+{
+    if (this->_status == nullptr) return;
+
+    std::string json = "{\"line\":";
+    json += std::to_string(this->_line);
+    json += ",\"command\":";
+    append_json(json, line);
+    json += failed ? ",\"status\":\"error\"" : ",\"status\":\"ok\"";
+    json += ",\"count\":";
+    json += std::to_string(this->_app.result_count());
+    json += ",\"time_ms\":";
+    json += std::to_string(time_ms);
+    json += "}\n";
+
+    // every result is flushed, a reading process sees it immediately
+    this->_status->write(json.data(), json.size());
+    this->_status->flush();
+}
+
+script_exit_t Script::run(std::istream& in)
+{
+    using namespace std::chrono;
+
+    std::string raw, line, undefined;
+    Command cmd;
+    while (std::getline(in, raw))
+    {
+        ++this->_line;
+        if (!raw.empty() && raw.back() == '\r')
+            raw.pop_back();
+
+        // skip empty lines and comments
+        const size_t first = raw.find_first_not_of(" \t");
+        if (first == std::string::npos || raw[first] == '#') continue;
+
+        if (!this->substitute(raw.substr(first), line, undefined))
+        {
+            std::cerr << msg_script_undefined(this->_line, undefined) << std::endl;
+            return MEMORY_SCRIPT_ERROR;
+        }
+
+        // variables are defined by the script, they are no command of the application
+        cmd.phrase(line);
+        if (cmd.name() == "let")
+        {
+            const size_t name_begin = line.find_first_not_of(" \t", 3);
+            const size_t name_end = (name_begin != std::string::npos) ? line.find_first_of(" \t", name_begin) : std::string::npos;
+            const size_t value_begin = (name_end != std::string::npos) ? line.find_first_not_of(" \t", name_end) : std::string::npos;
+            if (value_begin == std::string::npos)
+            {
+                std::cerr << msg_script_let_syntax(this->_line) << std::endl;
+                return MEMORY_SCRIPT_ERROR;
+            }
+            this->define(line.substr(name_begin, name_end - name_begin), line.substr(value_begin));
+            continue;
+        }
+
+        const time_point<high_resolution_clock> t0 = high_resolution_clock::now();
+        const bool running = this->_app.on_command(cmd);
+        const time_point<high_resolution_clock> t1 = high_resolution_clock::now();
+        const double time_ms = duration_cast<microseconds>(t1 - t0).count() / 1000.0;
+
+        this->_variables["count"] = std::to_string(this->_app.result_count());
+        this->_variables["time"] = std::to_string(time_ms);
+        this->write_status(line, this->_app.failed(), time_ms);
+
+        if (this->_app.failed())
+        {
+            std::cerr << msg_script_failed(this->_line, line) << std::endl;
+            return MEMORY_SCRIPT_COMMAND_FAILED;
+        }
+        if (!running) break;
+    }
+
+    if (in.bad())
+    {
+        std::cerr << msg_script_read_failure() << std::endl;
+        return MEMORY_SCRIPT_ERROR;
+    }
+    return MEMORY_SCRIPT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+/**
+* @file     script.h
+* @brief    Definition of the Script-class. Runs commands non-interactively from a file or a pipe.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "app.h"
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+namespace memory
+{
+    namespace app
+    {
+        enum script_exit_t : int
+        {
+            MEMORY_SCRIPT_SUCCESS = 0,
+            MEMORY_SCRIPT_COMMAND_FAILED = 1,   // a command has failed, the following commands are not executed
+            MEMORY_SCRIPT_ERROR = 2             // the script itself is invalid or could not be read
+        };
+
+        /*
+        * Every line of a script is one command, empty lines and lines starting with '#' are skipped.
+        * "$name" or "${name}" is replaced by the value of a variable. After every command the variables
+        * "count" (number of stored addresses) and "time" (duration of the command in ms) are updated,
+        * "let <name> <value>" defines a variable, e.g. "let hits $count".
+        *
+        * In machine mode the messages of the commands are written to the error output and the
+        * standard output only contains one JSON object per executed command.
+        */
+        class Script
+        {
+        private:
+            Application& _app;
+            std::unordered_map<std::string, std::string> _variables;
+            std::ostream* _status;
+            uint64_t _line;
+
+            /**
+            * @brief Replaces the variables of a line.
+            * @param[in] line: line of the script
+            * @param[out] out: line with the values of the variables
+            * @param[out] undefined: name of the first variable that is not defined
+            * @return 'false' if a variable is not defined.
+            */
+            bool substitute(const std::string& line, std::string& out, std::string& undefined) const;
+
+            /** @brief Writes the result of a command as JSON object. */
+            void write_status(const std::string& line, bool failed, double time_ms);
+
+        public:
+            /**
+            * @param[in] app: application that executes the commands
+            * @param[in] status: output of the JSON objects in machine mode or nullptr
+            */
+            Script(Application& app, std::ostream* status);
+            Script(const Script&) = delete;
+            Script& operator= (const Script&) = delete;
+            virtual ~Script(void) = default;
+
+            /**
+            * @brief Defines a variable.
+            * @param[in] name: name of the variable
+            * @param[in] value: value of the variable
+            */
+            void define(const std::string& name, const std::string& value);
+
+            /**
+            * @brief Runs all commands until the end of the input, the first failed command or "exit".
+            * @param[in] in: input of the commands
+            * @return Exit code of the program.
+            */
+            script_exit_t run(std::istream& in);
+        };
+    }
+}
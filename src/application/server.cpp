@@ -0,0 +1,744 @@
+/**
+* @file     server.cpp
+* @brief    Implementation of the Server-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "server.h"
+#include "app_msg.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace memory;
+using namespace memory::app;
+using namespace memory::rpc;
+
+namespace
+{
+    constexpr size_t MAX_WRITE = 0x1000000;    // bytes that are written at once to a client
+
+    inline uint64_t now_ms(void) noexcept
+    {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** @return Size of a value of the type, 0 for strings and invalid types. */
+    size_t value_size(type_t type) noexcept
+    {
+        switch (type)
+        {
+        case MEMORY_TYPE_INT8:
+        case MEMORY_TYPE_UINT8:     return 1;
+        case MEMORY_TYPE_INT16:
+        case MEMORY_TYPE_UINT16:    return 2;
+        case MEMORY_TYPE_INT32:
+        case MEMORY_TYPE_UINT32:
+        case MEMORY_TYPE_FLOAT:     return 4;
+        case MEMORY_TYPE_INT64:
+        case MEMORY_TYPE_UINT64:
+        case MEMORY_TYPE_DOUBLE:    return 8;
+        default:                    return 0;
+        }
+    }
+
+    /** @return 'true' if the values of a request have a valid type and size. */
+    inline bool valid_value(uint8_t type, uint32_t size) noexcept
+    {
+        if (type == MEMORY_TYPE_STRING) return size > 0 && size <= MAX_PAYLOAD;
+        return size > 0 && value_size(static_cast<type_t>(type)) == size;
+    }
+}
+
+Server::Server(void)
+{
+    this->_listen_pipe = MEMORY_INVALID_HANDLE;
+    this->_connect_event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    this->_job_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    memset(&this->_connect_ov, 0, sizeof(OVERLAPPED));
+    this->_results = std::make_shared<const Buffer>();
+    this->_job.owner = nullptr;
+    this->_job.id = 0;
+    this->_job.cancel = false;
+    this->_job.status = MEMORY_SCAN_DONE;
+    this->_job.count = 0;
+    this->_job.running = false;
+    this->_pid_this = GetCurrentProcessId();
+}
+
+Server::~Server(void)
+{
+    if (this->_job.running)
+    {
+        this->_job.cancel = true;
+        this->_job.thread.join();
+    }
+    this->_watch.clear();
+
+    // the completion routines of cancelled reads and writes must run before the clients are deleted
+    for (std::unique_ptr<Client>& client : this->_clients)
+        this->disconnect(*client);
+    while (!this->_clients.empty())
+    {
+        SleepEx(PROGRESS_INTERVAL, TRUE);
+        this->reap();
+    }
+
+    if (this->_listen_pipe != MEMORY_INVALID_HANDLE)
+    {
+        CancelIo(this->_listen_pipe);
+        CloseHandle(this->_listen_pipe);
+    }
+    CloseHandle(this->_connect_event);
+    CloseHandle(this->_job_event);
+}
+
+bool Server::run(const std::string& name)
+{
+    this->_name = std::string(PIPE_PREFIX) + name;
+    if (!this->listen(true)) return false;
+
+    const HANDLE events[2] = { this->_connect_event, this->_job_event };
+    uint64_t last_progress = 0;
+    while (true)
+    {
+        // completion routines of the clients run while waiting
+        const DWORD result = WaitForMultipleObjectsEx(2, events, FALSE, this->_job.running ? PROGRESS_INTERVAL : INFINITE, TRUE);
+        if (result == WAIT_OBJECT_0)
+        {
+            this->accept();
+            if (!this->listen(false)) return false;
+        }
+        else if (result == WAIT_OBJECT_0 + 1)
+            this->finish_job();
+        else if (result == WAIT_FAILED)
+            return false;
+
+        if (this->_job.running && now_ms() - last_progress >= PROGRESS_INTERVAL)
+        {
+            this->send_progress();
+            last_progress = now_ms();
+        }
+        this->reap();
+    }
+}
+
+bool Server::listen(bool first)
+{
+    const DWORD open_mode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+    const DWORD pipe_mode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS;
+    this->_listen_pipe = CreateNamedPipe(this->_name.c_str(), open_mode, pipe_mode, PIPE_UNLIMITED_INSTANCES,
+                                         PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+    if (this->_listen_pipe == MEMORY_INVALID_HANDLE) return false;
+
+    memset(&this->_connect_ov, 0, sizeof(OVERLAPPED));
+    this->_connect_ov.hEvent = this->_connect_event;
+    ResetEvent(this->_connect_event);
+    if (!ConnectNamedPipe(this->_listen_pipe, &this->_connect_ov))
+    {
+        switch (GetLastError())
+        {
+        case ERROR_IO_PENDING:
+            break;
+        case ERROR_PIPE_CONNECTED:      // the client has connected between creating and connecting the pipe
+            SetEvent(this->_connect_event);
+            break;
+        default:
+            CloseHandle(this->_listen_pipe);
+            this->_listen_pipe = MEMORY_INVALID_HANDLE;
+            return false;
+        }
+    }
+    return true;
+}
+
+void Server::accept(void)
+{
+    DWORD bytes;
+    const HANDLE pipe = this->_listen_pipe;
+    this->_listen_pipe = MEMORY_INVALID_HANDLE;
+    if (!GetOverlappedResult(pipe, &this->_connect_ov, &bytes, FALSE))
+    {
+        CloseHandle(pipe);
+        return;
+    }
+
+    std::unique_ptr<Client> client = std::make_unique<Client>();
+    memset(&client->read_ov, 0, sizeof(OVERLAPPED));
+    memset(&client->write_ov, 0, sizeof(OVERLAPPED));
+    client->read_ov.hEvent = client->write_ov.hEvent = client.get();
+    client->server = this;
+    client->pipe = pipe;
+    client->in_used = 0;
+    client->out_offset = 0;
+    client->reading = client->writing = client->broken = false;
+    this->start_read(*client);
+    this->_clients.push_back(std::move(client));
+}
+
+void Server::reap(void)
+{
+    for (auto iter = this->_clients.begin(); iter != this->_clients.end();)
+    {
+        Client& client = **iter;
+        if (client.broken && !client.reading && !client.writing)
+        {
+            if (this->_job.owner == &client)
+                this->_job.owner = nullptr;    // the job continues, its results are still stored
+            DisconnectNamedPipe(client.pipe);
+            CloseHandle(client.pipe);
+            iter = this->_clients.erase(iter);
+        }
+        else
+            ++iter;
+    }
+}
+
+void CALLBACK Server::on_read(DWORD error, DWORD bytes, LPOVERLAPPED ov)
+{
+    Client& client = *static_cast<Client*>(ov->hEvent);
+    client.reading = false;
+    if (error != ERROR_SUCCESS || bytes == 0)
+    {
+        client.server->disconnect(client);
+        return;
+    }
+    client.in_used += bytes;
+    client.server->handle_input(client);
+    client.server->start_read(client);
+}
+
+void CALLBACK Server::on_write(DWORD error, DWORD bytes, LPOVERLAPPED ov)
+{
+    Client& client = *static_cast<Client*>(ov->hEvent);
+    client.writing = false;
+    if (error != ERROR_SUCCESS)
+    {
+        client.server->disconnect(client);
+        return;
+    }
+    client.out_offset += bytes;
+    if (client.out_offset >= client.out.front().size)
+    {
+        client.out.pop_front();    // releases the results if it was the last page that referenced them
+        client.out_offset = 0;
+    }
+    client.server->start_write(client);
+}
+
+void Server::start_read(Client& client)
+{
+    if (client.broken || client.reading) return;
+    if (client.in.size() < client.in_used + READ_SIZE)
+        client.in.resize(client.in_used + READ_SIZE);
+    if (ReadFileEx(client.pipe, client.in.data() + client.in_used, READ_SIZE, &client.read_ov, on_read))
+        client.reading = true;
+    else
+        this->disconnect(client);
+}
+
+void Server::start_write(Client& client)
+{
+    if (client.broken || client.writing || client.out.empty()) return;
+    const Segment& segment = client.out.front();
+    const size_t size = std::min(segment.size - client.out_offset, MAX_WRITE);
+    if (WriteFileEx(client.pipe, segment.p + client.out_offset, static_cast<DWORD>(size), &client.write_ov, on_write))
+        client.writing = true;
+    else
+        this->disconnect(client);
+}
+
+void Server::disconnect(Client& client)
+{
+    if (client.broken) return;
+    client.broken = true;
+    CancelIo(client.pipe);    // pending reads and writes complete with an error, their buffers are released by 'reap'
+}
+
+void Server::handle_input(Client& client)
+{
+    size_t pos = 0;
+    while (!client.broken && client.in_used - pos >= sizeof(FrameHeader))
+    {
+        FrameHeader header;
+        memcpy(&header, client.in.data() + pos, sizeof(FrameHeader));
+        if (header.size > MAX_PAYLOAD)
+        {
+            this->disconnect(client);
+            return;
+        }
+        if (client.in_used - pos - sizeof(FrameHeader) < header.size) break;    // the frame is incomplete
+
+        this->on_request(client, header, client.in.data() + pos + sizeof(FrameHeader));
+        pos += sizeof(FrameHeader) + header.size;
+    }
+
+    // move the incomplete frame to the beginning of the buffer
+    memmove(client.in.data(), client.in.data() + pos, client.in_used - pos);
+    client.in_used -= pos;
+}
+
+void Server::send(Client& client)
+{
+    if (client.broken) return;
+    client.out.push_back(Segment{ std::move(this->_frame), nullptr, nullptr, 0 });
+    Segment& segment = client.out.back();
+    segment.p = segment.data.data();
+    segment.size = segment.data.size();
+    this->start_write(client);
+}
+
+void Server::send_reply(Client& client, uint32_t id)
+{
+    Writer out(this->_frame, MEMORY_RPC_REPLY, id);
+    out.finish();
+    this->send(client);
+}
+
+void Server::send_error(Client& client, uint32_t id, const std::string& msg)
+{
+    Writer out(this->_frame, MEMORY_RPC_ERROR, id);
+    out.put_string(msg);
+    out.finish();
+    this->send(client);
+}
+
+void Server::send_progress(void)
+{
+    if (this->_job.owner == nullptr) return;
+    const ScanProgress& progress = this->_job.progress;
+    Writer out(this->_frame, MEMORY_RPC_PROGRESS, this->_job.id);
+    out.put<uint64_t>(progress.bytes_total);
+    out.put<uint64_t>(progress.bytes);
+    out.put<uint64_t>(progress.regions_total);
+    out.put<uint64_t>(progress.regions);
+    out.put<uint64_t>(progress.hits);
+    out.finish();
+    this->send(*this->_job.owner);
+}
+
+template<typename Fn>
+void Server::start_job(Client& owner, uint32_t id, std::shared_ptr<Buffer> out, Fn fn)
+{
+    this->_job.owner = &owner;
+    this->_job.id = id;
+    this->_job.out = std::move(out);
+    this->_job.cancel = false;
+    this->_job.progress.reset();
+    this->_job.status = MEMORY_SCAN_DONE;
+    this->_job.count = 0;
+    this->_job.error.clear();
+    this->_job.running = true;
+    this->_job.thread = std::thread([this, fn](void) {
+        this->_job.status = fn();
+        SetEvent(this->_job_event);
+    });
+}
+
+void Server::finish_job(void)
+{
+    this->_job.thread.join();
+    this->_job.running = false;
+
+    // a cancelled job does not change the stored results
+    if (this->_job.out != nullptr && this->_job.status != MEMORY_SCAN_CANCELLED && this->_job.error.empty())
+        this->_results = this->_job.out;
+    this->_job.out.reset();
+
+    if (this->_job.owner != nullptr)
+    {
+        if (!this->_job.error.empty())
+            this->send_error(*this->_job.owner, this->_job.id, this->_job.error);
+        else
+        {
+            this->send_progress();
+            Writer out(this->_frame, MEMORY_RPC_DONE, this->_job.id);
+            out.put<uint8_t>(this->_job.status);
+            out.put<uint64_t>(this->_job.count);
+            out.finish();
+            this->send(*this->_job.owner);
+        }
+    }
+    this->_job.owner = nullptr;
+}
+
+void Server::on_request(Client& client, const FrameHeader& header, const uint8_t* payload)
+{
+    Reader in(payload, header.size);
+    switch (header.op)
+    {
+    case MEMORY_RPC_SCAN:       this->req_scan(client, header.id, in);      break;
+    case MEMORY_RPC_UPDATE:     this->req_update(client, header.id, in);    break;
+    case MEMORY_RPC_READ:       this->req_read(client, header.id, in);      break;
+    case MEMORY_RPC_WRITE:      this->req_write(client, header.id, in);     break;
+    case MEMORY_RPC_WATCH:      this->req_watch(client, header.id, in);     break;
+    case MEMORY_RPC_RESULTS:    this->req_results(client, header.id, in);   break;
+    case MEMORY_RPC_EXPORT:     this->req_export(client, header.id, in);    break;
+    case MEMORY_RPC_CANCEL:     this->req_cancel(client, header.id, in);    break;
+    default:                    this->send_error(client, header.id, msg_rpc_unknown(header.op)); break;
+    }
+}
+
+void Server::req_scan(Client& client, uint32_t id, Reader& in)
+{
+    uint8_t type = 0;
+    uint32_t size = 0, n = 0;
+    uint16_t alignment = 0;
+    uint64_t begin = 0, end = 0;
+    in.get(type);
+    in.get(size);
+    in.get(alignment);
+    in.get(begin);
+    in.get(end);
+    in.get(n);
+    std::vector<pid_t> pids;
+    for (uint32_t i = 0, pid = 0; i < n && in.get(pid); i++)
+        pids.push_back(pid);
+    const uint8_t* a = in.get_bytes(size);
+    const uint8_t* b = in.get_bytes(size);
+    if (!in.ok() || in.remaining() != 0 || pids.size() != n || !valid_value(type, size) || begin >= end)
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_SCAN));
+        return;
+    }
+    if (this->_job.running)
+    {
+        this->send_error(client, id, msg_rpc_job_running());
+        return;
+    }
+
+    // without PIDs all accessable processes are scanned, except the own process
+    std::vector<Process> processes;
+    if (pids.empty())
+    {
+        Process::enum_processes(true, processes);
+        processes.erase(std::remove_if(processes.begin(), processes.end(), [this](const Process& p) { return p.pid() == this->_pid_this; }), processes.end());
+    }
+    for (pid_t pid : pids)
+    {
+        processes.emplace_back();
+        processes.back().init("", pid, 0, 0);    // all other information are irelevent in this context
+    }
+
+    const ScanSettings settings = { static_cast<type_t>(type), size, std::max<uint16_t>(alignment, 1), begin, end, this->_cfg.search_split_size() };
+    const std::shared_ptr<std::vector<uint8_t>> values = std::make_shared<std::vector<uint8_t>>(a, a + size);
+    values->insert(values->end(), b, b + size);
+    const std::shared_ptr<std::vector<Process>> procs = std::make_shared<std::vector<Process>>(std::move(processes));
+    std::shared_ptr<Buffer> out = std::make_shared<Buffer>(this->_cfg.search_limit_size(), this->_cfg.search_limit_size());
+
+    this->send_reply(client, id);
+    this->start_job(client, id, out, [this, settings, values, procs, out](void) {
+        scan_status_t status = MEMORY_SCAN_DONE;
+        for (auto proc = procs->begin(); proc != procs->end() && status == MEMORY_SCAN_DONE; proc++)
+        {
+            if (!proc->open()) continue;
+            status = Scanner::scan(*proc, settings, values->data(), values->data() + settings.size, *out, &this->_job.progress, &this->_job.cancel);
+            proc->close();
+        }
+        out->shrink_to_fit();
+        this->_job.count = out->table().size();
+        return status;
+    });
+}
+
+void Server::req_update(Client& client, uint32_t id, Reader& in)
+{
+    uint8_t filter = 0, type = 0;
+    uint32_t size = 0;
+    in.get(filter);
+    in.get(type);
+    in.get(size);
+    const uint8_t* a = in.get_bytes(size);
+    const uint8_t* b = in.get_bytes(size);
+    if (!in.ok() || in.remaining() != 0 || (filter != 0 && !valid_value(type, size)))
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_UPDATE));
+        return;
+    }
+    if (this->_job.running)
+    {
+        this->send_error(client, id, msg_rpc_job_running());
+        return;
+    }
+
+    // the job works on the current results, a scan that finishes later can replace them safely
+    const std::shared_ptr<const Buffer> results = this->_results;
+    const std::shared_ptr<std::vector<uint8_t>> values = std::make_shared<std::vector<uint8_t>>(a, a + size);
+    values->insert(values->end(), b, b + size);
+    std::shared_ptr<Buffer> out = std::make_shared<Buffer>(this->_cfg.search_limit_size(), this->_cfg.search_limit_size());
+
+    this->send_reply(client, id);
+    this->start_job(client, id, out, [this, filter, type, size, results, values, out](void) {
+        const uint8_t* a = (filter != 0) ? values->data() : nullptr;
+        const uint8_t* b = (filter != 0) ? values->data() + size : nullptr;
+        const scan_status_t status = Scanner::filter(*results, static_cast<type_t>(type), a, b, size, *out, &this->_job.progress, &this->_job.cancel);
+        out->shrink_to_fit();
+        this->_job.count = out->table().size();
+        return status;
+    });
+}
+
+void Server::req_read(Client& client, uint32_t id, Reader& in)
+{
+    uint32_t pid = 0, size = 0;
+    uint64_t address = 0;
+    in.get(pid);
+    in.get(address);
+    in.get(size);
+    if (!in.ok() || in.remaining() != 0 || size > MAX_PAYLOAD - sizeof(uint32_t))
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_READ));
+        return;
+    }
+
+    Process proc;
+    proc.init("", pid, 0, 0);
+    if (!proc.open())
+    {
+        this->send_error(client, id, msg_rpc_process_failure(pid));
+        return;
+    }
+
+    // the value is read directly into the frame
+    Writer out(this->_frame, MEMORY_RPC_REPLY, id);
+    out.put<uint32_t>(0);
+    const size_t offset = this->_frame.size();
+    this->_frame.resize(offset + size);
+    const uint32_t n = static_cast<uint32_t>(proc.read(address, size, this->_frame.data() + offset));
+    this->_frame.resize(offset + n);
+    memcpy(this->_frame.data() + offset - sizeof(uint32_t), &n, sizeof(uint32_t));
+    out.finish();
+    this->send(client);
+}
+
+void Server::req_write(Client& client, uint32_t id, Reader& in)
+{
+    uint32_t pid = 0, size = 0;
+    uint64_t address = 0;
+    in.get(pid);
+    in.get(address);
+    in.get(size);
+    const uint8_t* data = in.get_bytes(size);
+    if (!in.ok() || in.remaining() != 0)
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_WRITE));
+        return;
+    }
+
+    Process proc;
+    proc.init("", pid, 0, 0);
+    if (!proc.open())
+    {
+        this->send_error(client, id, msg_rpc_process_failure(pid));
+        return;
+    }
+
+    Writer out(this->_frame, MEMORY_RPC_REPLY, id);
+    out.put<uint32_t>(static_cast<uint32_t>(proc.write(address, size, data)));
+    out.finish();
+    this->send(client);
+}
+
+void Server::req_watch(Client& client, uint32_t id, Reader& in)
+{
+    uint8_t action = 0;
+    uint32_t interval = 0, max_count = 0;
+    in.get(action);
+    if (action == MEMORY_RPC_WATCH_START)
+    {
+        in.get(interval);
+        in.get(max_count);
+    }
+    if (!in.ok() || in.remaining() != 0 || action > MEMORY_RPC_WATCH_STATISTICS)
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_WATCH));
+        return;
+    }
+
+    Writer out(this->_frame, MEMORY_RPC_REPLY, id);
+    switch (action)
+    {
+    case MEMORY_RPC_WATCH_START:
+    {
+        // the first 'max_count' results are watched, strings and values larger than 8 bytes are skipped
+        this->_watch.clear();
+        uint32_t added = 0;
+        for (const Buffer::Element& e : this->_results->table())
+        {
+            if (added >= max_count) break;
+            if (e.type != MEMORY_TYPE_STRING && e.size <= Watch::VALUE_SIZE && this->_watch.add(e.pid, e.address, e.type, e.size))
+                ++added;
+        }
+        if (!this->_watch.start(std::max<uint32_t>(interval, 1)))
+        {
+            this->send_error(client, id, msg_rpc_watch_failure());
+            return;
+        }
+        out.put<uint32_t>(added);
+        break;
+    }
+    case MEMORY_RPC_WATCH_STOP:
+        this->_watch.stop();
+        break;
+    case MEMORY_RPC_WATCH_STATISTICS:
+    {
+        std::vector<Watch::Statistics> stats;
+        this->_watch.statistics(stats);
+        out.put<uint32_t>(static_cast<uint32_t>(stats.size()));
+        for (const Watch::Statistics& s : stats)
+        {
+            WatchRecord record;
+            record.pid = s.pid;
+            record.address = s.address;
+            record.type = s.type;
+            record.size = static_cast<uint8_t>(s.size);
+            memcpy(record.last, s.last, sizeof(record.last));
+            record.min = s.min;
+            record.max = s.max;
+            record.mean = s.mean;
+            record.samples = s.samples;
+            record.failed = s.failed;
+            record.changes = s.changes;
+            record.change_rate = s.change_rate;
+            out.put(&record, sizeof(WatchRecord));
+        }
+        break;
+    }
+    }
+    out.finish();
+    this->send(client);
+}
+
+void Server::req_results(Client& client, uint32_t id, Reader& in)
+{
+    uint64_t first = 0;
+    uint32_t count = 0;
+    in.get(first);
+    in.get(count);
+    if (!in.ok() || in.remaining() != 0)
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_RESULTS));
+        return;
+    }
+
+    // the page is limited by the number of results and the size of its values
+    const std::shared_ptr<const Buffer> results = this->_results;
+    const std::vector<Buffer::Element>& table = results->table();
+    first = std::min<uint64_t>(first, table.size());
+    const size_t last_max = first + std::min<uint64_t>(std::min<uint32_t>(count, MAX_PAGE), table.size() - first);
+    size_t last = first, value_bytes = 0;
+    for (; last < last_max && value_bytes + table[last].size + (last + 1 - first) * sizeof(ResultRecord) < MAX_PAYLOAD; last++)
+        value_bytes += table[last].size;
+
+    Writer out(this->_frame, MEMORY_RPC_REPLY, id);
+    out.put<uint64_t>(table.size());
+    out.put<uint32_t>(static_cast<uint32_t>(last - first));
+    for (size_t i = first; i < last; i++)
+    {
+        const ResultRecord record = { static_cast<uint32_t>(table[i].pid), table[i].address, static_cast<uint32_t>(table[i].size), table[i].type };
+        out.put(&record, sizeof(ResultRecord));
+    }
+    if (value_bytes == 0)
+    {
+        out.finish();
+        this->send(client);
+        return;
+    }
+
+    // The values of consecutive results are stored consecutively in the buffer. Then they are written
+    // without a copy and the page keeps the results alive, even if they are replaced in the meantime.
+    const uint8_t* values = static_cast<const uint8_t*>(table[first].data);
+    const uint8_t* values_end = static_cast<const uint8_t*>(table[last - 1].data) + table[last - 1].size;
+    out.finish(value_bytes);
+    this->send(client);
+    if (client.broken) return;
+    if (static_cast<size_t>(values_end - values) == value_bytes)
+        client.out.push_back(Segment{ {}, results, values, value_bytes });
+    else
+    {
+        std::vector<uint8_t> copy;
+        copy.reserve(value_bytes);
+        for (size_t i = first; i < last; i++)
+            copy.insert(copy.end(), static_cast<const uint8_t*>(table[i].data), static_cast<const uint8_t*>(table[i].data) + table[i].size);
+        client.out.push_back(Segment{ std::move(copy), nullptr, nullptr, value_bytes });
+        client.out.back().p = client.out.back().data.data();
+    }
+    this->start_write(client);
+}
+
+void Server::req_export(Client& client, uint32_t id, Reader& in)
+{
+    uint8_t format = 0;
+    std::string path;
+    in.get(format);
+    in.get_string(path);
+    if (!in.ok() || in.remaining() != 0 || path.empty() || (format > MEMORY_EXPORT_JSONL && format != EXPORT_BINARY))
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_EXPORT));
+        return;
+    }
+    if (this->_job.running)
+    {
+        this->send_error(client, id, msg_rpc_job_running());
+        return;
+    }
+
+    const std::shared_ptr<const Buffer> stored = this->_results;
+    this->send_reply(client, id);
+    this->start_job(client, id, nullptr, [this, format, path, stored](void) {
+        const std::vector<Buffer::Element>& table = stored->table();
+        this->_job.progress.regions_total = table.size();
+        if (format == EXPORT_BINARY)
+        {
+            if (results::write(path, *stored, 0, table.size(), false))
+                this->_job.count = table.size();
+            else
+                this->_job.error = msg_rpc_export_failure(path);
+            return MEMORY_SCAN_DONE;
+        }
+
+        Exporter exporter;
+        if (!exporter.open(path, static_cast<export_format_t>(format)))
+        {
+            this->_job.error = msg_rpc_export_failure(path);
+            return MEMORY_SCAN_DONE;
+        }
+        for (const Buffer::Element& e : table)
+        {
+            if (this->_job.cancel) break;
+            if (format != MEMORY_EXPORT_TEXT && !exporter.has_modules(e.pid))
+            {
+                std::vector<ModuleInfo> modules;
+                Process::enum_modules(e.pid, modules);
+                exporter.add_modules(e.pid, std::move(modules));
+            }
+            exporter.write(e);
+            ++this->_job.progress.regions;
+        }
+        if (!exporter.close())
+            this->_job.error = msg_rpc_export_failure(path);
+        this->_job.count = exporter.rows();
+        return this->_job.cancel ? MEMORY_SCAN_CANCELLED : MEMORY_SCAN_DONE;
+    });
+}
+
+void Server::req_cancel(Client& client, uint32_t id, Reader& in)
+{
+    if (in.remaining() != 0)
+    {
+        this->send_error(client, id, msg_rpc_malformed(MEMORY_RPC_CANCEL));
+        return;
+    }
+    if (!this->_job.running)
+    {
+        this->send_error(client, id, msg_rpc_no_job());
+        return;
+    }
+    this->_job.cancel = true;    // the job sends its DONE event when it has stopped
+    this->send_reply(client, id);
+}
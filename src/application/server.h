@@ -0,0 +1,149 @@
+/**
+* @file     server.h
+* @brief    Definition of the Server-class. Serves clients over a named pipe with the protocol of rpc.h.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "../memory/memory.h"
+#include "config.h"
+#include <deque>
+#include <list>
+#include <memory>
+#include <thread>
+
+namespace memory
+{
+    namespace app
+    {
+        /*
+        * All clients are served by one thread: reads and writes are started with ReadFileEx / WriteFileEx
+        * and their completion routines run while the server waits alertably for a new client or the end of a job.
+        * Scans, updates and exports run as job on a worker thread, at most one job runs at once.
+        * All clients share the stored results, a finished scan or update replaces them. Pages of results are
+        * written directly out of the result buffer, which is kept alive until the write has completed.
+        */
+        class Server
+        {
+        public:
+            constexpr static DWORD PIPE_BUFFER_SIZE     = 0x10000;      // 64KB
+            constexpr static size_t READ_SIZE           = 0x10000;      // bytes that are read at once from a client
+            constexpr static DWORD PROGRESS_INTERVAL    = 100;          // milliseconds between two progress events
+
+        private:
+            struct Segment
+            {
+                std::vector<uint8_t> data;                  // owned data, used if 'keep' is nullptr
+                std::shared_ptr<const Buffer> keep;         // keeps the results alive that are written without a copy
+                const uint8_t* p;
+                size_t size;
+            };
+
+            struct Client
+            {
+                OVERLAPPED read_ov, write_ov;               // hEvent is not used by completion routines, it points to the client
+                Server* server;
+                HANDLE pipe;
+                std::vector<uint8_t> in;
+                size_t in_used;
+                std::deque<Segment> out;
+                size_t out_offset;                          // written bytes of the first segment
+                bool reading, writing, broken;
+            };
+
+            struct Job
+            {
+                std::thread thread;
+                Client* owner;                              // nullptr if the client has disconnected
+                uint32_t id;
+                std::shared_ptr<Buffer> out;                // new results or nullptr if the job does not change the results
+                std::atomic_bool cancel;
+                ScanProgress progress;
+                scan_status_t status;
+                uint64_t count;
+                std::string error;                          // sent instead of the DONE event if it is not empty
+                bool running;
+            };
+
+            Config _cfg;
+            std::string _name;
+            HANDLE _listen_pipe, _connect_event, _job_event;
+            OVERLAPPED _connect_ov;
+            std::list<std::unique_ptr<Client>> _clients;
+            std::shared_ptr<const Buffer> _results;
+            Job _job;
+            Watch _watch;
+            pid_t _pid_this;
+            std::vector<uint8_t> _frame;
+
+            /**
+            * @brief Creates the next pipe instance and waits for a client to connect.
+            * @param[in] first: the first instance fails if another server uses the same name
+            */
+            bool listen(bool first);
+
+            /** @brief Adds the connected client of the listening pipe. */
+            void accept(void);
+
+            /** @brief Removes disconnected clients that have no pending read or write. */
+            void reap(void);
+
+            static void CALLBACK on_read(DWORD error, DWORD bytes, LPOVERLAPPED ov);
+            static void CALLBACK on_write(DWORD error, DWORD bytes, LPOVERLAPPED ov);
+            void start_read(Client& client);
+            void start_write(Client& client);
+            void disconnect(Client& client);
+
+            /** @brief Handles all complete frames that have been read from a client. */
+            void handle_input(Client& client);
+
+            /** @brief Queues a frame that has been built with rpc::Writer in '_frame'. */
+            void send(Client& client);
+            void send_reply(Client& client, uint32_t id);
+            void send_error(Client& client, uint32_t id, const std::string& msg);
+            void send_progress(void);
+
+            /**
+            * @brief Starts a job on the worker thread.
+            * @param[in] owner: client that receives the events
+            * @param[in] id: ID of the request
+            * @param[in] out: new results of the job or nullptr
+            * @param[in] fn: function of the job, returns the status and sets the count
+            */
+            template<typename Fn>
+            void start_job(Client& owner, uint32_t id, std::shared_ptr<Buffer> out, Fn fn);
+
+            /** @brief Joins the finished job, stores its results and sends the final events. */
+            void finish_job(void);
+
+            void on_request(Client& client, const rpc::FrameHeader& header, const uint8_t* payload);
+            void req_scan(Client& client, uint32_t id, rpc::Reader& in);
+            void req_update(Client& client, uint32_t id, rpc::Reader& in);
+            void req_read(Client& client, uint32_t id, rpc::Reader& in);
+            void req_write(Client& client, uint32_t id, rpc::Reader& in);
+            void req_watch(Client& client, uint32_t id, rpc::Reader& in);
+            void req_results(Client& client, uint32_t id, rpc::Reader& in);
+            void req_export(Client& client, uint32_t id, rpc::Reader& in);
+            void req_cancel(Client& client, uint32_t id, rpc::Reader& in);
+
+        public:
+            Server(void);
+            Server(const Server&) = delete;
+            Server& operator= (const Server&) = delete;
+            virtual ~Server(void);
+
+            /**
+            * @brief Serves clients until the process is terminated.
+            * @param[in] name: name of the pipe, without the pipe prefix
+            * @return 'false' if the pipe could not be created.
+            */
+            bool run(const std::string& name);
+        };
+    }
+}
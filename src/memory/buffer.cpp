@@ -10,13 +10,22 @@
 */
 
 #include "buffer.h"
+#include "stats.h"
+#include <atomic>
 
 using namespace memory;
 
+namespace
+{
+    // generations are counted over all buffers, so that a buffer never gets the generation of another buffer
+    std::atomic<uint64_t> next_generation(1);
+}
+
 Buffer::Buffer(size_t limit, size_t size)
 {
     this->_begin = this->_end = this->_eob = nullptr;
     this->_cap = this->_size = 0;
+    this->_generation = next_generation++;
     this->set_limit(limit);
     if(size > 0)
         this->resize(size);
@@ -62,6 +71,7 @@ void Buffer::allocate(size_t size)
 
 void Buffer::reallocate(size_t new_size)
 {
+    Stats::add(MEMORY_STAT_REALLOCATIONS);
     if (this->_begin == nullptr)
         this->allocate(new_size);
     else
@@ -122,6 +132,7 @@ void Buffer::shrink_to_fit(void)
 
 void Buffer::clear(void) noexcept
 {
+    this->touch();
     if (this->_begin != nullptr)
     {
         free(this->_begin);
@@ -132,6 +143,11 @@ void Buffer::clear(void) noexcept
     }
 }
 
+void Buffer::touch(void) noexcept
+{
+    this->_generation = next_generation++;
+}
+
 void Buffer::set_limit(size_t limit)
 { 
     if (limit < this->_cap)
@@ -39,6 +39,7 @@ namespace memory
     private:
         void* _begin, * _end, * _eob;
         size_t _size, _cap, _limit;
+        uint64_t _generation;
         std::vector<Element> _table;
 
         /**
@@ -138,6 +139,18 @@ namespace memory
         /** @return the buffer's storage size limit in bytes */
         size_t limit(void)      const noexcept { return this->_limit; }
 
+        /**
+        * @brief Marks the elements as changed, must be called after the values have been changed in place.
+        *   Clearing, copying and moving the buffer changes the generation by itself.
+        */
+        void touch(void) noexcept;
+
+        /**
+        * @return Generation of the elements, it is unique among all buffers and changes whenever the buffer has been
+        *   cleared or touched. NOTE: pushing elements does not change it.
+        */
+        uint64_t generation(void) const noexcept { return this->_generation; }
+
         /** @return a list of all elements */
         std::vector<Element>& table(void)         noexcept          { return this->_table; }
         const std::vector<Element>& table(void)   const noexcept    { return this->_table; }
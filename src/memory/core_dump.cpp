@@ -0,0 +1,173 @@
+/**
+* @file     core_dump.cpp
+* @brief    Implementation of the CoreDump-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "core_dump.h"
+#include <cstring>
+
+using namespace memory;
+
+namespace
+{
+    // the ELF definitions that are needed, <elf.h> is not available on every platform
+    constexpr uint8_t ELF_MAGIC[4]      = { 0x7F, 'E', 'L', 'F' };
+    constexpr uint8_t ELFCLASS64        = 2;
+    constexpr uint8_t ELFDATA2LSB       = 1;
+    constexpr uint16_t ET_CORE          = 4;
+    constexpr uint16_t PN_XNUM          = 0xFFFF;
+    constexpr uint32_t PT_LOAD          = 1;
+    constexpr uint32_t PT_NOTE          = 4;
+    constexpr uint32_t NT_PRSTATUS      = 1;
+    constexpr uint32_t NT_PRPSINFO      = 3;
+    constexpr size_t PRSTATUS_PID       = 32;   // offset of pr_pid in elf_prstatus (x86-64)
+    constexpr size_t PRPSINFO_PID       = 24;   // offset of pr_pid in elf_prpsinfo (x86-64)
+
+#pragma pack(push, 1)
+    struct ElfHeader
+    {
+        uint8_t ident[16];
+        uint16_t type;
+        uint16_t machine;
+        uint32_t version;
+        uint64_t entry;
+        uint64_t phoff;
+        uint64_t shoff;
+        uint32_t flags;
+        uint16_t ehsize;
+        uint16_t phentsize;
+        uint16_t phnum;
+        uint16_t shentsize;
+        uint16_t shnum;
+        uint16_t shstrndx;
+    };
+
+    struct ProgramHeader
+    {
+        uint32_t type;
+        uint32_t flags;
+        uint64_t offset;
+        uint64_t vaddr;
+        uint64_t paddr;
+        uint64_t filesz;
+        uint64_t memsz;
+        uint64_t align;
+    };
+
+    struct SectionHeader
+    {
+        uint32_t name;
+        uint32_t type;
+        uint64_t flags;
+        uint64_t addr;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+        uint32_t info;
+        uint64_t addralign;
+        uint64_t entsize;
+    };
+
+    struct NoteHeader
+    {
+        uint32_t namesz;
+        uint32_t descsz;
+        uint32_t type;
+    };
+#pragma pack(pop)
+
+    inline uint64_t align4(uint64_t x) noexcept
+    {
+        return (x + 3) & ~static_cast<uint64_t>(3);
+    }
+}
+
+bool CoreDump::open(const std::string& path)
+{
+    this->close();
+
+    const uint8_t* view = this->map(path);
+    if (view == nullptr) return false;
+    const uint64_t size = this->file_size();
+
+    ElfHeader h;
+    bool valid = (size >= sizeof(ElfHeader));
+    if (valid)
+    {
+        memcpy(&h, view, sizeof(ElfHeader));
+        valid = (memcmp(h.ident, ELF_MAGIC, sizeof(ELF_MAGIC)) == 0 && h.ident[4] == ELFCLASS64 && h.ident[5] == ELFDATA2LSB
+                 && h.type == ET_CORE && h.phentsize >= sizeof(ProgramHeader));
+    }
+
+    // with more than 0xFFFE segments the number is stored in the first section header
+    uint64_t phnum = valid ? h.phnum : 0;
+    if (valid && phnum == PN_XNUM)
+    {
+        SectionHeader sh;
+        valid = (h.shoff <= size && sizeof(SectionHeader) <= size - h.shoff);
+        if (valid)
+        {
+            memcpy(&sh, view + h.shoff, sizeof(SectionHeader));
+            phnum = sh.info;
+        }
+    }
+    valid = valid && h.phoff <= size && phnum <= (size - h.phoff) / h.phentsize;
+
+    std::vector<Region> regions;
+    for (uint64_t i = 0; valid && i < phnum; i++)
+    {
+        ProgramHeader ph;
+        memcpy(&ph, view + h.phoff + i * h.phentsize, sizeof(ProgramHeader));
+        if (ph.offset > size || ph.filesz > size - ph.offset) continue;    // truncated dump
+        if (ph.type == PT_LOAD && ph.filesz > 0)
+            regions.push_back({ ph.vaddr, static_cast<size_t>(ph.filesz), ph.offset });
+        else if (ph.type == PT_NOTE && this->_pid == 0)
+            this->read_notes(view + ph.offset, ph.filesz);
+    }
+    if (!valid || !this->set_regions(std::move(regions)))
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void CoreDump::close(void) noexcept
+{
+    this->unmap();
+    this->_pid = 0;
+}
+
+void CoreDump::read_notes(const uint8_t* notes, uint64_t size) noexcept
+{
+    pid_t status_pid = 0;
+    uint64_t pos = 0;
+    while (pos + sizeof(NoteHeader) <= size)
+    {
+        NoteHeader n;
+        memcpy(&n, notes + pos, sizeof(NoteHeader));
+        const uint64_t desc = pos + sizeof(NoteHeader) + align4(n.namesz);
+        if (desc > size || n.descsz > size - desc) break;
+
+        int32_t pid = 0;
+        if (n.type == NT_PRPSINFO && n.descsz >= PRPSINFO_PID + sizeof(int32_t))
+        {
+            memcpy(&pid, notes + desc + PRPSINFO_PID, sizeof(int32_t));
+            this->_pid = static_cast<pid_t>(pid);
+            return;
+        }
+        if (n.type == NT_PRSTATUS && status_pid == 0 && n.descsz >= PRSTATUS_PID + sizeof(int32_t))
+        {
+            memcpy(&pid, notes + desc + PRSTATUS_PID, sizeof(int32_t));
+            status_pid = static_cast<pid_t>(pid);
+        }
+        pos = desc + align4(n.descsz);
+    }
+    this->_pid = status_pid;
+}
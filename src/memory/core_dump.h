@@ -0,0 +1,52 @@
+/**
+* @file     core_dump.h
+* @brief    Definition of the CoreDump-class. Reads the memory of an ELF core dump.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "memory_source.h"
+
+namespace memory
+{
+    /*
+    * A 64-bit little-endian ELF core dump, as written by Linux or gcore. Every PT_LOAD segment with
+    * bytes in the file is a region, segments that have not been dumped (p_filesz = 0) are not readable.
+    * The process ID is taken from the NT_PRPSINFO note, or from the first NT_PRSTATUS note.
+    */
+    class CoreDump : public MappedSource
+    {
+    private:
+        pid_t _pid;
+
+        /**
+        * @brief Reads the process ID from a PT_NOTE segment.
+        * @param[in] notes: first byte of the segment
+        * @param[in] size: size of the segment
+        */
+        void read_notes(const uint8_t* notes, uint64_t size) noexcept;
+
+    public:
+        CoreDump(void) : _pid(0) {}
+        virtual ~CoreDump(void) = default;
+
+        /**
+        * @brief Opens and maps a core dump.
+        * @param[in] path: path of the file
+        * @return 'false' if the file could not be mapped or is not an ELF core dump.
+        */
+        bool open(const std::string& path) override;
+        void close(void) noexcept override;
+
+        const char* format(void) const noexcept override { return "core dump"; }
+
+        /** @return ID of the dumped process, 0 if the dump does not contain it. */
+        pid_t pid(void) const noexcept override { return this->_pid; }
+    };
+}
@@ -0,0 +1,297 @@
+/**
+* @file     diff.cpp
+* @brief    Implementation of the Diff-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "diff.h"
+#include "stats.h"
+#include "trace.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace memory;
+
+namespace
+{
+    constexpr size_t BLOCK = 32;
+
+    inline bool cancelled(const std::atomic_bool* cancel) noexcept
+    {
+        return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+    }
+
+    /** @return 'true' if another value of 'size' bytes does not fit into the buffer. */
+    inline bool full(const Buffer& out, size_t size) noexcept
+    {
+        return out.limit() > 0 && out.size() + size > out.limit();
+    }
+
+    /** @brief Appends a range of changed bytes, it is merged with the last run if both touch. */
+    inline void add_range(std::vector<DiffRun>& runs, address_t begin, size_t size)
+    {
+        if (!runs.empty() && runs.back().begin + runs.back().size == begin)
+            runs.back().size += size;
+        else
+            runs.push_back({ begin, size });
+    }
+
+    /** @brief Counts a finished run and keeps it if it is one of the largest. */
+    void add_run(DiffReport& report, const DiffRun& run)
+    {
+        ++report.runs;
+        std::vector<DiffRun>& largest = report.largest;
+        if (largest.size() == Diff::REPORT_RUNS && run.size <= largest.back().size) return;
+        auto it = std::upper_bound(largest.begin(), largest.end(), run, [](const DiffRun& a, const DiffRun& b) { return a.size > b.size; });
+        largest.insert(it, run);
+        if (largest.size() > Diff::REPORT_RUNS)
+            largest.pop_back();
+    }
+
+    template<typename T>
+    inline bool changed_as(diff_t op, const uint8_t* by, const uint8_t* _old, const uint8_t* _new) noexcept
+    {
+        T old_value, new_value;
+        memcpy(&old_value, _old, sizeof(T));
+        memcpy(&new_value, _new, sizeof(T));
+        if (by == nullptr)
+            return (op == MEMORY_DIFF_INCREASED) ? (new_value > old_value) : (new_value < old_value);
+
+        // integral types wrap around, like the transformations
+        T value, delta;
+        memcpy(&value, by, sizeof(T));
+        if constexpr (std::is_integral<T>::value)
+        {
+            using U = typename std::make_unsigned<T>::type;
+            delta = static_cast<T>((op == MEMORY_DIFF_INCREASED) ? static_cast<U>(static_cast<U>(new_value) - static_cast<U>(old_value))
+                                                                 : static_cast<U>(static_cast<U>(old_value) - static_cast<U>(new_value)));
+        }
+        else
+            delta = (op == MEMORY_DIFF_INCREASED) ? (new_value - old_value) : (old_value - new_value);
+        return delta == value;
+    }
+
+    /** @return 'true' if the value has changed as described by the settings, the value overlaps a changed byte. */
+    bool matches(const DiffSettings& settings, const uint8_t* _old, const uint8_t* _new) noexcept
+    {
+        const diff_t op = settings.op;
+        if (op == MEMORY_DIFF_CHANGED) return memcmp(_old, _new, settings.scan.size) != 0;
+
+        const uint8_t* by = settings.by_value ? settings.value : nullptr;
+        switch (settings.scan.type)
+        {
+        case MEMORY_TYPE_INT8:      return changed_as<int8_t>(op, by, _old, _new);
+        case MEMORY_TYPE_UINT8:     return changed_as<uint8_t>(op, by, _old, _new);
+        case MEMORY_TYPE_INT16:     return changed_as<int16_t>(op, by, _old, _new);
+        case MEMORY_TYPE_UINT16:    return changed_as<uint16_t>(op, by, _old, _new);
+        case MEMORY_TYPE_INT32:     return changed_as<int32_t>(op, by, _old, _new);
+        case MEMORY_TYPE_UINT32:    return changed_as<uint32_t>(op, by, _old, _new);
+        case MEMORY_TYPE_INT64:     return changed_as<int64_t>(op, by, _old, _new);
+        case MEMORY_TYPE_UINT64:    return changed_as<uint64_t>(op, by, _old, _new);
+        case MEMORY_TYPE_FLOAT:     return changed_as<float>(op, by, _old, _new);
+        case MEMORY_TYPE_DOUBLE:    return changed_as<double>(op, by, _old, _new);
+        default:                    return false;   // strings can only be changed
+        }
+    }
+
+    // addresses of the values of a chunk that have changed, kept per thread so that a chunk does not allocate
+    thread_local std::vector<address_t> changed;
+}
+
+diff_t memory::to_diff(const std::string& str) noexcept
+{
+    if (str == "changed")   return MEMORY_DIFF_CHANGED;
+    if (str == "increased") return MEMORY_DIFF_INCREASED;
+    if (str == "decreased") return MEMORY_DIFF_DECREASED;
+    return MEMORY_DIFF_INVALID;
+}
+
+size_t Diff::compare(const uint8_t* a, const uint8_t* b, size_t size, address_t address, std::vector<DiffRun>& runs)
+{
+    size_t n_changed = 0;
+    size_t i = 0;
+    for (; i + BLOCK <= size; i += BLOCK)
+    {
+        // equal blocks are skipped with one test, AVX has no 256-bit byte compare but the XOR of both blocks is zero
+        const __m256 x = _mm256_xor_ps(_mm256_loadu_ps(reinterpret_cast<const float*>(a + i)), _mm256_loadu_ps(reinterpret_cast<const float*>(b + i)));
+        if (_mm256_testz_si256(_mm256_castps_si256(x), _mm256_castps_si256(x))) continue;
+
+        // one bit per changed byte, the halves are compared with SSE2
+        const __m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+        uint32_t mask = ~(static_cast<uint32_t>(_mm_movemask_epi8(lo)) | (static_cast<uint32_t>(_mm_movemask_epi8(hi)) << 16));
+        n_changed += __builtin_popcount(mask);
+
+        // every sequence of set bits is a range of changed bytes
+        while (mask != 0)
+        {
+            const uint32_t first = __builtin_ctz(mask);
+            const uint32_t rest = ~(mask >> first);
+            const uint32_t count = (rest == 0) ? static_cast<uint32_t>(BLOCK) - first : __builtin_ctz(rest);
+            add_range(runs, address + i + first, count);
+            mask = (first + count >= BLOCK) ? 0 : mask & (~0u << (first + count));
+        }
+    }
+    for (; i < size; i++)
+    {
+        if (a[i] != b[i])
+        {
+            add_range(runs, address + i, 1);
+            ++n_changed;
+        }
+    }
+    return n_changed;
+}
+
+scan_status_t Diff::diff(MemorySource& old_source, MemorySource& new_source, const DiffSettings& settings, Buffer& out,
+                         DiffReport& report, ScanProgress* progress, const std::atomic_bool* cancel)
+{
+    report = { 0, 0, 0, 0, {} };
+    const ScanSettings& s = settings.scan;
+    if (!old_source.is_valid() || !new_source.is_valid() || s.size == 0 || settings.op == MEMORY_DIFF_INVALID) return MEMORY_SCAN_DONE;
+    const size_t size = s.size;
+    const size_t alignment = std::max<size_t>(s.alignment, 1);
+    const size_t split_size = std::max<size_t>(s.split_size, alignment);
+
+    // the regions that are in both sources
+    std::vector<MemoryInfo> old_regions, new_regions, regions;
+    {
+        Stats::Timer timer(MEMORY_PHASE_QUERY);
+        MEMORY_TRACE_SCOPE("query", s.begin, s.end - s.begin);
+        old_source.query(s.begin, s.end, old_regions);
+        new_source.query(s.begin, s.end, new_regions);
+    }
+    for (size_t i = 0, j = 0; i < old_regions.size() && j < new_regions.size();)
+    {
+        const address_t old_end = old_regions[i].base + old_regions[i].size;
+        const address_t new_end = new_regions[j].base + new_regions[j].size;
+        const address_t begin = std::max<address_t>({ old_regions[i].base, new_regions[j].base, s.begin });
+        const address_t end = std::min<address_t>({ old_end, new_end, s.end });
+        if (begin < end)
+        {
+            MemoryInfo info = {};
+            info.base = begin;
+            info.size = end - begin;
+            regions.push_back(info);
+        }
+        if (old_end <= new_end) i++;
+        if (new_end <= old_end) j++;
+    }
+    if (progress != nullptr)
+    {
+        uint64_t total = 0;
+        for (const MemoryInfo& region : regions)
+            total += region.size;
+        progress->bytes_total += total;
+        progress->regions_total += regions.size();
+    }
+
+    std::vector<uint8_t> old_buff, new_buff;
+    std::vector<DiffRun> runs;
+    for (const MemoryInfo& region : regions)
+    {
+        MEMORY_TRACE_SCOPE("region", region.base, region.size);
+        const uint8_t* old_view = old_source.view(region.base, region.size);
+        const uint8_t* new_view = new_source.view(region.base, region.size);
+        address_t next_value = region.base;     // values before this address have been checked
+        for (address_t i = 0; i < region.size; i += split_size)
+        {
+            if (cancelled(cancel))
+            {
+                for (const DiffRun& run : runs)
+                    add_run(report, run);
+                return MEMORY_SCAN_CANCELLED;
+            }
+
+            // the chunk is compared, the window contains all values that overlap the chunk
+            const address_t chunk = region.base + i;
+            const size_t chunk_size = std::min<address_t>(region.size - i, split_size);
+            const address_t window = chunk - std::min<address_t>(i, size - 1);
+            const size_t window_size = chunk + std::min<address_t>(region.size - i, split_size + size - 1) - window;
+            const uint8_t* o = (old_view != nullptr) ? old_view + (window - region.base) : nullptr;
+            const uint8_t* n = (new_view != nullptr) ? new_view + (window - region.base) : nullptr;
+            if (o == nullptr || n == nullptr)
+            {
+                Stats::Timer timer(MEMORY_PHASE_READ);
+                MEMORY_TRACE_SCOPE("read", window, window_size);
+                if (o == nullptr)
+                {
+                    old_buff.resize(window_size);
+                    o = (old_source.read(window, window_size, old_buff.data()) == window_size) ? old_buff.data() : nullptr;
+                }
+                if (n == nullptr)
+                {
+                    new_buff.resize(window_size);
+                    n = (new_source.read(window, window_size, new_buff.data()) == window_size) ? new_buff.data() : nullptr;
+                }
+            }
+
+            // a chunk that cannot be read ends the runs
+            bool limit = false;
+            uint64_t hits = 0;
+            if (o != nullptr && n != nullptr)
+            {
+                changed.clear();
+                {
+                    Stats::Timer timer(MEMORY_PHASE_COMPARE);
+                    MEMORY_TRACE_SCOPE("compare", chunk, chunk_size);
+                    report.changed_bytes += compare(o + (chunk - window), n + (chunk - window), chunk_size, chunk, runs);
+                    report.bytes += chunk_size;
+                    Stats::add(MEMORY_STAT_BYTES_COMPARED, chunk_size);
+
+                    // only the values that overlap a run can have changed, the first run may have been checked partly
+                    for (const DiffRun& run : runs)
+                    {
+                        address_t a = std::max<address_t>({ next_value, window, (run.begin - region.base >= size - 1) ? run.begin - (size - 1) : region.base });
+                        a = region.base + (a - region.base + alignment - 1) / alignment * alignment;
+                        for (; a < run.begin + run.size && a + size <= window + window_size; a += alignment)
+                        {
+                            if (matches(settings, o + (a - window), n + (a - window)))
+                                changed.push_back(a);
+                        }
+                        next_value = std::max(next_value, a);
+                    }
+                }
+
+                Stats::Timer timer(MEMORY_PHASE_PUSH);
+                MEMORY_TRACE_SCOPE("push", chunk, changed.size() * size);
+                for (address_t a : changed)
+                {
+                    if (full(out, size))
+                    {
+                        limit = true;
+                        break;
+                    }
+                    out.push(new_source.pid(), a, size, s.type, n + (a - window));
+                    ++hits;
+                }
+                Stats::add(MEMORY_STAT_HITS, hits);
+            }
+
+            // the last run continues in the next chunk if it reaches the end of this chunk
+            const bool open = !limit && o != nullptr && n != nullptr && !runs.empty() && i + split_size < region.size
+                              && runs.back().begin + runs.back().size == chunk + chunk_size;
+            const size_t finished = runs.size() - (open ? 1 : 0);
+            for (size_t k = 0; k < finished; k++)
+                add_run(report, runs[k]);
+            runs.erase(runs.begin(), runs.begin() + finished);
+
+            if (progress != nullptr)
+            {
+                progress->bytes += chunk_size;
+                progress->hits += hits;
+            }
+            if (limit) return MEMORY_SCAN_LIMIT;
+        }
+        ++report.regions;
+        if (progress != nullptr) ++progress->regions;
+    }
+    return MEMORY_SCAN_DONE;
+}
@@ -0,0 +1,92 @@
+/**
+* @file     diff.h
+* @brief    Definition of the Diff-class. Compares the memory of two snapshots, reports the changed
+*           bytes as runs and finds the values that have changed in a certain way.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "scanner.h"
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    enum diff_t : uint8_t
+    {
+        MEMORY_DIFF_INVALID = 0x0,
+        MEMORY_DIFF_CHANGED = 0x1,      // new != old
+        MEMORY_DIFF_INCREASED = 0x2,    // new > old, or new - old == a if a value is given
+        MEMORY_DIFF_DECREASED = 0x3     // new < old, or old - new == a if a value is given
+    };
+
+    /**
+    * @brief Converts a string to a diff operation.
+    * @param[in] str: name of the operation (changed, increased, decreased)
+    * @return The operation or MEMORY_DIFF_INVALID if the name is unknown.
+    */
+    diff_t to_diff(const std::string& str) noexcept;
+
+    struct DiffSettings
+    {
+        ScanSettings scan;              // type, size and alignment of the values, range and chunk size
+        diff_t op;
+        bool by_value;                  // the value must have changed by exactly 'value', not for strings and MEMORY_DIFF_CHANGED
+        uint8_t value[sizeof(uint64_t)];
+    };
+
+    struct DiffRun
+    {
+        address_t begin;
+        size_t size;
+    };
+
+    struct DiffReport
+    {
+        uint64_t regions;               // regions that are in both sources
+        uint64_t bytes;                 // compared bytes
+        uint64_t changed_bytes;
+        uint64_t runs;                  // ranges of consecutive changed bytes
+        std::vector<DiffRun> largest;   // the largest runs, sorted by size, at most Diff::REPORT_RUNS
+    };
+
+    class Diff
+    {
+    public:
+        constexpr static size_t REPORT_RUNS = 10;
+
+        /**
+        * @brief Compares two blocks and appends the ranges of changed bytes to 'runs'.
+        *   32 bytes are compared at once, a range that continues the last run is merged into it.
+        * @param[in] a: old bytes
+        * @param[in] b: new bytes
+        * @param[in] size: size of both blocks
+        * @param[in] address: address of the first byte
+        * @param[in,out] runs: ranges of changed bytes, sorted by address
+        * @return Number of changed bytes.
+        */
+        static size_t compare(const uint8_t* a, const uint8_t* b, size_t size, address_t address, std::vector<DiffRun>& runs);
+
+        /**
+        * @brief Compares the regions that are in both sources. The changed bytes are counted in 'report' and
+        *   every value that has changed as described by 'settings' is added to 'out' with its new value.
+        *   Only values that overlap a changed byte are checked. Cancellation is checked after every chunk.
+        * @param[in] old_source: older snapshot or core dump
+        * @param[in] new_source: newer snapshot or core dump, the results get its PID
+        * @param[in] settings: operation, value type and range
+        * @param[out] out: buffer of the values, the diff stops when its limit is reached
+        * @param[out] report: runs of changed bytes
+        * @param[out] progress: progress of the diff, may be nullptr
+        * @param[in] cancel: the diff stops if it is set, may be nullptr
+        * @return Status of the diff.
+        */
+        static scan_status_t diff(MemorySource& old_source, MemorySource& new_source, const DiffSettings& settings, Buffer& out,
+                                  DiffReport& report, ScanProgress* progress, const std::atomic_bool* cancel);
+    };
+}
@@ -0,0 +1,296 @@
+/**
+* @file     exporter.cpp
+* @brief    Implementation of the Exporter-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "exporter.h"
+#include "utility.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+using namespace memory;
+
+namespace
+{
+    constexpr char HEX_TABLE[] = "0123456789ABCDEF";
+
+    inline char* put(char* p, const char* str, size_t size) noexcept
+    {
+        memcpy(p, str, size);
+        return p + size;
+    }
+
+    template<size_t N>
+    inline char* put(char* p, const char (&str)[N]) noexcept
+    {
+        return put(p, str, N - 1);
+    }
+
+    template<typename T>
+    inline char* put_dec(char* p, T x) noexcept
+    {
+        return std::to_chars(p, p + 32, x).ptr;
+    }
+
+    /** @brief Writes an address as "0x" followed by 16 hexadecimal digits. */
+    inline char* put_addr(char* p, address_t x) noexcept
+    {
+        *p++ = '0';
+        *p++ = 'x';
+        for (int32_t i = 60; i >= 0; i -= 4)
+            *p++ = HEX_TABLE[(x >> i) & 0xF];
+        return p;
+    }
+
+    /** @brief Writes a number, strings are not handled. */
+    inline char* put_number(char* p, type_t type, const void* data) noexcept
+    {
+        return p + utility::format_value(static_cast<const uint8_t*>(data), type, false, p);
+    }
+
+    /** @brief Writes a CSV field, it is quoted if it contains a separator, a quote or a line break. */
+    char* put_csv(char* p, const char* str, size_t size, bool quote) noexcept
+    {
+        for (size_t i = 0; i < size && !quote; i++)
+            quote = (str[i] == ',' || str[i] == '"' || str[i] == '\n' || str[i] == '\r');
+        if (!quote)
+            return put(p, str, size);
+
+        *p++ = '"';
+        for (size_t i = 0; i < size; i++)
+        {
+            if (str[i] == '"')
+                *p++ = '"';
+            *p++ = str[i];
+        }
+        *p++ = '"';
+        return p;
+    }
+
+    /** @brief Writes a quoted JSON string, control characters are escaped. */
+    char* put_json(char* p, const char* str, size_t size) noexcept
+    {
+        *p++ = '"';
+        for (size_t i = 0; i < size; i++)
+        {
+            const uint8_t c = static_cast<uint8_t>(str[i]);
+            if (c == '"' || c == '\\')
+            {
+                *p++ = '\\';
+                *p++ = static_cast<char>(c);
+            }
+            else if (c < 0x20 || c == 0x7F)
+            {
+                p = put(p, "\\u00");
+                *p++ = HEX_TABLE[c >> 4];
+                *p++ = HEX_TABLE[c & 0xF];
+            }
+            else
+                *p++ = static_cast<char>(c);
+        }
+        *p++ = '"';
+        return p;
+    }
+
+    /** @return Length of a string value, the value ends at the first 0-character. */
+    inline size_t string_size(const Buffer::Element& e) noexcept
+    {
+        const void* end = memchr(e.data, 0, e.size);
+        return (end != nullptr) ? static_cast<const char*>(end) - static_cast<const char*>(e.data) : e.size;
+    }
+
+    const char* type_name(type_t type) noexcept
+    {
+        switch (type)
+        {
+        case MEMORY_TYPE_INT8:      return "int8";
+        case MEMORY_TYPE_UINT8:     return "uint8";
+        case MEMORY_TYPE_INT16:     return "int16";
+        case MEMORY_TYPE_UINT16:    return "uint16";
+        case MEMORY_TYPE_INT32:     return "int32";
+        case MEMORY_TYPE_UINT32:    return "uint32";
+        case MEMORY_TYPE_INT64:     return "int64";
+        case MEMORY_TYPE_UINT64:    return "uint64";
+        case MEMORY_TYPE_FLOAT:     return "float";
+        case MEMORY_TYPE_DOUBLE:    return "double";
+        case MEMORY_TYPE_STRING:    return "string";
+        default:                    return "void";
+        }
+    }
+}
+
+Exporter::Exporter(void)
+{
+    this->_format = MEMORY_EXPORT_TEXT;
+    this->_used = 0;
+    this->_rows = 0;
+    this->_failed = false;
+}
+
+Exporter::~Exporter(void)
+{
+    this->close();
+}
+
+bool Exporter::open(const std::string& path, export_format_t format)
+{
+    this->close();
+    this->_file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!this->_file) return false;
+
+    this->_format = format;
+    this->_buffer.resize(BUFFER_SIZE);
+    this->_used = 0;
+    this->_rows = 0;
+    this->_failed = false;
+    this->_modules.clear();
+
+    if (format == MEMORY_EXPORT_CSV)
+    {
+        constexpr char header[] = "pid,address,module,offset,type,size,value\n";
+        this->_used = put(this->_buffer.data(), header) - this->_buffer.data();
+    }
+    return true;
+}
+
+void Exporter::add_modules(pid_t pid, std::vector<ModuleInfo>&& modules)
+{
+    this->_modules[pid] = std::move(modules);
+}
+
+const ModuleInfo* Exporter::find_module(pid_t pid, address_t address) const noexcept
+{
+    const auto iter = this->_modules.find(pid);
+    if (iter == this->_modules.end()) return nullptr;
+
+    // last module that begins at or before the address
+    const std::vector<ModuleInfo>& modules = iter->second;
+    auto m = std::upper_bound(modules.begin(), modules.end(), address, [](address_t a, const ModuleInfo& mi) { return a < mi.base; });
+    if (m == modules.begin()) return nullptr;
+    --m;
+    return (address < m->base + m->size) ? &(*m) : nullptr;
+}
+
+char* Exporter::reserve(size_t size)
+{
+    if (this->_buffer.size() - this->_used < size)
+    {
+        this->flush();
+        if (this->_buffer.size() < size)
+            this->_buffer.resize(size);
+    }
+    return this->_buffer.data() + this->_used;
+}
+
+void Exporter::flush(void)
+{
+    if (this->_used == 0) return;
+    this->_file.write(this->_buffer.data(), this->_used);
+    this->_failed |= !this->_file;
+    this->_used = 0;
+}
+
+void Exporter::write(const Buffer::Element& e)
+{
+    if (!this->_file.is_open()) return;
+
+    const bool is_string = (e.type == MEMORY_TYPE_STRING);
+    const size_t str_size = is_string ? string_size(e) : 0;
+    const ModuleInfo* module = (this->_format != MEMORY_EXPORT_TEXT) ? this->find_module(e.pid, e.address) : nullptr;
+    const size_t module_size = (module != nullptr) ? module->name.size() : 0;
+
+    // strings may grow by escaping, 6 characters per character at most
+    char* const begin = this->reserve(ROW_SIZE + 6 * (str_size + module_size));
+    char* p = begin;
+    switch (this->_format)
+    {
+    case MEMORY_EXPORT_TEXT:
+        p = put_dec(p, e.pid);
+        *p++ = ',';
+        p = put_dec(p, e.address);
+        *p++ = ',';
+        p = put_dec(p, e.size);
+        *p++ = ',';
+        p = put_dec(p, static_cast<uint32_t>(e.type));
+        *p++ = ',';
+        p = is_string ? put(p, static_cast<const char*>(e.data), str_size) : put_number(p, e.type, e.data);
+        break;
+
+    case MEMORY_EXPORT_CSV:
+        p = put_dec(p, e.pid);
+        *p++ = ',';
+        p = put_addr(p, e.address);
+        *p++ = ',';
+        if (module != nullptr)
+        {
+            p = put_csv(p, module->name.data(), module->name.size(), false);
+            *p++ = ',';
+            p = put_addr(p, e.address - module->base);
+        }
+        else
+            *p++ = ',';
+        *p++ = ',';
+        p = put(p, type_name(e.type), strlen(type_name(e.type)));
+        *p++ = ',';
+        p = put_dec(p, e.size);
+        *p++ = ',';
+        p = is_string ? put_csv(p, static_cast<const char*>(e.data), str_size, true) : put_number(p, e.type, e.data);
+        break;
+
+    case MEMORY_EXPORT_JSONL:
+        // addresses are strings, JSON numbers are not exact beyond 2^53
+        p = put(p, "{\"pid\":");
+        p = put_dec(p, e.pid);
+        p = put(p, ",\"address\":\"");
+        p = put_addr(p, e.address);
+        *p++ = '"';
+        if (module != nullptr)
+        {
+            p = put(p, ",\"module\":");
+            p = put_json(p, module->name.data(), module->name.size());
+            p = put(p, ",\"offset\":\"");
+            p = put_addr(p, e.address - module->base);
+            *p++ = '"';
+        }
+        p = put(p, ",\"type\":\"");
+        p = put(p, type_name(e.type), strlen(type_name(e.type)));
+        p = put(p, "\",\"size\":");
+        p = put_dec(p, e.size);
+        p = put(p, ",\"value\":");
+        if (is_string)
+            p = put_json(p, static_cast<const char*>(e.data), str_size);
+        else
+        {
+            // NaN and infinity are not valid JSON numbers
+            char* const value = p;
+            p = put_number(p, e.type, e.data);
+            if (p == value || std::find_if(value, p, [](char c) { return c == 'n' || c == 'i'; }) != p)
+                p = put(value, "null");
+        }
+        *p++ = '}';
+        break;
+    }
+    *p++ = '\n';
+
+    this->_used += p - begin;
+    ++this->_rows;
+}
+
+bool Exporter::close(void)
+{
+    if (!this->_file.is_open()) return false;
+
+    this->flush();
+    this->_file.close();
+    this->_failed |= !this->_file;
+    this->_buffer.clear();
+    this->_buffer.shrink_to_fit();
+    return !this->_failed;
+}
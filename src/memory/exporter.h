@@ -0,0 +1,101 @@
+/**
+* @file     exporter.h
+* @brief    Definition of the Exporter-class. Streams search results to a text, CSV or JSON-lines file.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "buffer.h"
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace memory
+{
+    enum export_format_t : uint8_t
+    {
+        MEMORY_EXPORT_TEXT = 0x0,       // pid,address,size,type,value without header
+        MEMORY_EXPORT_CSV = 0x1,        // pid,address,module,offset,type,size,value with header
+        MEMORY_EXPORT_JSONL = 0x2       // one JSON object per line
+    };
+
+    /*
+    * Rows are formatted with std::to_chars into one large buffer, which is written to the file
+    * when it is full. Addresses inside of a module are additionally written as module name and
+    * offset, if the modules of the process have been added.
+    */
+    class Exporter
+    {
+    public:
+        constexpr static size_t BUFFER_SIZE = 0x400000;    // 4MB
+        constexpr static size_t ROW_SIZE    = 0x200;       // maximum size of a row without a string value
+
+    private:
+        std::ofstream _file;
+        export_format_t _format;
+        std::vector<char> _buffer;
+        size_t _used;
+        uint64_t _rows;
+        bool _failed;
+        std::unordered_map<pid_t, std::vector<ModuleInfo>> _modules;
+
+        /**
+        * @brief Makes room for at least 'size' characters in the buffer.
+        * @return Pointer to the first free character.
+        */
+        char* reserve(size_t size);
+
+        /** @brief Writes the buffer to the file. */
+        void flush(void);
+
+        /**
+        * @return The module that contains the address or nullptr if no module contains the address.
+        */
+        const ModuleInfo* find_module(pid_t pid, address_t address) const noexcept;
+
+    public:
+        Exporter(void);
+        Exporter(const Exporter&) = delete;
+        Exporter& operator= (const Exporter&) = delete;
+        virtual ~Exporter(void);
+
+        /**
+        * @brief Creates the file and writes the header.
+        * @param[in] path: path of the file
+        * @param[in] format: format of the file
+        * @return 'true' if the file could be created.
+        */
+        bool open(const std::string& path, export_format_t format);
+
+        /**
+        * @brief Adds the modules of a process, addresses of this process are then written module-relative.
+        * @param[in] pid: ID of the process
+        * @param[in] modules: modules of the process, sorted by base address
+        */
+        void add_modules(pid_t pid, std::vector<ModuleInfo>&& modules);
+
+        /** @return 'true' if the modules of the process have been added. */
+        bool has_modules(pid_t pid) const noexcept { return this->_modules.count(pid) > 0; }
+
+        /**
+        * @brief Writes one element.
+        * @param[in] e: element to write
+        */
+        void write(const Buffer::Element& e);
+
+        /**
+        * @brief Writes the remaining rows and closes the file.
+        * @return 'true' if all rows have been written.
+        */
+        bool close(void);
+
+        /** @return Number of written rows. */
+        uint64_t rows(void) const noexcept { return this->_rows; }
+    };
+}
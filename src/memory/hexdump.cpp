@@ -10,149 +10,252 @@
 */
 
 #include "table.h"
+#include <immintrin.h>
+#include <cstring>
 #include <iostream>
 
 using namespace memory;
 
-HexDump::HexDump(void) noexcept : HexDump(0)
+namespace
 {
-}
+    constexpr char HEX_TABLE[] = "0123456789ABCDEF";
 
-HexDump::HexDump(uint32_t lines, uint32_t width)
-{
-    this->add_column("Address");
-    this->add_column("Data");
+    /** @return Number of characters of 'count' encoded bytes. */
+    inline size_t hex_size(uint32_t count) noexcept
+    {
+        return (count > 0) ? 3 * count - 1 + (count - 1) / 4 : 0;
+    }
+
+    /** @return Position of the byte 'i' within the encoded bytes. */
+    inline size_t hex_pos(uint32_t i) noexcept
+    {
+        return 3 * i + i / 4;
+    }
 
-    this->iter = this->begin();
-    this->_width = 0;
-    this->resize(lines, width);
+    inline bool is_printable(uint8_t c) noexcept
+    {
+        return c >= 0x20 && c <= 0x7E;
+    }
 }
 
-HexDump::~HexDump(void)
+HexDump::HexDump(void) noexcept : HexDump(0)
 {
+}
 
+HexDump::HexDump(uint32_t lines, uint32_t width, bool ascii)
+{
+    this->_lines = lines;
+    this->_width = width;
+    this->_row = 0;
+    this->_ascii = ascii;
+    this->init_lines();
 }
 
-void HexDump::init_hex(void) noexcept
+void HexDump::init_lines(void)
 {
-    this->init_hex_string.clear();
+    const size_t n_hex = hex_size(this->_width);
+
+    // memory line of the address 0x0 with 0-bytes
+    this->_init_line.clear();
+    this->_init_line.push_back(VERTICAL_CHAR);
+    this->_init_line.push_back(' ');
+    this->_init_line.append(ADDRESS_SIZE, '0');
+    this->_init_line += " | ";
+    this->_hex_offset = this->_init_line.size();
     for (uint32_t i = 0; i < this->_width; i++)
     {
         if ((i % 4) == 0 && i > 0)
-            this->init_hex_string.push_back(' ');
-        this->init_hex_string.insert(this->init_hex_string.size(), "00");
+            this->_init_line.push_back(' ');
+        this->_init_line += "00";
         if (i < (this->_width - 1))
-            this->init_hex_string.push_back(' ');
+            this->_init_line.push_back(' ');
     }
+    this->_init_line += " |";
+    this->_ascii_offset = this->_init_line.size() + 1;
+    if (this->_ascii)
+    {
+        this->_init_line.push_back(' ');
+        this->_init_line.append(this->_width, '.');
+        this->_init_line += " |";
+    }
+    this->_init_line.push_back('\n');
+    this->_line_size = this->_init_line.size();
+
+    // separator line
+    std::string sep_line;
+    sep_line.push_back(CORNER_CHAR);
+    sep_line.append(ADDRESS_SIZE + 2, HORIZONTAL_CHAR);
+    sep_line.push_back(CORNER_CHAR);
+    sep_line.append(n_hex + 2, HORIZONTAL_CHAR);
+    sep_line.push_back(CORNER_CHAR);
+    if (this->_ascii)
+    {
+        sep_line.append(this->_width + 2, HORIZONTAL_CHAR);
+        sep_line.push_back(CORNER_CHAR);
+    }
+    sep_line.push_back('\n');
+
+    this->_buffer.clear();
+    this->_buffer.reserve((this->_lines + 2) * this->_line_size);
+    this->_buffer += sep_line;
+    for (uint32_t i = 0; i < this->_lines; i++)
+        this->_buffer += this->_init_line;
+    this->_buffer += sep_line;
 }
 
-void HexDump::encode_hex(const uint8_t* bytes, std::string& str) noexcept
+void HexDump::encode_hex(const uint8_t* bytes, uint32_t count, char* hex, char* ascii) noexcept
 {
-    constexpr static char table[] = "0123456789ABCDEF";
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i nibble = _mm_set1_epi8(0x0F);
 
-    str.clear();
-    for (uint32_t i = 0; i < this->_width; i++)
+    // spreads 4 encoded bytes (8 characters) to "HL HL HL HL  ", the first or the second half of the register is used
+    const __m128i spread_lo = _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, -1, -1, -1, -1);
+    const __m128i spread_hi = _mm_setr_epi8(8, 9, -1, 10, 11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1);
+    const __m128i spaces = _mm_setr_epi8(0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', ' ', ' ', ' ', ' ');
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i below = _mm_set1_epi8(0x1F);
+    const __m128i above = _mm_set1_epi8(0x7F);
+
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16)
     {
-        if ((i % 4) == 0 && i > 0)
-            str.push_back(' ');
-        str.push_back(table[(bytes[i] >> 4) & 0x0F]);
-        str.push_back(table[bytes[i] & 0x0F]);
-        if (i < (this->_width - 1))
-            str.push_back(' ');
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, nibble));
+        const __m128i chars_0 = _mm_unpacklo_epi8(hi, lo);     // bytes 0-7
+        const __m128i chars_1 = _mm_unpackhi_epi8(hi, lo);     // bytes 8-15
+
+        // Every group overwrites the first 3 characters of the next group, which are written afterwards.
+        // The last group of the line must not write beyond the encoded bytes.
+        char* dst = hex + hex_pos(i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),       _mm_or_si128(_mm_shuffle_epi8(chars_0, spread_lo), spaces));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 13),  _mm_or_si128(_mm_shuffle_epi8(chars_0, spread_hi), spaces));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 26),  _mm_or_si128(_mm_shuffle_epi8(chars_1, spread_lo), spaces));
+        const __m128i last = _mm_or_si128(_mm_shuffle_epi8(chars_1, spread_hi), spaces);
+        if (i + 16 < count)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 39), last);
+        else
+        {
+            alignas(16) char tmp[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(tmp), last);
+            memcpy(dst + 39, tmp, 11);
+        }
+
+        if (ascii != nullptr)
+        {
+            const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ascii + i), _mm_blendv_epi8(dot, v, printable));
+        }
+    }
+
+    // remaining bytes, the separating spaces are already part of the line
+    for (; i < count; i++)
+    {
+        char* dst = hex + hex_pos(i);
+        dst[0] = HEX_TABLE[bytes[i] >> 4];
+        dst[1] = HEX_TABLE[bytes[i] & 0x0F];
+        if (ascii != nullptr)
+            ascii[i] = is_printable(bytes[i]) ? static_cast<char>(bytes[i]) : '.';
     }
 }
 
-void HexDump::encode_addr(uint64_t address, std::string& str) noexcept
+void HexDump::encode_addr(uint64_t address, char* str) noexcept
 {
-    constexpr static char table[] = "0123456789ABCDEF";
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i nibble = _mm_set1_epi8(0x0F);
 
-    str.clear();
-    for (int32_t i = sizeof(uint64_t) * 8 - 4; i >= 0; i -= 4)
-        str.push_back(table[(address >> i) & 0x0F]);
+    // the most significant byte is encoded first
+    const __m128i v = _mm_cvtsi64_si128(static_cast<long long>(__builtin_bswap64(address)));
+    const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(str), _mm_unpacklo_epi8(hi, lo));
 }
 
 void HexDump::set(const uint8_t* bytes) noexcept
 {
-    if (this->iter == this->end()) return;
+    if (this->_row >= this->_lines) return;
 
-    std::string str;
-    this->encode_hex(bytes, str);
-    (*this->iter)[1] = str;
+    char* l = this->line(this->_row);
+    encode_hex(bytes, this->_width, l + this->_hex_offset, this->_ascii ? l + this->_ascii_offset : nullptr);
 }
 
 void HexDump::set(uint64_t address, const uint8_t* bytes) noexcept
 {
-    if (this->iter == this->end()) return;
+    if (this->_row >= this->_lines) return;
+
+    char* l = this->line(this->_row);
+    encode_addr(address, l + 2);
+    encode_hex(bytes, this->_width, l + this->_hex_offset, this->_ascii ? l + this->_ascii_offset : nullptr);
+}
+
+void HexDump::set_unreadable(uint32_t first, uint32_t count) noexcept
+{
+    if (this->_row >= this->_lines) return;
 
-    std::string str;
-    this->encode_addr(address, str);
-    (*this->iter)[0] = str;
-    this->encode_hex(bytes, str);
-    (*this->iter)[1] = str;
+    char* l = this->line(this->_row);
+    for (uint32_t i = first; i < first + count && i < this->_width; i++)
+    {
+        char* dst = l + this->_hex_offset + hex_pos(i);
+        dst[0] = dst[1] = '?';
+        if (this->_ascii)
+            l[this->_ascii_offset + i] = '?';
+    }
 }
 
 void HexDump::scroll_up(void) noexcept
 {
-    this->get_entries().pop_front();
-    this->get_entries().push_back({ NULLPTR_STR, this->init_hex_string });
+    if (this->_lines == 0) return;
+    memmove(this->line(0), this->line(1), (this->_lines - 1) * this->_line_size);
+    memcpy(this->line(this->_lines - 1), this->_init_line.data(), this->_line_size);
 }
 
 void HexDump::scroll_down(void) noexcept
 {
-    this->get_entries().pop_back();
-    this->get_entries().push_front({ NULLPTR_STR, this->init_hex_string });
+    if (this->_lines == 0) return;
+    memmove(this->line(1), this->line(0), (this->_lines - 1) * this->_line_size);
+    memcpy(this->line(0), this->_init_line.data(), this->_line_size);
 }
 
 void HexDump::inc(void) noexcept
 {
-    if (this->iter != this->end())
-        this->iter++;
+    if (this->_row < this->_lines)
+        this->_row++;
 }
 
 void HexDump::dec(void) noexcept
 {
-    if (this->iter != this->begin())
-        this->iter--;
+    if (this->_row > 0)
+        this->_row--;
 }
 
 void HexDump::front(void) noexcept
 {
-    this->iter = this->begin();
+    this->_row = 0;
 }
 
 void HexDump::back(void) noexcept
 {
-    this->iter = this->end();
+    this->_row = this->_lines;
 }
 
 void HexDump::resize(uint32_t lines, uint32_t width)
 {
-    if (width != this->_width)
-    {
-        this->_width = width;
-        this->init_hex();
-        for (table_iterator iter = this->begin(); iter != this->end(); iter++)
-        {
-            (*iter)[0] = NULLPTR_STR;
-            (*iter)[1] = this->init_hex_string;
-        }
-    }
+    this->_lines = lines;
+    this->_width = width;
+    if (this->_row > lines)
+        this->_row = lines;
+    this->init_lines();
+}
 
-    if (lines < this->entry_count())
-    {
-        while (this->entry_count() > lines)
-            this->get_entries().pop_back();
-    }
-    else if (lines > this->entry_count())
-    {
-        while (this->entry_count() < lines)
-            this->get_entries().push_back({ NULLPTR_STR, this->init_hex_string });
-    }
+void HexDump::show_ascii(bool ascii)
+{
+    this->_ascii = ascii;
+    this->init_lines();
 }
 
 uint32_t HexDump::line_count(void) const noexcept
 {
-    return this->entry_count();
+    return this->_lines;
 }
 
 uint32_t HexDump::width(void) const noexcept
@@ -160,19 +263,15 @@ uint32_t HexDump::width(void) const noexcept
     return this->_width;
 }
 
-void HexDump::print(void) const noexcept
+void HexDump::render(std::vector<std::string>& lines) const
 {
-    uint32_t max_width[this->col_count()];
-    this->get_max_width(max_width);
-
-    std::string sep_line, line;
-    this->get_separator_line(max_width, sep_line);
-    std::cout << sep_line << std::endl;
+    lines.resize(this->_lines + 2);
+    for (size_t i = 0; i < lines.size(); i++)
+        lines[i].assign(this->_buffer, i * this->_line_size, this->_line_size - 1);
+}
 
-    for (const_table_iterator iter = this->begin(); iter != this->end(); iter++)
-    {
-        this->get_line(max_width, *iter, line);
-        std::cout << line << std::endl;
-    }
-    std::cout << sep_line << std::endl;
-}
\ No newline at end of file
+void HexDump::print(void) const noexcept
+{
+    std::cout.write(this->_buffer.data(), this->_buffer.size());
+    std::cout.flush();
+}
@@ -0,0 +1,221 @@
+/**
+* @file     io_batch.cpp
+* @brief    Implementation of the IoBatch-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "io_batch.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace memory;
+
+void IoBatch::add(address_t address, size_t size, void* data)
+{
+    if (size == 0) return;
+    this->_requests.push_back({ address, size, reinterpret_cast<uint8_t*>(data), false });
+}
+
+void IoBatch::clear(void) noexcept
+{
+    this->_requests.clear();
+    this->_order.clear();
+    this->_runs.clear();
+}
+
+void IoBatch::build_runs(size_t max_gap)
+{
+    // sort requests by address, requests with the same address stay in the order they have been added
+    this->_order.resize(this->_requests.size());
+    for (size_t i = 0; i < this->_order.size(); i++)
+        this->_order[i] = i;
+    std::stable_sort(this->_order.begin(), this->_order.end(), [this](size_t a, size_t b) {
+        return this->_requests[a].address < this->_requests[b].address;
+    });
+
+    // merge requests into runs
+    this->_runs.clear();
+    for (size_t i = 0; i < this->_order.size(); i++)
+    {
+        Request& r = this->_requests[this->_order[i]];
+        r.failed = false;
+        const address_t r_end = r.address + r.size;
+
+        if (!this->_runs.empty())
+        {
+            Run& run = this->_runs.back();
+            const address_t new_end = std::max(run.end, r_end);
+            if (r.address <= run.end + max_gap && (new_end - run.begin) <= MAX_RUN_SIZE)
+            {
+                run.gaps |= (r.address > run.end);
+                run.end = new_end;
+                run.last = i + 1;
+                continue;
+            }
+        }
+        this->_runs.push_back({ r.address, r_end, i, i + 1, false });
+    }
+}
+
+bool IoBatch::read_run(MemorySource& source, const Run& run, Result& result)
+{
+    const size_t size = run.end - run.begin;
+    MEMORY_TRACE_SCOPE("read_run", run.begin, size);
+    ++result.calls;
+    if (source.read(run.begin, size, this->_staging.data()) == size)
+        return true;
+
+    // read page by page, unreadable pages are marked as failed
+    const address_t first_page = run.begin / PAGE_SIZE;
+    for (size_t p = 0; p < this->_page_failed.size(); p++)
+    {
+        const address_t page_begin = std::max(run.begin, (first_page + p) * PAGE_SIZE);
+        const address_t page_end = std::min(run.end, (first_page + p + 1) * PAGE_SIZE);
+        const size_t page_size = page_end - page_begin;
+        ++result.calls;
+        if (source.read(page_begin, page_size, this->_staging.data() + (page_begin - run.begin)) != page_size)
+            this->_page_failed[p] = true;
+    }
+    return false;
+}
+
+bool IoBatch::write_run(Process& proc, const Run& run, Result& result)
+{
+    MEMORY_TRACE_SCOPE("write_run", run.begin, run.end - run.begin);
+    const address_t first_page = run.begin / PAGE_SIZE;
+    const size_t n_pages = this->_page_failed.size();
+    bool complete = true;
+
+    // write every stretch of pages that have not failed with one call
+    size_t p = 0;
+    while (p < n_pages)
+    {
+        if (this->_page_failed[p])
+        {
+            complete = false;
+            ++p;
+            continue;
+        }
+        size_t q = p;
+        while (q < n_pages && !this->_page_failed[q])
+            ++q;
+
+        const address_t stretch_begin = std::max(run.begin, (first_page + p) * PAGE_SIZE);
+        const address_t stretch_end = std::min(run.end, (first_page + q) * PAGE_SIZE);
+        const size_t stretch_size = stretch_end - stretch_begin;
+        ++result.calls;
+        if (proc.write(stretch_begin, stretch_size, this->_staging.data() + (stretch_begin - run.begin)) == stretch_size)
+            result.bytes += stretch_size;
+        else
+        {
+            // fall back to single pages to find out which pages are not writable
+            for (size_t i = p; i < q; i++)
+            {
+                const address_t page_begin = std::max(run.begin, (first_page + i) * PAGE_SIZE);
+                const address_t page_end = std::min(run.end, (first_page + i + 1) * PAGE_SIZE);
+                const size_t page_size = page_end - page_begin;
+                ++result.calls;
+                if (proc.write(page_begin, page_size, this->_staging.data() + (page_begin - run.begin)) == page_size)
+                    result.bytes += page_size;
+                else
+                {
+                    this->_page_failed[i] = true;
+                    complete = false;
+                }
+            }
+        }
+        p = q;
+    }
+    return complete;
+}
+
+void IoBatch::mark_failed(const Run& run) noexcept
+{
+    const address_t first_page = run.begin / PAGE_SIZE;
+    for (size_t i = run.first; i < run.last; i++)
+    {
+        Request& r = this->_requests[this->_order[i]];
+        const address_t p0 = r.address / PAGE_SIZE - first_page;
+        const address_t p1 = (r.address + r.size - 1) / PAGE_SIZE - first_page;
+        for (address_t p = p0; p <= p1 && !r.failed; p++)
+            r.failed = this->_page_failed[p];
+    }
+}
+
+IoBatch::Result IoBatch::write(Process& proc, size_t max_gap)
+{
+    Result result = { proc.pid(), this->_requests.size(), 0, 0, 0 };
+    this->build_runs(max_gap);
+
+    std::vector<size_t> run_order;
+    for (const Run& run : this->_runs)
+    {
+        const size_t size = run.end - run.begin;
+        this->_staging.resize(size);
+        this->_page_failed.assign((run.end - 1) / PAGE_SIZE - run.begin / PAGE_SIZE + 1, false);
+
+        // bytes between the requests must be written back unchanged
+        if (run.gaps)
+            this->read_run(proc, run, result);
+
+        // assemble the run locally, requests are copied in the order they have been added
+        run_order.assign(this->_order.begin() + run.first, this->_order.begin() + run.last);
+        std::sort(run_order.begin(), run_order.end());
+        for (size_t i : run_order)
+        {
+            const Request& r = this->_requests[i];
+            memcpy(this->_staging.data() + (r.address - run.begin), r.data, r.size);
+        }
+
+        if (!this->write_run(proc, run, result))
+            this->mark_failed(run);
+    }
+
+    for (const Request& r : this->_requests)
+        result.failed += r.failed ? 1 : 0;
+    return result;
+}
+
+IoBatch::Result IoBatch::read(MemorySource& source, size_t max_gap)
+{
+    Result result = { source.pid(), this->_requests.size(), 0, 0, 0 };
+    this->build_runs(max_gap);
+
+    for (const Run& run : this->_runs)
+    {
+        const size_t size = run.end - run.begin;
+        this->_staging.resize(size);
+        this->_page_failed.assign((run.end - 1) / PAGE_SIZE - run.begin / PAGE_SIZE + 1, false);
+
+        if (this->read_run(source, run, result))
+            result.bytes += size;
+        else
+        {
+            this->mark_failed(run);
+            const address_t first_page = run.begin / PAGE_SIZE;
+            for (size_t p = 0; p < this->_page_failed.size(); p++)
+            {
+                if (!this->_page_failed[p])
+                    result.bytes += std::min(run.end, (first_page + p + 1) * PAGE_SIZE) - std::max(run.begin, (first_page + p) * PAGE_SIZE);
+            }
+        }
+
+        // scatter the run into the requests
+        for (size_t i = run.first; i < run.last; i++)
+        {
+            const Request& r = this->_requests[this->_order[i]];
+            if (!r.failed)
+                memcpy(r.data, this->_staging.data() + (r.address - run.begin), r.size);
+        }
+    }
+
+    for (const Request& r : this->_requests)
+        result.failed += r.failed ? 1 : 0;
+    return result;
+}
@@ -0,0 +1,134 @@
+/**
+* @file     io_batch.h
+* @brief    Definition of the IoBatch-class. Collects many small memory accesses
+*           of one process and executes them with as few remote calls as possible.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "process.h"
+#include <vector>
+
+namespace memory
+{
+    class IoBatch
+    {
+    public:
+        constexpr static size_t PAGE_SIZE       = 0x1000;       // 4kB
+        constexpr static size_t MAX_RUN_SIZE    = 0x100000;     // 1MB
+        constexpr static size_t READ_GAP        = 0x200;        // reading 512 unused bytes is cheaper than a second call
+
+        struct Request
+        {
+            address_t address;
+            size_t size;
+            uint8_t* data;
+            bool failed;
+        };
+
+        struct Result
+        {
+            pid_t pid;
+            uint64_t requests;  // number of requests within the batch
+            uint64_t failed;    // number of requests that could not be transfered completely
+            uint64_t bytes;     // number of bytes actually transfered
+            uint64_t calls;     // number of remote read/write calls
+        };
+
+    private:
+        struct Run
+        {
+            address_t begin, end;
+            size_t first, last;     // indices into '_order', 'last' is exclusive
+            bool gaps;              // indicator if the run contains bytes that are not covered by any request
+        };
+
+        std::vector<Request> _requests;
+        std::vector<size_t> _order;
+        std::vector<Run> _runs;
+        std::vector<uint8_t> _staging;
+        std::vector<bool> _page_failed;
+
+        /**
+        * @brief Sorts the requests by address and merges them into runs.
+        * @param[in] max_gap: maximum number of uncovered bytes between two requests to merge them
+        */
+        void build_runs(size_t max_gap);
+
+        /**
+        * @brief Reads a run into the staging buffer. If the run cannot be read at once,
+        *   it is read page by page and unreadable pages are marked as failed.
+        * @param[in] source: process or file to read from
+        * @param[in] run: run to read
+        * @param[out] result: batch statistics
+        * @return 'true' if the whole run has been read.
+        */
+        bool read_run(MemorySource& source, const Run& run, Result& result);
+
+        /**
+        * @brief Writes the staging buffer to a run. If the run cannot be written at once,
+        *   it is written page by page and unwritable pages are marked as failed.
+        * @param[in] proc: process to write to
+        * @param[in] run: run to write
+        * @param[out] result: batch statistics
+        * @return 'true' if the whole run has been written.
+        */
+        bool write_run(Process& proc, const Run& run, Result& result);
+
+        /**
+        * @brief Marks all requests of a run as failed that overlap a failed page.
+        * @param[in] run: run to check
+        */
+        void mark_failed(const Run& run) noexcept;
+
+    public:
+        IoBatch(void) = default;
+        virtual ~IoBatch(void) = default;
+
+        /**
+        * @brief Adds a request to the batch. The data is not copied, it must stay valid
+        *   until the batch is executed. Several requests may share the same data.
+        * @param[in] address: address in the remote process
+        * @param[in] size: number of bytes
+        * @param[in] data: local data to write from or read into
+        */
+        void add(address_t address, size_t size, void* data);
+        void add(address_t address, size_t size, const void* data) { this->add(address, size, const_cast<void*>(data)); }
+
+        /** @brief Removes all requests. */
+        void clear(void) noexcept;
+
+        /**
+        * @brief Writes all requests to a process.
+        *   Requests that touch each other are merged and written with one call.
+        *   If 'max_gap' is greater than 0, requests with up to 'max_gap' bytes in between are merged as well,
+        *   whereby the bytes in between are read first and written back unchanged.
+        *   If the requests overlap, the request that has been added last wins.
+        * @param[in] proc: process to write to
+        * @param[in] max_gap: maximum number of bytes between two requests to merge them
+        * @return Statistics of the batch.
+        */
+        Result write(Process& proc, size_t max_gap = 0);
+
+        /**
+        * @brief Reads all requests from a process, a snapshot or a core dump.
+        *   Requests with up to 'max_gap' bytes in between are merged and read with one call.
+        * @param[in] source: process or file to read from
+        * @param[in] max_gap: maximum number of bytes between two requests to merge them
+        * @return Statistics of the batch.
+        */
+        Result read(MemorySource& source, size_t max_gap = READ_GAP);
+
+        /** @return Number of requests. */
+        size_t size(void) const noexcept { return this->_requests.size(); }
+
+        /** @return All requests, after execution the 'failed' flag is set for every request. */
+        const std::vector<Request>& requests(void) const noexcept { return this->_requests; }
+    };
+}
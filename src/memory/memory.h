@@ -13,7 +13,24 @@
 
 #include "buffer.h"
 #include "command.h"
+#include "core_dump.h"
+#include "diff.h"
+#include "exporter.h"
+#include "io_batch.h"
+#include "memory_source.h"
 #include "process_handler.h"
 #include "process.h"
+#include "record_reader.h"
+#include "result_file.h"
+#include "rpc.h"
+#include "scanner.h"
+#include "recorder.h"
+#include "screen.h"
+#include "shared_results.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "table.h"
-#include "utility.h"
\ No newline at end of file
+#include "trace.h"
+#include "transform.h"
+#include "utility.h"
+#include "watch.h"
\ No newline at end of file
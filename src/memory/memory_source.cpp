@@ -0,0 +1,161 @@
+/**
+* @file     memory_source.cpp
+* @brief    Implementation of the MappedSource-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "memory_source.h"
+#include "core_dump.h"
+#include "snapshot.h"
+#include "stats.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace memory;
+
+MappedSource::MappedSource(void)
+{
+    this->_file = MEMORY_INVALID_HANDLE;
+    this->_mapping = MEMORY_NULL_HANDLE;
+    this->_view = nullptr;
+    this->_size = 0;
+}
+
+MappedSource::~MappedSource(void)
+{
+    this->unmap();
+}
+
+std::unique_ptr<MappedSource> MappedSource::open_file(const std::string& path)
+{
+    std::unique_ptr<MappedSource> source(new Snapshot());
+    if (source->open(path)) return source;
+    source.reset(new CoreDump());
+    if (source->open(path)) return source;
+    return nullptr;
+}
+
+const uint8_t* MappedSource::map(const std::string& path)
+{
+    this->unmap();
+
+    this->_file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->_file == MEMORY_INVALID_HANDLE) return nullptr;
+
+    // an empty file cannot be mapped
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(this->_file, &size) || size.QuadPart <= 0)
+    {
+        this->unmap();
+        return nullptr;
+    }
+    this->_size = static_cast<uint64_t>(size.QuadPart);
+
+    this->_mapping = CreateFileMapping(this->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->_mapping != MEMORY_NULL_HANDLE)
+        this->_view = reinterpret_cast<const uint8_t*>(MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (this->_view == nullptr)
+        this->unmap();
+    return this->_view;
+}
+
+void MappedSource::unmap(void) noexcept
+{
+    if (this->_view != nullptr)
+        UnmapViewOfFile(this->_view);
+    if (this->_mapping != MEMORY_NULL_HANDLE)
+        CloseHandle(this->_mapping);
+    if (this->_file != MEMORY_INVALID_HANDLE)
+        CloseHandle(this->_file);
+
+    this->_file = MEMORY_INVALID_HANDLE;
+    this->_mapping = MEMORY_NULL_HANDLE;
+    this->_view = nullptr;
+    this->_size = 0;
+    this->_regions.clear();
+}
+
+bool MappedSource::set_regions(std::vector<Region>&& regions)
+{
+    std::sort(regions.begin(), regions.end(), [](const Region& a, const Region& b) { return a.base < b.base; });
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        const Region& r = regions[i];
+        if (r.offset > this->_size || r.size > this->_size - r.offset || r.base + r.size < r.base) return false;
+        if (i > 0 && regions[i - 1].base + regions[i - 1].size > r.base) return false;
+    }
+    this->_regions = std::move(regions);
+    return true;
+}
+
+uint64_t MappedSource::bytes(void) const noexcept
+{
+    uint64_t n = 0;
+    for (const Region& r : this->_regions)
+        n += r.size;
+    return n;
+}
+
+size_t MappedSource::find(address_t address) const noexcept
+{
+    // the last region that begins at or before the address
+    auto it = std::upper_bound(this->_regions.begin(), this->_regions.end(), address,
+                               [](address_t a, const Region& r) { return a < r.base; });
+    if (it == this->_regions.begin()) return this->_regions.size();
+    --it;
+    return (address - it->base < it->size) ? static_cast<size_t>(it - this->_regions.begin()) : this->_regions.size();
+}
+
+const uint8_t* MappedSource::view(address_t address, size_t size) const noexcept
+{
+    const size_t i = this->find(address);
+    if (i == this->_regions.size()) return nullptr;
+    const Region& r = this->_regions[i];
+    if (size > r.size - (address - r.base)) return nullptr;
+    return this->_view + r.offset + (address - r.base);
+}
+
+size_t MappedSource::read(address_t dst, size_t size, void* buff)
+{
+    // like ReadProcessMemory, the bytes may span adjacent regions but all of them must be readable
+    size_t i = this->find(dst);
+    uint8_t* out = static_cast<uint8_t*>(buff);
+    size_t done = 0;
+    while (done < size && i < this->_regions.size())
+    {
+        const Region& r = this->_regions[i];
+        const address_t cur = dst + done;
+        if (cur < r.base || cur - r.base >= r.size) break;
+        const size_t n = std::min<size_t>(size - done, r.size - (cur - r.base));
+        memcpy(out + done, this->_view + r.offset + (cur - r.base), n);
+        done += n;
+        ++i;
+    }
+    Stats::add(MEMORY_STAT_READ_CALLS);
+    Stats::add(MEMORY_STAT_BYTES_READ, done);
+    if (done < size) Stats::add(MEMORY_STAT_READS_FAILED);
+    return (done == size) ? size : 0;
+}
+
+uint32_t MappedSource::query(address_t begin, address_t end, std::vector<MemoryInfo>& mem_infos)
+{
+    mem_infos.clear();
+    auto it = std::upper_bound(this->_regions.begin(), this->_regions.end(), begin,
+                               [](address_t a, const Region& r) { return a < r.base; });
+    if (it != this->_regions.begin() && (it - 1)->base + (it - 1)->size > begin)
+        --it;
+    for (; it != this->_regions.end() && it->base < end; ++it)
+    {
+        MemoryInfo info = {};
+        info.base = it->base;
+        info.size = it->size;
+        mem_infos.push_back(info);
+    }
+    Stats::add(MEMORY_STAT_REGIONS, mem_infos.size());
+    return static_cast<uint32_t>(mem_infos.size());
+}
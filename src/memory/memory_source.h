@@ -0,0 +1,154 @@
+/**
+* @file     memory_source.h
+* @brief    Definition of the MemorySource-interface and the MappedSource-class. Memory that can be
+*           scanned and read like the memory of a process: live processes, snapshots and core dumps.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "types.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    /*
+    * Read-only access to the address space of a process. Sources that keep the memory in a mapped file
+    * return views into the mapping, so that it can be scanned without copying.
+    */
+    class MemorySource
+    {
+    public:
+        virtual ~MemorySource(void) = default;
+
+        /** @return 'true' if the memory can be read. */
+        virtual bool is_valid(void) const noexcept = 0;
+
+        /** @return ID of the process the memory belongs to. */
+        virtual pid_t pid(void) const noexcept = 0;
+
+        /**
+        * @brief Reads memory, like ReadProcessMemory.
+        * @param[in] dst: address to read from
+        * @param[in] size: number of bytes
+        * @param[out] buff: read bytes
+        * @return Number of read bytes.
+        */
+        virtual size_t read(address_t dst, size_t size, void* buff) = 0;
+
+        /**
+        * @brief Queries the readable regions.
+        * @param[in] begin: first address
+        * @param[in] end: address after the last address
+        * @param[out] mem_infos: regions that overlap 'begin' and 'end'
+        * @return Number of regions.
+        */
+        virtual uint32_t query(address_t begin, address_t end, std::vector<MemoryInfo>& mem_infos) = 0;
+
+        /**
+        * @param[in] address: first address
+        * @param[in] size: number of bytes
+        * @return Pointer to the memory without copying it, or nullptr if the source cannot provide one.
+        *   The pointer is valid as long as the source is open.
+        */
+        virtual const uint8_t* view(address_t address, size_t size) const noexcept { return nullptr; }
+    };
+
+    /*
+    * Base of the sources that are stored in a file. The file is mapped read-only and every region
+    * of the address space is a range of the file.
+    */
+    class MappedSource : public MemorySource
+    {
+    public:
+        struct Region
+        {
+            address_t base;
+            size_t size;
+            uint64_t offset;        // offset of the bytes in the file
+        };
+
+    private:
+        HANDLE _file, _mapping;
+        const uint8_t* _view;
+        uint64_t _size;
+        std::vector<Region> _regions;
+
+        /** @return Index of the region that contains the address or the number of regions. */
+        size_t find(address_t address) const noexcept;
+
+    protected:
+        /**
+        * @brief Maps a file read-only.
+        * @param[in] path: path of the file
+        * @return Pointer to the first byte of the file, nullptr if the file could not be mapped.
+        */
+        const uint8_t* map(const std::string& path);
+
+        /** @brief Unmaps and closes the file, and removes the regions. */
+        void unmap(void) noexcept;
+
+        /**
+        * @brief Sets the regions of the address space, they are sorted by base address.
+        * @param[in] regions: regions within the file
+        * @return 'false' if a region is not within the file or the regions overlap.
+        */
+        bool set_regions(std::vector<Region>&& regions);
+
+        /** @return Size of the mapped file. */
+        uint64_t file_size(void) const noexcept { return this->_size; }
+
+    public:
+        MappedSource(void);
+        MappedSource(const MappedSource&) = delete;
+        MappedSource& operator= (const MappedSource&) = delete;
+        virtual ~MappedSource(void);
+
+        /**
+        * @brief Opens a snapshot or a core dump, the format is detected by the header of the file.
+        * @param[in] path: path of the file
+        * @return Opened source, nullptr if the file could not be opened or has an unknown format.
+        */
+        static std::unique_ptr<MappedSource> open_file(const std::string& path);
+
+        /**
+        * @brief Opens and maps the file.
+        * @param[in] path: path of the file
+        * @return 'false' if the file could not be mapped or has not the format of the source.
+        */
+        virtual bool open(const std::string& path) = 0;
+
+        /** @brief Unmaps and closes the file. */
+        virtual void close(void) noexcept { this->unmap(); }
+
+        /** @return 'true' if a file is open. */
+        bool is_open(void) const noexcept { return this->_view != nullptr; }
+        bool is_valid(void) const noexcept override { return this->is_open(); }
+
+        /** @return Name of the format. */
+        virtual const char* format(void) const noexcept = 0;
+
+        /** @return Time the memory has been saved, in seconds since 1970, 0 if it is unknown. */
+        virtual uint64_t time(void) const noexcept { return 0; }
+
+        /** @return Readable bytes of all regions. */
+        uint64_t bytes(void) const noexcept;
+
+        /** @return All regions, sorted by base address. */
+        const std::vector<Region>& regions(void) const noexcept { return this->_regions; }
+
+        /** @brief Reads memory, the bytes may span adjacent regions but all of them must be within a region. */
+        size_t read(address_t dst, size_t size, void* buff) override;
+        uint32_t query(address_t begin, address_t end, std::vector<MemoryInfo>& mem_infos) override;
+
+        /** @return Pointer into the mapped file, or nullptr if the bytes are not within one region. */
+        const uint8_t* view(address_t address, size_t size) const noexcept override;
+    };
+}
@@ -10,89 +10,190 @@
 */
 
 #include "process.h"
+#include "stats.h"
 #include <TlHelp32.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 using namespace memory;
 
-uint32_t Process::count_processes(bool accessable) noexcept
+namespace
 {
-    HANDLE snap_proc = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (!snap_proc) return 0;
+    enum access_t : uint8_t
+    {
+        ACCESS_UNKNOWN = 0x0,
+        ACCESS_DENIED = 0x1,
+        ACCESS_GRANTED = 0x2
+    };
 
-    uint32_t cnt = 0;
-    PROCESSENTRY32 entry;
-    entry.dwSize = sizeof(PROCESSENTRY32);
+    struct CachedProcess
+    {
+        std::string name;
+        memory::pid_t ppid;
+        uint32_t thread_count;
+        uint64_t created;           // creation time of the process, 0 if it could not be queried
+        uint64_t generation;        // last enumeration the process has been seen in
+        access_t access;            // only a granted access is kept, a denied access is tested again
+    };
 
-    // get first process
-    if (Process32First(snap_proc, &entry))
+    /*
+    * Processes of the last enumeration by process ID. Every enumeration only adds new processes,
+    * removes exited processes and updates the thread count, so that an accessable process is
+    * opened only once instead of on every enumeration.
+    */
+    std::mutex cache_mutex;
+    std::unordered_map<memory::pid_t, CachedProcess> cache;
+    uint64_t cache_generation = 0;
+
+    /** @return Creation time of the process, 0 if the process could not be queried. */
+    uint64_t creation_time(memory::pid_t pid) noexcept
     {
-        // get all other processes and count them
-        do
+        HANDLE hp = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, false, pid);
+        if (hp == MEMORY_NULL_HANDLE || hp == MEMORY_INVALID_HANDLE) return 0;
+
+        FILETIME created, exited, kernel, user;
+        const bool ok = GetProcessTimes(hp, &created, &exited, &kernel, &user);
+        CloseHandle(hp);
+        return ok ? (static_cast<uint64_t>(created.dwHighDateTime) << 32) | created.dwLowDateTime : 0;
+    }
+
+    /** @brief Enumerates the processes into the cache, the cache must be locked. */
+    bool refresh_cache(void)
+    {
+        HANDLE snap_proc = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snap_proc == MEMORY_INVALID_HANDLE) return false;
+
+        const uint64_t generation = ++cache_generation;
+        PROCESSENTRY32 entry;
+        entry.dwSize = sizeof(PROCESSENTRY32);
+        if (Process32First(snap_proc, &entry))
         {
-            // count only accessable processes, otherwise count all processes
-            if (accessable)
+            do
             {
-                HANDLE hp = OpenProcess(PROCESS_ALL_ACCESS, false, entry.th32ProcessID);
-                if (hp != MEMORY_NULL_HANDLE && hp != MEMORY_INVALID_HANDLE)
-                    ++cnt;
-            }
-            else
-                ++cnt;
-        } while (Process32Next(snap_proc, &entry));
+                // a known PID with another executable or parent has been reused by a new process
+                CachedProcess& p = cache[entry.th32ProcessID];
+                if (p.generation == 0 || p.name != entry.szExeFile || p.ppid != entry.th32ParentProcessID)
+                    p = { entry.szExeFile, entry.th32ParentProcessID, 0, creation_time(entry.th32ProcessID), 0, ACCESS_UNKNOWN };
+                p.thread_count = entry.cntThreads;
+                p.generation = generation;
+            } while (Process32Next(snap_proc, &entry));
+        }
+        CloseHandle(snap_proc);
+
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            if (it->second.generation != generation)    it = cache.erase(it);
+            else                                        ++it;
+        }
+        return true;
+    }
+
+    /** @return 'true' if the process can be opened like Process::open does, the handle is closed again. */
+    bool is_accessable(memory::pid_t pid, CachedProcess& p) noexcept
+    {
+        // the access of a process can change while it runs (e.g. a protected process), so only a granted access is cached
+        if (p.access != ACCESS_GRANTED)
+        {
+            HANDLE hp = OpenProcess(PROCESS_ALL_ACCESS, false, pid);
+            const bool granted = (hp != MEMORY_NULL_HANDLE && hp != MEMORY_INVALID_HANDLE);
+            if (granted)
+                CloseHandle(hp);
+            p.access = granted ? ACCESS_GRANTED : ACCESS_DENIED;
+        }
+        return p.access == ACCESS_GRANTED;
+    }
+
+    /** @return 'true' if the cached process is still running, 'false' if it has exited or the PID has been reused. */
+    bool is_running(memory::pid_t pid, const CachedProcess& p) noexcept
+    {
+        if (p.created == 0) return false;
+        HANDLE hp = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, false, pid);
+        if (hp == MEMORY_NULL_HANDLE || hp == MEMORY_INVALID_HANDLE) return false;
+
+        // a reused PID belongs to a process with another creation time, even if it runs the same executable
+        DWORD exit_code = 0;
+        FILETIME created, exited, kernel, user;
+        const bool running = (GetExitCodeProcess(hp, &exit_code) && exit_code == STILL_ACTIVE && GetProcessTimes(hp, &created, &exited, &kernel, &user));
+        CloseHandle(hp);
+        return running && ((static_cast<uint64_t>(created.dwHighDateTime) << 32) | created.dwLowDateTime) == p.created;
+    }
+}
+
+uint32_t Process::count_processes(bool accessable) noexcept
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (!refresh_cache()) return 0;
+    if (!accessable) return static_cast<uint32_t>(cache.size());
+
+    uint32_t cnt = 0;
+    for (auto& p : cache)
+    {
+        if (is_accessable(p.first, p.second))
+            ++cnt;
     }
     return cnt;
 }
 
 bool Process::enum_processes(bool accessable, std::vector<Process>& processes)
 {
-    HANDLE snap_proc = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (!snap_proc) return false;
-
-    Process p;
-    PROCESSENTRY32 entry;
-    entry.dwSize = sizeof(PROCESSENTRY32);
     processes.clear();
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (!refresh_cache()) return false;
 
-    // get first process
-    if (Process32First(snap_proc, &entry))
+        processes.reserve(cache.size());
+        for (auto& p : cache)
+        {
+            // list only accessable processes, otherwise list all processes
+            if (accessable && !is_accessable(p.first, p.second)) continue;
+            processes.emplace_back();
+            processes.back().init(p.second.name, p.first, p.second.ppid, p.second.thread_count);
+        }
+    }
+    std::sort(processes.begin(), processes.end());
+    return true;
+}
+
+bool Process::enum_modules(pid_t pid, std::vector<ModuleInfo>& modules)
+{
+    modules.clear();
+    HANDLE snap_mod = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+    if (snap_mod == MEMORY_INVALID_HANDLE) return false;
+
+    MODULEENTRY32 entry;
+    entry.dwSize = sizeof(MODULEENTRY32);
+    if (Module32First(snap_mod, &entry))
     {
-        // get all other processes
         do
         {
-            // list only accessable processes, otherwise list all processes
-            if (accessable)
-            {
-                HANDLE hp = OpenProcess(PROCESS_ALL_ACCESS, false, entry.th32ProcessID);
-                if (hp != MEMORY_NULL_HANDLE && hp != MEMORY_INVALID_HANDLE)
-                {
-                    p.init(entry.szExeFile, entry.th32ProcessID, entry.th32ParentProcessID, entry.cntThreads);
-                    processes.push_back(std::move(p));
-                }
-            }
-            else
-            {
-                p.init(entry.szExeFile, entry.th32ProcessID, entry.th32ParentProcessID, entry.cntThreads);
-                processes.push_back(std::move(p));
-            }
-        } while (Process32Next(snap_proc, &entry));
+            modules.push_back({ entry.szModule, reinterpret_cast<address_t>(entry.modBaseAddr), entry.modBaseSize });
+        } while (Module32Next(snap_mod, &entry));
     }
+    CloseHandle(snap_mod);
 
+    std::sort(modules.begin(), modules.end(), [](const ModuleInfo& a, const ModuleInfo& b) { return a.base < b.base; });
     return true;
 }
 
 bool Process::find_process(pid_t pid, Process& p) noexcept
 {
-    std::vector<Process> processes;
-    enum_processes(false, processes);
-    for (Process& cp : processes)
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    // a cached process is used directly as long as it runs, only unknown PIDs need a new enumeration,
+    // the thread count of a cached process is the one of the last enumeration
+    auto it = cache.find(pid);
+    if (it == cache.end() || !is_running(pid, it->second))
     {
-        if (cp.pid() == pid)
-        {
-            p = std::move(cp);
-            return true;
-        }
+        // the entry is removed, so that a reused PID gets its new parent and access
+        if (it != cache.end())
+            cache.erase(it);
+        if (!refresh_cache()) return false;
+        it = cache.find(pid);
+        if (it == cache.end()) return false;
     }
-    return false;
+    p.init(it->second.name, pid, it->second.ppid, it->second.thread_count);
+    return true;
 }
 
 bool Process::find_process(const std::string& win_name, Process& p) noexcept
@@ -150,14 +251,17 @@ void Process::close(void) noexcept
 
 size_t Process::read(address_t dst, size_t size, void* buff)
 {
-    size_t rd_bytes;
+    size_t rd_bytes = 0;
     ReadProcessMemory(this->_proc_handle, reinterpret_cast<const void*>(dst), buff, size, &rd_bytes);
+    Stats::add(MEMORY_STAT_READ_CALLS);
+    Stats::add(MEMORY_STAT_BYTES_READ, rd_bytes);
+    if (rd_bytes < size) Stats::add(MEMORY_STAT_READS_FAILED);
     return rd_bytes;
 }
 
 size_t Process::write(address_t dst, size_t size, const void* buff)
 {
-    size_t wr_bytes;
+    size_t wr_bytes = 0;
     WriteProcessMemory(this->_proc_handle, reinterpret_cast<void*>(dst), buff, size, &wr_bytes);
     return wr_bytes;
 }
@@ -174,8 +278,13 @@ uint32_t Process::query(address_t begin, address_t end, std::vector<MemoryInfo>&
     while (cur < end && !finish)
     {
         finish = (VirtualQueryEx(this->_proc_handle, reinterpret_cast<const void*>(cur), &info, sizeof(MEMORY_BASIC_INFORMATION)) == 0);
+        if (finish) break;
+        Stats::add(MEMORY_STAT_REGIONS);
+
         // memory must be committed, which means it is in use and must have access rights (the no-access bit must not be set)
-        if (!finish && (info.State & MEM_COMMIT) != 0 && (info.Protect & PAGE_NOACCESS) == 0)
+        if ((info.State & MEM_COMMIT) == 0 || (info.Protect & PAGE_NOACCESS) != 0)
+            Stats::add(MEMORY_STAT_REGIONS_SKIPPED);
+        else
         {
             MemoryInfo mem_info;
             mem_info.base = reinterpret_cast<address_t>(info.BaseAddress);
@@ -12,16 +12,18 @@
 #pragma once
 
 #include "types.h"
+#include "memory_source.h"
 #include <vector>
 #include <string>
 
 namespace memory
 {
-    class Process
+    class Process : public MemorySource
     {
     public:
         /**
         * @brief Counts the number of processes running on the system.
+        *   The processes are cached, the access of a process is tested until it has been granted once.
         * @param[in] accessable: indicator if only accessable processes should be counted
         * @return Number of processes running on the system.
         */
@@ -36,9 +38,12 @@ namespace memory
         static bool enum_processes(bool accessable, std::vector<Process>& processes);
 
         /**
-        * @brief Finds the process ID of a window.
-        * @param[in] win_name: ID of the process
-        * @return 'true' if a window was found, 'false' if no window was found.
+        * @brief Finds a process by its ID. A process of the last enumeration is taken from the cache if
+        *   it is still running, otherwise the processes are enumerated again.
+        *   NOTE: The thread count of a cached process is the one of the last enumeration.
+        * @param[in] pid: ID of the process
+        * @param[out] p: found process, NOTE: the process has not been opened
+        * @return 'true' if the process was found, 'false' if no process was found.
         */
         static bool find_process(pid_t pid, Process& p) noexcept;
 
@@ -49,6 +54,14 @@ namespace memory
         */
         static bool find_process(const std::string& win_name, Process& p) noexcept;
 
+        /**
+        * @brief Enumerates all modules (executable and DLLs) of a process.
+        * @param[in] pid: ID of the process
+        * @param[out] modules: modules of the process sorted by base address
+        * @return 'true' if the modules could be enumerated.
+        */
+        static bool enum_modules(pid_t pid, std::vector<ModuleInfo>& modules);
+
     private:
         HANDLE _proc_handle;
         std::string _proc_name;
@@ -99,7 +112,7 @@ namespace memory
         * @param[out] buff: buffer where the read data gets stored
         * @return number of actually read bytes
         */
-        size_t read(address_t dst, size_t size, void* buff);
+        size_t read(address_t dst, size_t size, void* buff) override;
 
         /**
         * @brief Write data to the current open process.
@@ -118,13 +131,13 @@ namespace memory
         * @param[out] modules: info to memory pages
         * @return Number of queried memory pages.
         */
-        uint32_t query(address_t begin, address_t end, std::vector<MemoryInfo>& mem_infos);
+        uint32_t query(address_t begin, address_t end, std::vector<MemoryInfo>& mem_infos) override;
 
         /** @return Name of the process. */
         const std::string& name(void) const noexcept { return this->_proc_name; }
 
         /**  @return ID of the process.*/
-        pid_t pid(void) const noexcept { return this->_pid; }
+        pid_t pid(void) const noexcept override { return this->_pid; }
 
         /** @return ID of the parent process. */
         pid_t parent_pid(void) const noexcept { return this->_ppid; }
@@ -133,7 +146,7 @@ namespace memory
         uint32_t count_threads(void) const noexcept { return this->_thread_count; }
 
         /** @return 'true' if the process is valid, 'false' if the process is invalid. */
-        bool is_valid(void) const noexcept { return (this->_proc_handle != MEMORY_NULL_HANDLE && this->_proc_handle != MEMORY_INVALID_HANDLE); }
+        bool is_valid(void) const noexcept override { return (this->_proc_handle != MEMORY_NULL_HANDLE && this->_proc_handle != MEMORY_INVALID_HANDLE); }
 
         /**
         * @brief Copies the process.
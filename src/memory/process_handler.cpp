@@ -10,13 +10,15 @@
 */
 
 #include "process_handler.h"
+#include <cstring>
 #include <stdexcept>
-#include <vector>
 
 using namespace memory;
 
 ProcessHandler::ProcessHandler(void)
 {
+    this->exited = 0;
+
     // initialize job object to make processes depend on the current application
     this->job = CreateJobObject(nullptr, nullptr);
 
@@ -33,11 +35,12 @@ ProcessHandler::ProcessHandler(void)
 ProcessHandler::~ProcessHandler(void)
 {
     // terminate all processes and close their handles
-    for (const std::pair<pid_t, PROCESS_INFORMATION>& ppi : this->processes)
+    while (!this->processes.empty())
     {
-        TerminateProcess(ppi.second.hProcess, 0);
-        WaitForSingleObject(ppi.second.hProcess, INFINITE);
-        CloseHandle(ppi.second.hProcess);
+        auto it = this->processes.begin();
+        TerminateProcess(it->second.process, 0);
+        WaitForSingleObject(it->second.process, INFINITE);
+        this->release(it);
     }
     // destroy the job object handle
     CloseHandle(this->job);
@@ -45,10 +48,10 @@ ProcessHandler::~ProcessHandler(void)
 
 pid_t ProcessHandler::start_process(const std::string& path, const std::string& args) noexcept
 {
-    // make a cleanup that all terminated processes are removed from the map
+    // remove all processes that have terminated
     this->cleanup();
 
-    // start the process and assign it to the job
+    // start the process suspended, so that it belongs to the job before it can start other processes
     std::string _args = args;
     STARTUPINFO si;
     PROCESS_INFORMATION pi;
@@ -56,55 +59,71 @@ pid_t ProcessHandler::start_process(const std::string& path, const std::string&
     memset(&pi, 0, sizeof(pi));
     si.cb = sizeof(si);
 
-    if (!CreateProcess(path.c_str(), _args.data(), nullptr, nullptr, false, CREATE_NEW_CONSOLE, nullptr, nullptr, &si, &pi))
+    if (!CreateProcess(path.c_str(), _args.data(), nullptr, nullptr, false, CREATE_NEW_CONSOLE | CREATE_SUSPENDED, nullptr, nullptr, &si, &pi))
         return MEMORY_PID_INVALID;
 
     AssignProcessToJobObject(this->job, pi.hProcess);
-    this->processes[pi.dwProcessId] = pi;
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+
+    // the thread pool reports the exit of the process, the map node does not move until it is released
+    Child& child = this->processes[pi.dwProcessId];
+    child.handler = this;
+    child.process = pi.hProcess;
+    child.wait = MEMORY_NULL_HANDLE;
+    child.exited = false;
+    if (!RegisterWaitForSingleObject(&child.wait, pi.hProcess, &ProcessHandler::on_exit, &child, INFINITE, WT_EXECUTEONLYONCE))
+        child.wait = MEMORY_NULL_HANDLE;
     return pi.dwProcessId;
 }
 
 bool ProcessHandler::stop_process(pid_t pid) noexcept
 {
-    // make a cleanup that all terminated processes are removed from the map
+    // remove all processes that have terminated
     this->cleanup();
-    if (this->processes.count(pid) == 0) return false;
+    auto it = this->processes.find(pid);
+    if (it == this->processes.end()) return false;
 
     // terminate process and close its handle
-    const PROCESS_INFORMATION& pi = this->processes[pid];
-    TerminateProcess(pi.hProcess, 0);
-    WaitForSingleObject(pi.hProcess, INFINITE);
-    CloseHandle(pi.hProcess);
-    this->processes.erase(pid);
+    TerminateProcess(it->second.process, 0);
+    WaitForSingleObject(it->second.process, INFINITE);
+    this->release(it);
     return true;
 }
 
-bool ProcessHandler::is_process_running(pid_t pid) noexcept
+bool ProcessHandler::is_running(pid_t pid) noexcept
+{
+    this->cleanup();
+    return this->processes.count(pid) > 0;
+}
+
+void CALLBACK ProcessHandler::on_exit(void* param, BOOLEAN timed_out)
 {
-    // check if process is still running
-    process_t process = OpenProcess(SYNCHRONIZE, false, pid);   // open process
-    DWORD ret = WaitForSingleObject(process, 0);                // get return value of process
-    CloseHandle(process);                                       // close process
-    return (ret == WAIT_TIMEOUT);                               // true if process is still running
+    Child* child = static_cast<Child*>(param);
+    child->exited = true;
+    child->handler->exited++;
+}
+
+void ProcessHandler::release(std::map<pid_t, Child>::iterator it) noexcept
+{
+    // waits until a running callback has returned, the child must not be removed before
+    if (it->second.wait != MEMORY_NULL_HANDLE)
+        UnregisterWaitEx(it->second.wait, MEMORY_INVALID_HANDLE);
+    if (it->second.exited)
+        this->exited--;
+    CloseHandle(it->second.process);
+    this->processes.erase(it);
 }
 
 void ProcessHandler::cleanup(void) noexcept
 {
     // remove all processes from the map that have been terminated
     // without a call to ProcessHandler::stop_process
-
-    // get all pids that have been terminated
-    std::vector<pid_t> terminated_pids;
-    for (const std::pair<pid_t, PROCESS_INFORMATION>& ppi : this->processes)
+    if (this->exited == 0) return;
+    for (auto it = this->processes.begin(); it != this->processes.end();)
     {
-        if (!is_process_running(ppi.first))
-        {
-            CloseHandle(ppi.second.hProcess);   // to make sure that the handle is 100% closed even if the process has been terminated
-            terminated_pids.push_back(ppi.first);
-        }
+        auto cur = it++;
+        if (cur->second.exited)
+            this->release(cur);
     }
-
-    // remove them from the map
-    for (pid_t pid : terminated_pids)
-        this->processes.erase(pid);
 }
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "types.h"
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -20,20 +21,35 @@ namespace memory
     class ProcessHandler
     {
     private:
+        struct Child
+        {
+            ProcessHandler* handler;
+            process_t process;
+            HANDLE wait;                // wait of the thread pool for the exit of the process
+            std::atomic_bool exited;    // set by the wait callback
+        };
+
         job_t job;
         JOBOBJECT_EXTENDED_LIMIT_INFORMATION extended_limit_info;
-        std::map<pid_t, PROCESS_INFORMATION> processes;
+        std::map<pid_t, Child> processes;
+        std::atomic<uint32_t> exited;   // number of exited processes that have not been removed yet
+
+        /**
+        * @brief Called by the thread pool when a process has exited.
+        * @param[in] param: child of the process
+        * @param[in] timed_out: always 'false', the wait has no timeout
+        */
+        static void CALLBACK on_exit(void* param, BOOLEAN timed_out);
 
         /**
-        * @brief Checks if a process is running.
-        * @param[in] pid: process id of the process to check
-        * @return 'true' if process is running and 'false' if not
+        * @brief Stops waiting for the process and closes its handle, the child is removed from the map.
+        * @param[in] it: child to remove
         */
-        bool is_process_running(pid_t pid) noexcept;
+        void release(std::map<pid_t, Child>::iterator it) noexcept;
 
         /**
         * @brief Removes all processes that have not been closed by a call to ProcessHandler::stop_process,
-        *   for example by clicking on the close button.
+        *   for example by clicking on the close button. Nothing is done if no process has exited.
         */
         void cleanup(void) noexcept;
 
@@ -56,5 +72,11 @@ namespace memory
         *   'false' if the process had already been terminated before.
         */
         bool stop_process(pid_t pid) noexcept;
+
+        /**
+        * @param[in] pid: pid of a process that has been started by this handler
+        * @return 'true' if the process is still running, the exit is known without asking the system.
+        */
+        bool is_running(pid_t pid) noexcept;
     };
 }
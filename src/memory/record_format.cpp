@@ -0,0 +1,291 @@
+/**
+* @file     record_format.cpp
+* @brief    Implementation of the compression of recordings.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "record_format.h"
+#include <cstring>
+
+using namespace memory;
+
+namespace
+{
+    inline uint64_t zigzag(uint64_t x) noexcept     { return (x << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(x) >> 63); }
+    inline uint64_t unzigzag(uint64_t x) noexcept   { return (x >> 1) ^ (~(x & 1) + 1); }
+
+    inline void put_varint(uint64_t x, std::vector<uint8_t>& out)
+    {
+        while (x >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(x) | 0x80);
+            x >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(x));
+    }
+
+    inline bool get_varint(const uint8_t*& in, const uint8_t* end, uint64_t& x) noexcept
+    {
+        x = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            if (in == end) return false;
+            const uint8_t b = *in++;
+            x |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    /*
+    * Delta-of-delta encoding on 64 bit values with wrap around arithmetic,
+    * so that unsigned values do not overflow signed integers.
+    */
+    void encode_dod(const uint64_t* x, size_t count, std::vector<uint8_t>& out)
+    {
+        uint64_t prev = 0, prev_delta = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t delta = x[i] - prev;
+            put_varint(zigzag(delta - prev_delta), out);
+            prev_delta = delta;
+            prev = x[i];
+        }
+    }
+
+    bool decode_dod(const uint8_t*& in, const uint8_t* end, size_t count, uint64_t* x) noexcept
+    {
+        uint64_t prev = 0, prev_delta = 0, v;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!get_varint(in, end, v)) return false;
+            prev_delta += unzigzag(v);
+            prev += prev_delta;
+            x[i] = prev;
+        }
+        return true;
+    }
+
+    class BitWriter
+    {
+    private:
+        std::vector<uint8_t>& _out;
+        uint32_t _free;     // number of unused bits in the last byte
+
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : _out(out), _free(0) {}
+
+        /** @brief Writes the lowest 'bits' bits of 'x', the most significant bit first. */
+        void write(uint64_t x, uint32_t bits)
+        {
+            while (bits > 0)
+            {
+                if (this->_free == 0)
+                {
+                    this->_out.push_back(0);
+                    this->_free = 8;
+                }
+                const uint32_t n = (bits < this->_free) ? bits : this->_free;
+                const uint64_t chunk = (x >> (bits - n)) & ((1ULL << n) - 1);
+                this->_out.back() |= static_cast<uint8_t>(chunk << (this->_free - n));
+                this->_free -= n;
+                bits -= n;
+            }
+        }
+    };
+
+    class BitReader
+    {
+    private:
+        const uint8_t* _in;
+        size_t _size, _pos;     // size and position in bits
+
+    public:
+        BitReader(const uint8_t* in, size_t size) : _in(in), _size(size * 8), _pos(0) {}
+
+        bool read(uint32_t bits, uint64_t& x) noexcept
+        {
+            if (this->_pos + bits > this->_size) return false;
+            x = 0;
+            while (bits > 0)
+            {
+                const uint32_t used = this->_pos % 8;
+                const uint32_t n = (bits < 8 - used) ? bits : 8 - used;
+                const uint8_t b = this->_in[this->_pos / 8];
+                x = (x << n) | ((b >> (8 - used - n)) & ((1U << n) - 1));
+                this->_pos += n;
+                bits -= n;
+            }
+            return true;
+        }
+    };
+
+    /*
+    * Gorilla encoding of 'width' bit values:
+    *   first value:                    'width' bits
+    *   x ^ prev == 0:                  '0'
+    *   meaningful bits fit the window: '10' + bits within the previous window
+    *   otherwise:                      '11' + 6 bits leading zeros + 6 bits (length - 1) + meaningful bits
+    */
+    void encode_xor(const uint64_t* x, size_t count, uint32_t width, std::vector<uint8_t>& out)
+    {
+        if (count == 0) return;
+        BitWriter w(out);
+        w.write(x[0], width);
+
+        uint32_t prev_lead = width + 1, prev_trail = 0;
+        for (size_t i = 1; i < count; i++)
+        {
+            const uint64_t d = x[i] ^ x[i - 1];
+            if (d == 0)
+            {
+                w.write(0, 1);
+                continue;
+            }
+
+            const uint32_t lead = __builtin_clzll(d) - (64 - width);
+            const uint32_t trail = __builtin_ctzll(d);
+            if (prev_lead <= width && lead >= prev_lead && trail >= prev_trail)
+            {
+                w.write(0x2, 2);
+                w.write(d >> prev_trail, width - prev_lead - prev_trail);
+            }
+            else
+            {
+                const uint32_t len = width - lead - trail;
+                w.write(0x3, 2);
+                w.write(lead, 6);
+                w.write(len - 1, 6);
+                w.write(d >> trail, len);
+                prev_lead = lead;
+                prev_trail = trail;
+            }
+        }
+    }
+
+    bool decode_xor(const uint8_t* in, size_t size, size_t count, uint32_t width, uint64_t* x) noexcept
+    {
+        if (count == 0) return true;
+        BitReader r(in, size);
+        if (!r.read(width, x[0])) return false;
+
+        uint32_t prev_lead = width + 1, prev_trail = 0;
+        uint64_t bit, v;
+        for (size_t i = 1; i < count; i++)
+        {
+            if (!r.read(1, bit)) return false;
+            if (bit == 0)
+            {
+                x[i] = x[i - 1];
+                continue;
+            }
+
+            if (!r.read(1, bit)) return false;
+            if (bit == 1)
+            {
+                uint64_t lead, len;
+                if (!r.read(6, lead) || !r.read(6, len)) return false;
+                if (lead + len + 1 > width) return false;
+                prev_lead = static_cast<uint32_t>(lead);
+                prev_trail = width - prev_lead - static_cast<uint32_t>(len + 1);
+            }
+            else if (prev_lead > width)
+                return false;
+
+            if (!r.read(width - prev_lead - prev_trail, v)) return false;
+            x[i] = x[i - 1] ^ (v << prev_trail);
+        }
+        return true;
+    }
+
+    /** @brief Loads a packed value as 64 bit integer, signed values are sign extended. */
+    inline uint64_t load(const uint8_t* p, size_t size, bool is_signed) noexcept
+    {
+        uint64_t x = 0;
+        memcpy(&x, p, size);
+        if (is_signed && size < 8)
+        {
+            const uint32_t shift = 64 - static_cast<uint32_t>(size) * 8;
+            x = static_cast<uint64_t>(static_cast<int64_t>(x << shift) >> shift);
+        }
+        return x;
+    }
+
+    inline bool is_signed_type(type_t type) noexcept
+    {
+        return type == MEMORY_TYPE_INT8 || type == MEMORY_TYPE_INT16 || type == MEMORY_TYPE_INT32 || type == MEMORY_TYPE_INT64;
+    }
+}
+
+void record::encode_times(const uint64_t* times, size_t count, std::vector<uint8_t>& out)
+{
+    encode_dod(times, count, out);
+}
+
+bool record::decode_times(const uint8_t* in, size_t size, size_t count, uint64_t* times)
+{
+    const uint8_t* p = in;
+    return decode_dod(p, in + size, count, times);
+}
+
+void record::encode_column(type_t type, size_t size, const uint8_t* values, const uint8_t* valid, size_t count, std::vector<uint8_t>& out)
+{
+    // the validity bitmap is only stored if at least one value is not valid
+    bool all_valid = true;
+    for (size_t i = 0; i < count && all_valid; i++)
+        all_valid = (valid[i] != 0);
+
+    out.push_back(all_valid ? 0 : COLUMN_FLAG_VALIDITY);
+    if (!all_valid)
+    {
+        const size_t first = out.size();
+        out.resize(first + (count + 7) / 8, 0);
+        for (size_t i = 0; i < count; i++)
+            out[first + i / 8] |= (valid[i] ? 1 : 0) << (i % 8);
+    }
+
+    std::vector<uint64_t> x(count);
+    const bool is_signed = is_signed_type(type);
+    for (size_t i = 0; i < count; i++)
+        x[i] = load(values + i * size, size, is_signed);
+
+    if (type == MEMORY_TYPE_FLOAT || type == MEMORY_TYPE_DOUBLE)
+        encode_xor(x.data(), count, static_cast<uint32_t>(size * 8), out);
+    else
+        encode_dod(x.data(), count, out);
+}
+
+bool record::decode_column(type_t type, size_t size, const uint8_t* in, size_t in_size, size_t count, uint8_t* values, uint8_t* valid)
+{
+    if (in_size < 1 || size == 0 || size > VALUE_SIZE) return false;
+    const uint8_t* p = in;
+    const uint8_t* end = in + in_size;
+
+    const uint8_t flags = *p++;
+    if (flags & COLUMN_FLAG_VALIDITY)
+    {
+        if (static_cast<size_t>(end - p) < (count + 7) / 8) return false;
+        for (size_t i = 0; i < count; i++)
+            valid[i] = (p[i / 8] >> (i % 8)) & 1;
+        p += (count + 7) / 8;
+    }
+    else
+        memset(valid, 1, count);
+
+    std::vector<uint64_t> x(count);
+    bool ok;
+    if (type == MEMORY_TYPE_FLOAT || type == MEMORY_TYPE_DOUBLE)
+        ok = decode_xor(p, end - p, count, static_cast<uint32_t>(size * 8), x.data());
+    else
+        ok = decode_dod(p, end, count, x.data());
+    if (!ok) return false;
+
+    for (size_t i = 0; i < count; i++)
+        memcpy(values + i * size, &x[i], size);
+    return true;
+}
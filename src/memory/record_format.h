@@ -0,0 +1,136 @@
+/**
+* @file     record_format.h
+* @brief    File format and compression of recordings of watched addresses.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "types.h"
+#include <vector>
+
+/*
+* Layout of a recording (all numbers are little endian):
+*   FileHeader
+*   ColumnInfo[column_count]
+*   Chunk[chunk_count]:
+*       ChunkHeader
+*       time block      'time_bytes' bytes, delta-of-delta encoded timestamps
+*       column blocks   per column: uint32_t size, uint8_t flags, [validity bitmap], encoded values
+*   IndexEntry[chunk_count]
+*   IndexFooter
+*
+* Timestamps are microseconds since the start of the recording.
+* Integers are encoded as zigzag varints of their delta-of-delta, floating point values
+* are XOR-ed with their predecessor and only the meaningful bits are stored (Gorilla encoding).
+* If the index is missing because the recording has not been finished, it can be rebuilt
+* by walking through the chunks.
+*/
+
+namespace memory
+{
+    namespace record
+    {
+        constexpr uint32_t FILE_MAGIC       = 0x4345524D;   // "MREC"
+        constexpr uint32_t CHUNK_MAGIC      = 0x4B4E4843;   // "CHNK"
+        constexpr uint32_t INDEX_MAGIC      = 0x5844494D;   // "MIDX"
+        constexpr uint32_t VERSION          = 1;
+        constexpr uint32_t CHUNK_SAMPLES    = 1024;         // maximum number of samples per chunk
+        constexpr size_t VALUE_SIZE         = 8;            // maximum size of a recorded value
+
+        constexpr uint8_t COLUMN_FLAG_VALIDITY = 0x1;       // the column block contains a validity bitmap
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t start_time;        // unix time in milliseconds
+            uint32_t rate;              // requested samples per second
+            uint32_t column_count;
+        };
+
+        struct ColumnInfo
+        {
+            uint32_t pid;
+            uint8_t type;
+            uint8_t size;
+            uint16_t reserved;
+            uint64_t address;
+        };
+
+        struct ChunkHeader
+        {
+            uint32_t magic;
+            uint32_t samples;
+            uint64_t first_time;
+            uint64_t last_time;
+            uint32_t time_bytes;
+            uint32_t payload_bytes;     // number of bytes after the chunk header
+        };
+
+        struct IndexEntry
+        {
+            uint64_t first_time;
+            uint64_t last_time;
+            uint64_t offset;            // file offset of the chunk header
+            uint32_t samples;
+        };
+
+        struct IndexFooter
+        {
+            uint32_t magic;
+            uint32_t chunk_count;
+            uint64_t index_offset;
+        };
+#pragma pack(pop)
+
+        /**
+        * @brief Encodes timestamps with delta-of-delta zigzag varints.
+        * @param[in] times: timestamps
+        * @param[in] count: number of timestamps
+        * @param[out] out: encoded bytes are appended
+        */
+        void encode_times(const uint64_t* times, size_t count, std::vector<uint8_t>& out);
+
+        /**
+        * @brief Decodes timestamps.
+        * @param[in] in: encoded bytes
+        * @param[in] size: number of encoded bytes
+        * @param[in] count: number of timestamps
+        * @param[out] times: decoded timestamps
+        * @return 'false' if the encoded data is corrupt.
+        */
+        bool decode_times(const uint8_t* in, size_t size, size_t count, uint64_t* times);
+
+        /**
+        * @brief Encodes a column of packed values.
+        *   Values that are not valid should be replaced by their predecessor before, to not disturb the compression.
+        * @param[in] type: type of the values
+        * @param[in] size: size of one value, at most VALUE_SIZE
+        * @param[in] values: packed values
+        * @param[in] valid: validity of every value (1 or 0)
+        * @param[in] count: number of values
+        * @param[out] out: encoded bytes are appended, without the leading size
+        */
+        void encode_column(type_t type, size_t size, const uint8_t* values, const uint8_t* valid, size_t count, std::vector<uint8_t>& out);
+
+        /**
+        * @brief Decodes a column of packed values.
+        * @param[in] type: type of the values
+        * @param[in] size: size of one value
+        * @param[in] in: encoded bytes
+        * @param[in] in_size: number of encoded bytes
+        * @param[in] count: number of values
+        * @param[out] values: decoded packed values, 'count * size' bytes
+        * @param[out] valid: validity of every value, 'count' bytes
+        * @return 'false' if the encoded data is corrupt.
+        */
+        bool decode_column(type_t type, size_t size, const uint8_t* in, size_t in_size, size_t count, uint8_t* values, uint8_t* valid);
+    }
+}
@@ -0,0 +1,163 @@
+/**
+* @file     record_reader.cpp
+* @brief    Implementation of the RecordReader-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "record_reader.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace memory;
+
+bool RecordReader::open(const std::string& path)
+{
+    this->close();
+    this->_file.open(path, std::ios::in | std::ios::binary);
+    if (!this->_file) return false;
+
+    this->_file.read(reinterpret_cast<char*>(&this->_header), sizeof(this->_header));
+    if (!this->_file || this->_header.magic != record::FILE_MAGIC || this->_header.version != record::VERSION)
+    {
+        this->close();
+        return false;
+    }
+
+    this->_columns.resize(this->_header.column_count);
+    this->_file.read(reinterpret_cast<char*>(this->_columns.data()), this->_columns.size() * sizeof(record::ColumnInfo));
+    if (!this->_file)
+    {
+        this->close();
+        return false;
+    }
+    const uint64_t first_chunk = static_cast<uint64_t>(this->_file.tellg());
+
+    // load the index from the end of the file
+    record::IndexFooter footer = {};
+    this->_file.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(this->_file.tellg());
+    if (file_size >= first_chunk + sizeof(footer))
+    {
+        this->_file.seekg(file_size - sizeof(footer));
+        this->_file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+    }
+    if (this->_file && footer.magic == record::INDEX_MAGIC && footer.index_offset + footer.chunk_count * sizeof(record::IndexEntry) + sizeof(footer) == file_size)
+    {
+        this->_index.resize(footer.chunk_count);
+        this->_file.seekg(footer.index_offset);
+        this->_file.read(reinterpret_cast<char*>(this->_index.data()), this->_index.size() * sizeof(record::IndexEntry));
+    }
+    else
+    {
+        this->_file.clear();
+        this->rebuild_index(first_chunk);
+    }
+    this->_file.clear();
+    return true;
+}
+
+void RecordReader::close(void)
+{
+    if (this->_file.is_open())
+        this->_file.close();
+    this->_file.clear();
+    this->_header = {};
+    this->_columns.clear();
+    this->_index.clear();
+}
+
+void RecordReader::rebuild_index(uint64_t first_chunk)
+{
+    this->_index.clear();
+    uint64_t offset = first_chunk;
+    record::ChunkHeader h;
+    while (true)
+    {
+        this->_file.seekg(offset);
+        this->_file.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if (!this->_file || h.magic != record::CHUNK_MAGIC) break;
+
+        // a chunk that has not been written completely is ignored
+        this->_file.seekg(0, std::ios::end);
+        if (static_cast<uint64_t>(this->_file.tellg()) < offset + sizeof(h) + h.payload_bytes) break;
+
+        this->_index.push_back({ h.first_time, h.last_time, offset, h.samples });
+        offset += sizeof(h) + h.payload_bytes;
+    }
+}
+
+bool RecordReader::read_chunk(const record::IndexEntry& entry, uint64_t begin, uint64_t end, Series& series)
+{
+    record::ChunkHeader h;
+    this->_file.seekg(entry.offset);
+    this->_file.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!this->_file || h.magic != record::CHUNK_MAGIC || h.samples > record::CHUNK_SAMPLES || h.time_bytes > h.payload_bytes) return false;
+
+    std::vector<uint8_t> payload(h.payload_bytes);
+    this->_file.read(reinterpret_cast<char*>(payload.data()), payload.size());
+    if (!this->_file) return false;
+
+    const size_t n = h.samples;
+    std::vector<uint64_t> times(n);
+    if (!record::decode_times(payload.data(), h.time_bytes, n, times.data())) return false;
+
+    // rows within the range, the timestamps are ascending
+    const size_t first = std::lower_bound(times.begin(), times.end(), begin) - times.begin();
+    const size_t last = std::upper_bound(times.begin(), times.end(), end) - times.begin();
+    if (first >= last) return true;
+
+    // all columns are decoded before anything is appended, so that a corrupt chunk leaves the series unchanged
+    size_t pos = h.time_bytes;
+    std::vector<std::vector<uint8_t>> values(this->_columns.size()), valid(this->_columns.size());
+    for (size_t c = 0; c < this->_columns.size(); c++)
+    {
+        uint32_t block_size;
+        if (pos + sizeof(uint32_t) > payload.size()) return false;
+        memcpy(&block_size, payload.data() + pos, sizeof(uint32_t));
+        pos += sizeof(uint32_t);
+        if (pos + block_size > payload.size()) return false;
+
+        const size_t size = this->_columns[c].size;
+        values[c].resize(n * size);
+        valid[c].resize(n);
+        if (!record::decode_column(static_cast<type_t>(this->_columns[c].type), size, payload.data() + pos, block_size, n, values[c].data(), valid[c].data()))
+            return false;
+        pos += block_size;
+    }
+
+    series.times.insert(series.times.end(), times.begin() + first, times.begin() + last);
+    for (size_t c = 0; c < this->_columns.size(); c++)
+    {
+        const size_t size = this->_columns[c].size;
+        series.values[c].insert(series.values[c].end(), values[c].begin() + first * size, values[c].begin() + last * size);
+        series.valid[c].insert(series.valid[c].end(), valid[c].begin() + first, valid[c].begin() + last);
+    }
+    return true;
+}
+
+bool RecordReader::read(uint64_t begin, uint64_t end, Series& series)
+{
+    series.times.clear();
+    series.values.assign(this->_columns.size(), std::vector<uint8_t>());
+    series.valid.assign(this->_columns.size(), std::vector<uint8_t>());
+    if (!this->_file.is_open() || begin > end) return false;
+
+    // first chunk that ends at or after the start of the range
+    auto it = std::lower_bound(this->_index.begin(), this->_index.end(), begin,
+        [](const record::IndexEntry& e, uint64_t t) { return e.last_time < t; });
+    for (; it != this->_index.end() && it->first_time <= end; ++it)
+    {
+        if (!this->read_chunk(*it, begin, end, series))
+        {
+            // the file stream must stay usable after a corrupt chunk
+            this->_file.clear();
+            return false;
+        }
+    }
+    return true;
+}
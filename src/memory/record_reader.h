@@ -0,0 +1,85 @@
+/**
+* @file     record_reader.h
+* @brief    Definition of the RecordReader-class. Reads recordings written by the Recorder-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "record_format.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    class RecordReader
+    {
+    public:
+        struct Series
+        {
+            std::vector<uint64_t> times;                // microseconds since the start of the recording
+            std::vector<std::vector<uint8_t>> values;   // packed values of every column
+            std::vector<std::vector<uint8_t>> valid;    // validity of every value of every column (1 or 0)
+        };
+
+    private:
+        std::ifstream _file;
+        record::FileHeader _header;
+        std::vector<record::ColumnInfo> _columns;
+        std::vector<record::IndexEntry> _index;
+
+        /**
+        * @brief Rebuilds the index by walking through all chunks, used if the recording has not been finished.
+        * @param[in] first_chunk: file offset of the first chunk
+        */
+        void rebuild_index(uint64_t first_chunk);
+
+        /**
+        * @brief Decodes a chunk and appends all samples within a time range.
+        * @param[in] entry: index entry of the chunk
+        * @param[in] begin: start of the time range
+        * @param[in] end: end of the time range (inclusive)
+        * @param[out] series: decoded samples are appended
+        * @return 'false' if the chunk is corrupt.
+        */
+        bool read_chunk(const record::IndexEntry& entry, uint64_t begin, uint64_t end, Series& series);
+
+    public:
+        RecordReader(void) = default;
+        virtual ~RecordReader(void) = default;
+
+        /**
+        * @brief Opens a recording and loads its index, no samples are decoded.
+        * @param[in] path: path of the file
+        * @return 'true' if the file is a valid recording.
+        */
+        bool open(const std::string& path);
+
+        /** @brief Closes the recording. */
+        void close(void);
+
+        /** @return Header of the recording. */
+        const record::FileHeader& header(void) const noexcept { return this->_header; }
+
+        /** @return Recorded addresses. */
+        const std::vector<record::ColumnInfo>& columns(void) const noexcept { return this->_columns; }
+
+        /** @return Index of all chunks ordered by time. */
+        const std::vector<record::IndexEntry>& chunks(void) const noexcept { return this->_index; }
+
+        /**
+        * @brief Reads all samples within a time range, only the chunks that overlap the range are decoded.
+        * @param[in] begin: start of the time range in microseconds
+        * @param[in] end: end of the time range in microseconds (inclusive)
+        * @param[out] series: samples within the range
+        * @return 'false' if a chunk is corrupt, the samples before the corrupt chunk are returned.
+        */
+        bool read(uint64_t begin, uint64_t end, Series& series);
+    };
+}
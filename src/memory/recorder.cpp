@@ -0,0 +1,290 @@
+/**
+* @file     recorder.cpp
+* @brief    Implementation of the Recorder-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "recorder.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace memory;
+
+Recorder::Recorder(void)
+{
+    this->_running = false;
+    this->_sampling = false;
+    this->_rate = 0;
+    this->_row_size = 0;
+    this->_status = {};
+}
+
+Recorder::~Recorder(void)
+{
+    this->stop();
+}
+
+bool Recorder::add(pid_t pid, address_t address, type_t type, size_t size)
+{
+    if (this->running() || type == MEMORY_TYPE_STRING || size == 0 || size > record::VALUE_SIZE) return false;
+    this->_columns.push_back({ static_cast<uint32_t>(pid), static_cast<uint8_t>(type), static_cast<uint8_t>(size), 0, address });
+    return true;
+}
+
+void Recorder::clear(void)
+{
+    this->stop();
+    this->_columns.clear();
+    this->_column_offsets.clear();
+    this->_values.clear();
+    this->_groups.clear();
+    this->_index.clear();
+}
+
+bool Recorder::start(const std::string& path, uint32_t rate)
+{
+    using namespace std::chrono;
+    if (this->running() || this->_columns.size() == 0 || rate == 0) return false;
+
+    this->_file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!this->_file) return false;
+
+    const record::FileHeader header = {
+        record::FILE_MAGIC, record::VERSION,
+        static_cast<uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()),
+        rate, static_cast<uint32_t>(this->_columns.size())
+    };
+    this->_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    this->_file.write(reinterpret_cast<const char*>(this->_columns.data()), this->_columns.size() * sizeof(record::ColumnInfo));
+
+    // the values of a chunk are stored column by column
+    this->_column_offsets.resize(this->_columns.size());
+    this->_row_size = 0;
+    size_t offset = 0;
+    for (size_t c = 0; c < this->_columns.size(); c++)
+    {
+        this->_column_offsets[c] = offset;
+        offset += this->_columns[c].size * record::CHUNK_SAMPLES;
+        this->_row_size += this->_columns[c].size;
+    }
+    this->_values.assign(this->_columns.size() * record::VALUE_SIZE, 0);
+
+    // group the addresses by process, every process is read with one batch per tick
+    std::vector<size_t> order(this->_columns.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return this->_columns[a].pid < this->_columns[b].pid; });
+
+    size_t n_groups = 0;
+    for (size_t i = 0; i < order.size(); i++)
+        n_groups += (i == 0 || this->_columns[order[i]].pid != this->_columns[order[i - 1]].pid) ? 1 : 0;
+    this->_groups.clear();
+    this->_groups.resize(n_groups);     // no reallocation afterwards, the batches keep pointers into '_values'
+
+    size_t g = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const record::ColumnInfo& c = this->_columns[order[i]];
+        if (i > 0 && c.pid != this->_columns[order[i - 1]].pid) ++g;
+        Group& group = this->_groups[g];
+        if (group.indices.size() == 0)
+            group.proc.init("", c.pid, 0, 0);
+        group.indices.push_back(order[i]);
+        group.batch.add(c.address, c.size, this->_values.data() + order[i] * record::VALUE_SIZE);
+    }
+
+    this->_index.clear();
+    this->_queue.clear();
+    this->_status = {};
+    this->_status.running = true;
+    this->_rate = rate;
+    this->_sampling = true;
+    this->_running = true;
+    this->_sampler = std::thread(&Recorder::run_sampler, this);
+    this->_flusher = std::thread(&Recorder::run_flusher, this);
+    return true;
+}
+
+void Recorder::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        if (!this->_running && !this->_sampler.joinable()) return;
+        this->_running = false;
+    }
+    this->_cv_sampler.notify_all();
+    if (this->_sampler.joinable())  this->_sampler.join();
+    if (this->_flusher.joinable())  this->_flusher.join();
+
+    this->finish();
+    for (Group& g : this->_groups)
+        g.proc.close();
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_status.running = false;
+}
+
+Recorder::Status Recorder::status(void) const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_status;
+}
+
+void Recorder::run_sampler(void)
+{
+    using namespace std::chrono;
+    Trace::exclude_thread();    // the samples belong to no operation
+
+    // NOTE: The accuracy of the sampling rate depends on the timer resolution of the system,
+    // therefore the actual time of every sample is recorded.
+    const microseconds interval(1000000 / this->_rate);
+    const time_point<steady_clock> t0 = steady_clock::now();
+    time_point<steady_clock> tp = t0;
+
+    Chunk chunk;
+    while (this->_running)
+    {
+        if (chunk.times.size() == 0)
+        {
+            chunk.times.reserve(record::CHUNK_SAMPLES);
+            chunk.values.assign(this->_column_offsets.empty() ? 0 : this->_column_offsets.back() + this->_columns.back().size * record::CHUNK_SAMPLES, 0);
+            chunk.valid.assign(this->_columns.size() * record::CHUNK_SAMPLES, 0);
+        }
+
+        this->sample(duration_cast<microseconds>(steady_clock::now() - t0).count(), chunk);
+        if (chunk.times.size() == record::CHUNK_SAMPLES)
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_queue.push_back(std::move(chunk));
+            chunk = Chunk();
+            this->_cv_flusher.notify_one();
+        }
+
+        // if sampling takes longer than the interval, ticks are skipped instead of accumulated
+        tp += interval;
+        if (tp < steady_clock::now())
+            tp = steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_cv_sampler.wait_until(lock, tp, [this] { return !this->_running; });
+    }
+
+    // hand over the last, incomplete chunk
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    if (chunk.times.size() > 0)
+        this->_queue.push_back(std::move(chunk));
+    this->_sampling = false;
+    this->_cv_flusher.notify_one();
+}
+
+void Recorder::sample(uint64_t time, Chunk& chunk)
+{
+    const size_t row = chunk.times.size();
+    uint64_t failed = 0;
+    for (Group& g : this->_groups)
+    {
+        if (!g.proc.is_valid() && !g.proc.open())
+        {
+            failed += g.indices.size();
+            continue;
+        }
+
+        g.batch.read(g.proc);
+        const std::vector<IoBatch::Request>& requests = g.batch.requests();
+        bool all_failed = true;
+        for (size_t k = 0; k < g.indices.size(); k++)
+        {
+            const size_t c = g.indices[k];
+            const size_t size = this->_columns[c].size;
+            uint8_t* dst = chunk.values.data() + this->_column_offsets[c] + row * size;
+            if (requests[k].failed)
+            {
+                // repeat the previous value, it compresses best
+                if (row > 0) memcpy(dst, dst - size, size);
+                ++failed;
+                continue;
+            }
+            all_failed = false;
+            memcpy(dst, this->_values.data() + c * record::VALUE_SIZE, size);
+            chunk.valid[c * record::CHUNK_SAMPLES + row] = 1;
+        }
+        // if nothing could be read, the process may have terminated, it is reopened in the next tick
+        if (all_failed)
+            g.proc.close();
+    }
+    chunk.times.push_back(time);
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    ++this->_status.samples;
+    this->_status.failed += failed;
+    this->_status.raw_bytes += sizeof(uint64_t) + this->_row_size;
+}
+
+void Recorder::run_flusher(void)
+{
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    while (true)
+    {
+        this->_cv_flusher.wait(lock, [this] { return !this->_queue.empty() || !this->_sampling; });
+        if (this->_queue.empty() && !this->_sampling) break;
+
+        Chunk chunk = std::move(this->_queue.front());
+        this->_queue.pop_front();
+        lock.unlock();
+        this->write_chunk(chunk);
+        lock.lock();
+    }
+}
+
+void Recorder::write_chunk(const Chunk& chunk)
+{
+    const size_t n = chunk.times.size();
+    std::vector<uint8_t> payload;
+    record::encode_times(chunk.times.data(), n, payload);
+    const uint32_t time_bytes = static_cast<uint32_t>(payload.size());
+
+    std::vector<uint8_t> block;
+    for (size_t c = 0; c < this->_columns.size(); c++)
+    {
+        block.clear();
+        record::encode_column(static_cast<type_t>(this->_columns[c].type), this->_columns[c].size, chunk.values.data() + this->_column_offsets[c],
+                              chunk.valid.data() + c * record::CHUNK_SAMPLES, n, block);
+        const uint32_t block_size = static_cast<uint32_t>(block.size());
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&block_size);
+        payload.insert(payload.end(), p, p + sizeof(uint32_t));
+        payload.insert(payload.end(), block.begin(), block.end());
+    }
+
+    const record::ChunkHeader header = {
+        record::CHUNK_MAGIC, static_cast<uint32_t>(n), chunk.times.front(), chunk.times.back(),
+        time_bytes, static_cast<uint32_t>(payload.size())
+    };
+    const uint64_t offset = static_cast<uint64_t>(this->_file.tellp());
+    this->_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    this->_file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    this->_index.push_back({ header.first_time, header.last_time, offset, header.samples });
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    ++this->_status.chunks;
+    this->_status.file_bytes = offset + sizeof(header) + payload.size();
+}
+
+void Recorder::finish(void)
+{
+    if (!this->_file.is_open()) return;
+
+    const record::IndexFooter footer = { record::INDEX_MAGIC, static_cast<uint32_t>(this->_index.size()), static_cast<uint64_t>(this->_file.tellp()) };
+    this->_file.write(reinterpret_cast<const char*>(this->_index.data()), this->_index.size() * sizeof(record::IndexEntry));
+    this->_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_status.file_bytes = static_cast<uint64_t>(this->_file.tellp());
+    this->_file.close();
+}
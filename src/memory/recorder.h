@@ -0,0 +1,138 @@
+/**
+* @file     recorder.h
+* @brief    Definition of the Recorder-class. Samples a set of addresses with a fixed rate
+*           and writes them to a compressed, columnar file.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "io_batch.h"
+#include "record_format.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace memory
+{
+    /*
+    * The recorder uses two threads: The sampling thread reads all addresses and collects
+    * the samples in chunks. Full chunks are handed over to the flushing thread, which encodes
+    * and writes them. The sampling thread never waits for the file.
+    */
+    class Recorder
+    {
+    public:
+        struct Status
+        {
+            bool running;
+            uint64_t samples;       // number of sampling ticks
+            uint64_t failed;        // number of values that could not be read
+            uint64_t chunks;        // number of written chunks
+            uint64_t raw_bytes;     // number of bytes of the sampled values and timestamps
+            uint64_t file_bytes;    // number of bytes written to the file
+        };
+
+    private:
+        struct Group
+        {
+            Process proc;
+            IoBatch batch;
+            std::vector<size_t> indices;
+        };
+
+        struct Chunk
+        {
+            std::vector<uint64_t> times;
+            std::vector<uint8_t> values;    // column major, column c starts at '_column_offsets[c]'
+            std::vector<uint8_t> valid;     // column major, column c starts at 'c * CHUNK_SAMPLES'
+        };
+
+        std::vector<record::ColumnInfo> _columns;
+        std::vector<size_t> _column_offsets;
+        size_t _row_size;                   // sum of the sizes of all columns
+        std::vector<uint8_t> _values;       // staging area of one sampling tick, VALUE_SIZE bytes per column
+        std::vector<Group> _groups;
+        std::vector<record::IndexEntry> _index;
+
+        std::ofstream _file;
+        std::thread _sampler, _flusher;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv_sampler, _cv_flusher;
+        std::deque<Chunk> _queue;
+        std::atomic<bool> _running;
+        bool _sampling;
+        uint32_t _rate;
+        Status _status;
+
+        /** @brief Main function of the sampling thread. */
+        void run_sampler(void);
+
+        /** @brief Main function of the flushing thread. */
+        void run_flusher(void);
+
+        /**
+        * @brief Samples all addresses once and appends them to a chunk.
+        * @param[in] time: time of the sample in microseconds
+        * @param[out] chunk: chunk to append to
+        */
+        void sample(uint64_t time, Chunk& chunk);
+
+        /**
+        * @brief Encodes a chunk and writes it to the file.
+        * @param[in] chunk: chunk to write
+        */
+        void write_chunk(const Chunk& chunk);
+
+        /** @brief Writes the index and closes the file. */
+        void finish(void);
+
+    public:
+        Recorder(void);
+        Recorder(const Recorder&) = delete;
+        Recorder& operator= (const Recorder&) = delete;
+        virtual ~Recorder(void);
+
+        /**
+        * @brief Adds an address to the recording, addresses can only be added while the recorder is stopped.
+        * @param[in] pid: ID of the process
+        * @param[in] address: address of the value
+        * @param[in] type: type of the value, strings are not supported
+        * @param[in] size: size of the value, at most record::VALUE_SIZE bytes
+        * @return 'true' if the address has been added.
+        */
+        bool add(pid_t pid, address_t address, type_t type, size_t size);
+
+        /** @brief Stops the recorder and removes all addresses. */
+        void clear(void);
+
+        /**
+        * @brief Creates the file and starts recording.
+        * @param[in] path: path of the file
+        * @param[in] rate: samples per second
+        * @return 'true' if the recording has been started.
+        */
+        bool start(const std::string& path, uint32_t rate);
+
+        /** @brief Stops recording, writes all remaining samples and the index and closes the file. */
+        void stop(void);
+
+        /** @return 'true' if the recorder is running. */
+        bool running(void) const noexcept { return this->_running.load(); }
+
+        /** @return Number of recorded addresses. */
+        size_t size(void) const noexcept { return this->_columns.size(); }
+
+        /** @return Current statistics of the recording. */
+        Status status(void) const;
+    };
+}
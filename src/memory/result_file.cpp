@@ -0,0 +1,313 @@
+/**
+* @file     result_file.cpp
+* @brief    Implementation of the result file format.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "result_file.h"
+#include "utility.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+using namespace memory;
+
+namespace
+{
+    constexpr size_t LEGACY_ELEMENT_SIZE = sizeof(uint32_t) + 2 * sizeof(uint64_t) + sizeof(uint8_t);
+    constexpr size_t STAGING_SIZE = 0x100000;   // 1MB
+
+    inline uint64_t zigzag(uint64_t x) noexcept     { return (x << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(x) >> 63); }
+    inline uint64_t unzigzag(uint64_t x) noexcept   { return (x >> 1) ^ (~(x & 1) + 1); }
+
+    inline void put_varint(uint64_t x, std::vector<uint8_t>& out)
+    {
+        while (x >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(x) | 0x80);
+            x >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(x));
+    }
+
+    inline bool get_varint(const uint8_t*& in, const uint8_t* end, uint64_t& x) noexcept
+    {
+        x = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            if (in == end) return false;
+            const uint8_t b = *in++;
+            x |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    inline uint64_t align8(uint64_t x) noexcept { return (x + 7) & ~7ULL; }
+
+    /** @brief Loads an unaligned value and swaps its byte order if required. */
+    template<typename T>
+    inline T load(const uint8_t* p, bool swap) noexcept
+    {
+        T x;
+        memcpy(&x, p, sizeof(T));
+        if (!swap) return x;
+        if constexpr (sizeof(T) == 2)       return static_cast<T>(__builtin_bswap16(x));
+        else if constexpr (sizeof(T) == 4)  return static_cast<T>(__builtin_bswap32(x));
+        else if constexpr (sizeof(T) == 8)  return static_cast<T>(__builtin_bswap64(x));
+        else                                return x;
+    }
+
+    /** @return 'true' if the range [offset, offset + size) lies within a file of 'file_size' bytes. */
+    inline bool in_file(uint64_t offset, uint64_t size, uint64_t file_size) noexcept
+    {
+        return offset <= file_size && size <= file_size - offset;
+    }
+
+    template<typename T>
+    inline void write_column(std::ofstream& file, const std::vector<T>& column)
+    {
+        static const char zeros[8] = {};
+        const size_t bytes = column.size() * sizeof(T);
+        file.write(reinterpret_cast<const char*>(column.data()), bytes);
+        file.write(zeros, align8(bytes) - bytes);
+    }
+}
+
+bool results::write(const std::string& path, const Buffer& buff, size_t first, size_t count, bool compress)
+{
+    const std::vector<Buffer::Element>& table = buff.table();
+    if (first > table.size()) first = table.size();
+    if (count > table.size() - first) count = table.size() - first;
+
+    std::vector<uint32_t> pids(count), sizes(count);
+    std::vector<uint8_t> types(count);
+    std::vector<uint64_t> addresses(compress ? 0 : count);
+    std::vector<uint8_t> packed_addresses;
+    uint64_t value_bytes = 0, prev = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Buffer::Element& e = table[first + i];
+        pids[i] = static_cast<uint32_t>(e.pid);
+        sizes[i] = static_cast<uint32_t>(e.size);
+        types[i] = static_cast<uint8_t>(e.type);
+        value_bytes += e.size;
+
+        // results are mostly sorted, the deltas are small
+        if (compress)
+            put_varint(zigzag(e.address - prev), packed_addresses);
+        else
+            addresses[i] = e.address;
+        prev = e.address;
+    }
+
+    results::FileHeader header = {};
+    header.magic = FILE_MAGIC;
+    header.version = VERSION;
+    header.endian = ENDIAN_MARK;
+    header.flags = compress ? FLAG_DELTA_ADDRESSES : 0;
+    header.count = count;
+    header.pid_offset = align8(sizeof(FileHeader));
+    header.address_offset = header.pid_offset + align8(count * sizeof(uint32_t));
+    header.address_bytes = compress ? packed_addresses.size() : count * sizeof(uint64_t);
+    header.size_offset = header.address_offset + align8(header.address_bytes);
+    header.type_offset = header.size_offset + align8(count * sizeof(uint32_t));
+    header.value_offset = header.type_offset + align8(count);
+    header.value_bytes = value_bytes;
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file) return false;
+
+    static const char zeros[8] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    file.write(zeros, header.pid_offset - sizeof(FileHeader));
+    write_column(file, pids);
+    if (compress)   write_column(file, packed_addresses);
+    else            write_column(file, addresses);
+    write_column(file, sizes);
+    write_column(file, types);
+
+    // the values are collected in a staging buffer to not write every value separately
+    std::vector<char> staging;
+    staging.reserve(STAGING_SIZE);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Buffer::Element& e = table[first + i];
+        if (staging.size() + e.size > STAGING_SIZE && staging.size() > 0)
+        {
+            file.write(staging.data(), staging.size());
+            staging.clear();
+        }
+        const char* data = static_cast<const char*>(e.data);
+        staging.insert(staging.end(), data, data + e.size);
+    }
+    file.write(staging.data(), staging.size());
+
+    file.close();
+    return static_cast<bool>(file);
+}
+
+ResultFile::ResultFile(void)
+{
+    this->_file = MEMORY_INVALID_HANDLE;
+    this->_mapping = MEMORY_NULL_HANDLE;
+    this->_view = nullptr;
+    this->_size = 0;
+    this->_legacy = false;
+}
+
+ResultFile::~ResultFile(void)
+{
+    this->close();
+}
+
+bool ResultFile::open(const std::string& path)
+{
+    this->close();
+
+    this->_file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->_file == MEMORY_INVALID_HANDLE) return false;
+
+    // empty files cannot be mapped
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(this->_file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(uint32_t)))
+    {
+        this->close();
+        return false;
+    }
+    this->_size = static_cast<uint64_t>(size.QuadPart);
+
+    this->_mapping = CreateFileMapping(this->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->_mapping == MEMORY_NULL_HANDLE)
+    {
+        this->close();
+        return false;
+    }
+    this->_view = reinterpret_cast<const uint8_t*>(MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (this->_view == nullptr)
+    {
+        this->close();
+        return false;
+    }
+
+    uint32_t magic = 0;
+    if (this->_size >= sizeof(results::FileHeader))
+        memcpy(&magic, this->_view, sizeof(uint32_t));
+    this->_legacy = (magic != results::FILE_MAGIC && magic != __builtin_bswap32(results::FILE_MAGIC));
+    return true;
+}
+
+void ResultFile::close(void) noexcept
+{
+    if (this->_view != nullptr)
+        UnmapViewOfFile(this->_view);
+    if (this->_mapping != MEMORY_NULL_HANDLE)
+        CloseHandle(this->_mapping);
+    if (this->_file != MEMORY_INVALID_HANDLE)
+        CloseHandle(this->_file);
+
+    this->_file = MEMORY_INVALID_HANDLE;
+    this->_mapping = MEMORY_NULL_HANDLE;
+    this->_view = nullptr;
+    this->_size = 0;
+    this->_legacy = false;
+    std::vector<uint8_t>().swap(this->_swapped);
+}
+
+bool ResultFile::read_legacy(std::vector<Buffer::Element>& elements) const
+{
+    // the legacy format is stored in big endian
+    const uint64_t count = load<uint32_t>(this->_view, true);
+    if (this->_size != sizeof(uint32_t) + count * LEGACY_ELEMENT_SIZE) return false;
+
+    elements.resize(count);
+    const uint8_t* p = this->_view + sizeof(uint32_t);
+    for (uint64_t i = 0; i < count; i++, p += LEGACY_ELEMENT_SIZE)
+    {
+        Buffer::Element& e = elements[i];
+        e.pid = load<uint32_t>(p, true);
+        e.address = load<uint64_t>(p + 4, true);
+        e.size = load<uint64_t>(p + 12, true);
+        e.type = static_cast<type_t>(p[20]);
+        e.data = nullptr;
+    }
+    return true;
+}
+
+bool ResultFile::read(std::vector<Buffer::Element>& elements)
+{
+    elements.clear();
+    if (!this->is_open()) return false;
+    if (this->_legacy) return this->read_legacy(elements);
+
+    // the header is converted to the byte order of the host first
+    results::FileHeader h;
+    memcpy(&h, this->_view, sizeof(results::FileHeader));
+    const bool swap = (h.endian != results::ENDIAN_MARK);
+    if (swap && h.endian != __builtin_bswap32(results::ENDIAN_MARK)) return false;
+    h.version = load<uint32_t>(this->_view + offsetof(results::FileHeader, version), swap);
+    h.flags = load<uint32_t>(this->_view + offsetof(results::FileHeader, flags), swap);
+    h.count = load<uint64_t>(this->_view + offsetof(results::FileHeader, count), swap);
+    h.pid_offset = load<uint64_t>(this->_view + offsetof(results::FileHeader, pid_offset), swap);
+    h.address_offset = load<uint64_t>(this->_view + offsetof(results::FileHeader, address_offset), swap);
+    h.address_bytes = load<uint64_t>(this->_view + offsetof(results::FileHeader, address_bytes), swap);
+    h.size_offset = load<uint64_t>(this->_view + offsetof(results::FileHeader, size_offset), swap);
+    h.type_offset = load<uint64_t>(this->_view + offsetof(results::FileHeader, type_offset), swap);
+    h.value_offset = load<uint64_t>(this->_view + offsetof(results::FileHeader, value_offset), swap);
+    h.value_bytes = load<uint64_t>(this->_view + offsetof(results::FileHeader, value_bytes), swap);
+
+    // check that every column lies within the file
+    const bool compressed = (h.flags & results::FLAG_DELTA_ADDRESSES) != 0;
+    if (h.version == 0 || h.version > results::VERSION || h.count > this->_size) return false;
+    if (!in_file(h.pid_offset, h.count * sizeof(uint32_t), this->_size)                                    ||
+        !in_file(h.address_offset, h.address_bytes, this->_size)                                            ||
+        (!compressed && h.address_bytes != h.count * sizeof(uint64_t))                                      ||
+        !in_file(h.size_offset, h.count * sizeof(uint32_t), this->_size)                                    ||
+        !in_file(h.type_offset, h.count, this->_size)                                                       ||
+        !in_file(h.value_offset, h.value_bytes, this->_size))
+        return false;
+
+    elements.resize(h.count);
+    const uint8_t* pids = this->_view + h.pid_offset;
+    const uint8_t* addresses = this->_view + h.address_offset;
+    const uint8_t* const addresses_end = addresses + h.address_bytes;
+    const uint8_t* sizes = this->_view + h.size_offset;
+    const uint8_t* types = this->_view + h.type_offset;
+    const uint8_t* values = this->_view + h.value_offset;
+    if (swap)
+    {
+        // the mapping is read-only, the values are swapped in a copy
+        this->_swapped.assign(values, values + h.value_bytes);
+        values = this->_swapped.data();
+    }
+    uint64_t value_offset = 0, address = 0, delta;
+    for (uint64_t i = 0; i < h.count; i++)
+    {
+        Buffer::Element& e = elements[i];
+        e.pid = load<uint32_t>(pids + i * sizeof(uint32_t), swap);
+        if (compressed)
+        {
+            if (!get_varint(addresses, addresses_end, delta)) return false;
+            address += unzigzag(delta);
+            e.address = address;
+        }
+        else
+            e.address = load<uint64_t>(addresses + i * sizeof(uint64_t), swap);
+        e.size = load<uint32_t>(sizes + i * sizeof(uint32_t), swap);
+        e.type = static_cast<type_t>(types[i]);
+
+        // the values are not copied, they are referenced in the mapped file or in the swapped copy
+        if (e.size > h.value_bytes - value_offset) return false;
+        e.data = const_cast<uint8_t*>(values + value_offset);
+        if (swap && e.type != MEMORY_TYPE_VOID && !utility::is_string(e.type))
+            std::reverse(this->_swapped.begin() + value_offset, this->_swapped.begin() + value_offset + e.size);
+        value_offset += e.size;
+    }
+    return true;
+}
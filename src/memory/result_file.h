@@ -0,0 +1,119 @@
+/**
+* @file     result_file.h
+* @brief    File format of saved search results and the ResultFile-class to read them.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "buffer.h"
+#include <string>
+#include <vector>
+
+/*
+* Layout of a result file, every column starts at an offset that is a multiple of 8:
+*   FileHeader
+*   pids        uint32_t[count]
+*   addresses   uint64_t[count], or zigzag varints of the address deltas if FLAG_DELTA_ADDRESSES is set
+*   sizes       uint32_t[count]
+*   types       uint8_t[count]
+*   values      the values of all elements, one after another
+*
+* The file is written in the byte order of the host, 'endian' tells the reader whether it has to swap.
+* The numeric values of a file with the other byte order are swapped in a copy of the value column.
+* The legacy format (big endian: uint32_t count, { uint32_t pid, uint64_t address, uint64_t size, uint8_t type }[count])
+* is still readable, it does not contain values.
+*/
+
+namespace memory
+{
+    namespace results
+    {
+        constexpr uint32_t FILE_MAGIC   = 0x5345524D;   // "MRES"
+        constexpr uint32_t VERSION      = 1;
+        constexpr uint32_t ENDIAN_MARK  = 0x01020304;
+
+        constexpr uint32_t FLAG_DELTA_ADDRESSES = 0x1;  // the addresses are delta-varint encoded
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t endian;
+            uint32_t flags;
+            uint64_t count;
+            uint64_t pid_offset;
+            uint64_t address_offset;
+            uint64_t address_bytes;
+            uint64_t size_offset;
+            uint64_t type_offset;
+            uint64_t value_offset;
+            uint64_t value_bytes;
+        };
+#pragma pack(pop)
+
+        /**
+        * @brief Writes elements of a buffer to a result file.
+        * @param[in] path: path of the file
+        * @param[in] buff: buffer of the elements
+        * @param[in] first: index of the first element
+        * @param[in] count: number of elements
+        * @param[in] compress: encode the addresses as delta-varints
+        * @return 'true' if the file has been written.
+        */
+        bool write(const std::string& path, const Buffer& buff, size_t first, size_t count, bool compress);
+    }
+
+    /*
+    * Maps a result file into memory. The values of the elements point directly into the mapped file,
+    * or into the swapped copy of the values, so they are only valid as long as the file is open.
+    */
+    class ResultFile
+    {
+    private:
+        HANDLE _file, _mapping;
+        const uint8_t* _view;
+        uint64_t _size;
+        bool _legacy;
+        std::vector<uint8_t> _swapped;  // values of a file with the other byte order, in the byte order of the host
+
+        /** @brief Reads the elements of the legacy format. */
+        bool read_legacy(std::vector<Buffer::Element>& elements) const;
+
+    public:
+        ResultFile(void);
+        ResultFile(const ResultFile&) = delete;
+        ResultFile& operator= (const ResultFile&) = delete;
+        virtual ~ResultFile(void);
+
+        /**
+        * @brief Opens and maps a result file.
+        * @param[in] path: path of the file
+        * @return 'true' if the file could be mapped.
+        */
+        bool open(const std::string& path);
+
+        /** @brief Unmaps and closes the file. */
+        void close(void) noexcept;
+
+        /** @return 'true' if a file is open. */
+        bool is_open(void) const noexcept { return this->_view != nullptr; }
+
+        /** @return 'true' if the file has the legacy format, which does not contain values. */
+        bool legacy(void) const noexcept { return this->_legacy; }
+
+        /**
+        * @brief Reads all elements of the file.
+        * @param[out] elements: elements of the file, their data points into the mapped file and must not be modified,
+        *   elements of legacy files have no data (nullptr)
+        * @return 'false' if the file is corrupt.
+        */
+        bool read(std::vector<Buffer::Element>& elements);
+    };
+}
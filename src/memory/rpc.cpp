@@ -0,0 +1,123 @@
+/**
+* @file     rpc.cpp
+* @brief    Implementation of the protocol helpers and the Connection-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "rpc.h"
+#include <cstddef>
+
+using namespace memory;
+using namespace memory::rpc;
+
+Writer::Writer(std::vector<uint8_t>& frame, rpc_op_t op, uint32_t id) : _frame(frame)
+{
+    FrameHeader header = { 0, op, 0, id };
+    this->_frame.clear();
+    this->put(&header, sizeof(FrameHeader));
+}
+
+void Writer::put(const void* data, size_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    this->_frame.insert(this->_frame.end(), p, p + size);
+}
+
+void Writer::put_string(const std::string& str)
+{
+    this->put<uint32_t>(static_cast<uint32_t>(str.size()));
+    this->put(str.data(), str.size());
+}
+
+void Writer::finish(size_t extra) noexcept
+{
+    const uint32_t size = static_cast<uint32_t>(this->_frame.size() - sizeof(FrameHeader) + extra);
+    memcpy(this->_frame.data() + offsetof(FrameHeader, size), &size, sizeof(uint32_t));
+}
+
+const uint8_t* Reader::get_bytes(size_t size) noexcept
+{
+    if (!this->_ok || size > this->remaining())
+    {
+        this->_ok = false;
+        return nullptr;
+    }
+    const uint8_t* p = this->_p;
+    this->_p += size;
+    return p;
+}
+
+bool Reader::get_string(std::string& str)
+{
+    uint32_t size;
+    if (!this->get(size)) return false;
+    const uint8_t* p = this->get_bytes(size);
+    if (p == nullptr) return false;
+    str.assign(reinterpret_cast<const char*>(p), size);
+    return true;
+}
+
+bool Connection::connect(const std::string& name, uint32_t timeout)
+{
+    this->close();
+    const std::string path = std::string(PIPE_PREFIX) + name;
+
+    // all instances of the pipe may be busy, then it is waited for one free instance
+    this->_pipe = CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (this->_pipe == MEMORY_INVALID_HANDLE && GetLastError() == ERROR_PIPE_BUSY && WaitNamedPipe(path.c_str(), timeout))
+        this->_pipe = CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    return this->_pipe != MEMORY_INVALID_HANDLE;
+}
+
+void Connection::close(void) noexcept
+{
+    if (this->_pipe != MEMORY_INVALID_HANDLE)
+    {
+        CloseHandle(this->_pipe);
+        this->_pipe = MEMORY_INVALID_HANDLE;
+    }
+}
+
+bool Connection::write_all(const void* data, size_t size)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0)
+    {
+        DWORD written = 0;
+        if (!WriteFile(this->_pipe, p, static_cast<DWORD>(size), &written, nullptr)) return false;
+        p += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool Connection::read_all(void* data, size_t size)
+{
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (size > 0)
+    {
+        DWORD read = 0;
+        if (!ReadFile(this->_pipe, p, static_cast<DWORD>(size), &read, nullptr) || read == 0) return false;
+        p += read;
+        size -= read;
+    }
+    return true;
+}
+
+bool Connection::send(const std::vector<uint8_t>& frame)
+{
+    return this->_pipe != MEMORY_INVALID_HANDLE && this->write_all(frame.data(), frame.size());
+}
+
+bool Connection::receive(FrameHeader& header, std::vector<uint8_t>& payload)
+{
+    if (this->_pipe == MEMORY_INVALID_HANDLE || !this->read_all(&header, sizeof(FrameHeader))) return false;
+    if (header.size > MAX_PAYLOAD) return false;
+    payload.resize(header.size);
+    return this->read_all(payload.data(), header.size);
+}
@@ -0,0 +1,211 @@
+/**
+* @file     rpc.h
+* @brief    Framed binary protocol of the server mode and the Connection-class for clients.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "types.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+* Every message is a frame: FrameHeader followed by 'size' bytes of payload. All numbers are little endian.
+* A request is answered with MEMORY_RPC_REPLY or MEMORY_RPC_ERROR with the same id. Scans, updates and exports
+* run as job in the background, their request is answered immediately and the job sends MEMORY_RPC_PROGRESS
+* events while it is running and MEMORY_RPC_DONE (or MEMORY_RPC_ERROR) when it has finished, all with the id
+* of the request. A finished scan or update replaces the stored results, a cancelled one keeps them.
+*
+* Requests (-> reply):
+*   SCAN:       u8 type, u32 size, u16 alignment, u64 begin, u64 end, u32 n, u32 pid[n] (n = 0: all processes),
+*               value a[size], value b[size] (a == b: exact value)                  -> empty, then events
+*   UPDATE:     u8 filter (0: reread values), u8 type, u32 size, a[size], b[size]  -> empty, then events
+*   READ:       u32 pid, u64 address, u32 size                                      -> u32 n, u8 bytes[n]
+*   WRITE:      u32 pid, u64 address, u32 size, u8 bytes[size]                      -> u32 written bytes
+*   WATCH:      u8 action, START: u32 interval, u32 max count                       -> u32 watched addresses
+*                          STOP                                                     -> empty
+*                          STATISTICS                                               -> u32 n, WatchRecord[n]
+*   RESULTS:    u64 first, u32 count                                                -> u64 total, u32 n, ResultRecord[n], values
+*   EXPORT:     u8 format (export_format_t or rpc::EXPORT_BINARY), string path      -> empty, then events
+*   CANCEL:     empty                                                               -> empty
+* Events:
+*   PROGRESS:   u64 bytes total, u64 bytes, u64 regions total, u64 regions, u64 hits
+*   DONE:       u8 scan_status_t, u64 number of results or exported rows
+* Errors:
+*   ERROR:      string message
+* Strings are u32 length followed by the characters.
+*/
+
+namespace memory
+{
+    enum rpc_op_t : uint16_t
+    {
+        MEMORY_RPC_SCAN = 0x1,
+        MEMORY_RPC_UPDATE = 0x2,
+        MEMORY_RPC_READ = 0x3,
+        MEMORY_RPC_WRITE = 0x4,
+        MEMORY_RPC_WATCH = 0x5,
+        MEMORY_RPC_RESULTS = 0x6,
+        MEMORY_RPC_EXPORT = 0x7,
+        MEMORY_RPC_CANCEL = 0x8,
+
+        MEMORY_RPC_REPLY = 0x80,
+        MEMORY_RPC_ERROR = 0x81,
+        MEMORY_RPC_PROGRESS = 0x82,
+        MEMORY_RPC_DONE = 0x83
+    };
+
+    enum rpc_watch_t : uint8_t
+    {
+        MEMORY_RPC_WATCH_START = 0x0,
+        MEMORY_RPC_WATCH_STOP = 0x1,
+        MEMORY_RPC_WATCH_STATISTICS = 0x2
+    };
+
+    namespace rpc
+    {
+        constexpr char PIPE_PREFIX[]            = "\\\\.\\pipe\\";
+        constexpr uint32_t MAX_PAYLOAD          = 0x4000000;    // 64MB
+        constexpr uint32_t MAX_PAGE             = 0x100000;     // maximum number of results per page
+        constexpr uint8_t EXPORT_BINARY         = 0xFF;         // export format of a binary result file
+
+#pragma pack(push, 1)
+        struct FrameHeader
+        {
+            uint32_t size;      // size of the payload
+            uint16_t op;        // rpc_op_t
+            uint16_t reserved;
+            uint32_t id;        // chosen by the client, replies and events have the id of their request
+        };
+
+        struct ResultRecord
+        {
+            uint32_t pid;
+            uint64_t address;
+            uint32_t size;
+            uint8_t type;
+        };
+
+        struct WatchRecord
+        {
+            uint32_t pid;
+            uint64_t address;
+            uint8_t type;
+            uint8_t size;
+            uint8_t last[8];
+            double min, max, mean;
+            uint64_t samples, failed, changes;
+            double change_rate;
+        };
+#pragma pack(pop)
+
+        /*
+        * Builds a frame, the size of the payload is set by 'finish'.
+        */
+        class Writer
+        {
+        private:
+            std::vector<uint8_t>& _frame;
+
+        public:
+            /**
+            * @param[out] frame: frame to write, it is cleared
+            * @param[in] op: operation of the frame
+            * @param[in] id: ID of the request
+            */
+            Writer(std::vector<uint8_t>& frame, rpc_op_t op, uint32_t id);
+
+            template<typename T>
+            void put(T x) { this->put(&x, sizeof(T)); }
+            void put(const void* data, size_t size);
+            void put_string(const std::string& str);
+
+            /**
+            * @brief Sets the size of the payload.
+            * @param[in] extra: bytes of the payload that are sent separately after the frame
+            */
+            void finish(size_t extra = 0) noexcept;
+        };
+
+        /*
+        * Reads a payload, every read checks the bounds. After a failed read all following reads fail.
+        */
+        class Reader
+        {
+        private:
+            const uint8_t* _p, * _end;
+            bool _ok;
+
+        public:
+            Reader(const uint8_t* payload, size_t size) : _p(payload), _end(payload + size), _ok(true) {}
+
+            template<typename T>
+            bool get(T& x) noexcept
+            {
+                const uint8_t* p = this->get_bytes(sizeof(T));
+                if (p != nullptr) memcpy(&x, p, sizeof(T));
+                return p != nullptr;
+            }
+
+            /** @return Pointer to the next 'size' bytes or nullptr if the payload is too short. */
+            const uint8_t* get_bytes(size_t size) noexcept;
+            bool get_string(std::string& str);
+
+            /** @return 'true' if all reads have been successful. */
+            bool ok(void) const noexcept { return this->_ok; }
+
+            /** @return Number of bytes that have not been read. */
+            size_t remaining(void) const noexcept { return this->_end - this->_p; }
+        };
+
+        /*
+        * Blocking connection of a client to the server.
+        */
+        class Connection
+        {
+        private:
+            HANDLE _pipe;
+
+            bool write_all(const void* data, size_t size);
+            bool read_all(void* data, size_t size);
+
+        public:
+            Connection(void) : _pipe(MEMORY_INVALID_HANDLE) {}
+            Connection(const Connection&) = delete;
+            Connection& operator= (const Connection&) = delete;
+            virtual ~Connection(void) { this->close(); }
+
+            /**
+            * @brief Connects to a server, waits if all instances of the pipe are busy.
+            * @param[in] name: name of the server, without the pipe prefix
+            * @param[in] timeout: maximum waiting time in milliseconds
+            * @return 'true' if the connection has been established.
+            */
+            bool connect(const std::string& name, uint32_t timeout);
+
+            /** @brief Closes the connection. */
+            void close(void) noexcept;
+
+            /**
+            * @brief Sends a frame that has been built with a Writer.
+            * @return 'false' if the connection is broken.
+            */
+            bool send(const std::vector<uint8_t>& frame);
+
+            /**
+            * @brief Receives the next frame.
+            * @param[out] header: header of the frame
+            * @param[out] payload: payload of the frame
+            * @return 'false' if the connection is broken or the frame is invalid.
+            */
+            bool receive(FrameHeader& header, std::vector<uint8_t>& payload);
+        };
+    }
+}
@@ -0,0 +1,295 @@
+/**
+* @file     scanner.cpp
+* @brief    Implementation of the Scanner-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "scanner.h"
+#include "io_batch.h"
+#include "stats.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace memory;
+
+namespace
+{
+    template<typename T>
+    inline bool between(const uint8_t* _a, const uint8_t* _b, const uint8_t* _ref) noexcept
+    {
+        T a, b, ref;
+        memcpy(&a, _a, sizeof(T));
+        memcpy(&b, _b, sizeof(T));
+        memcpy(&ref, _ref, sizeof(T));
+        return (ref >= a) && (ref <= b);
+    }
+
+    inline bool cancelled(const std::atomic_bool* cancel) noexcept
+    {
+        return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+    }
+
+    /** @return 'true' if another value of 'size' bytes does not fit into the buffer. */
+    inline bool full(const Buffer& out, size_t size) noexcept
+    {
+        return out.limit() > 0 && out.size() + size > out.limit();
+    }
+
+    // offsets of the matches of a block, kept per thread so that a block does not allocate
+    thread_local std::vector<size_t> matches;
+}
+
+bool Scanner::is_between(type_t type, size_t size, const uint8_t* a, const uint8_t* b, const uint8_t* ref) noexcept
+{
+    switch (type)
+    {
+    case MEMORY_TYPE_INT8:      return between<int8_t>(a, b, ref);
+    case MEMORY_TYPE_UINT8:     return between<uint8_t>(a, b, ref);
+    case MEMORY_TYPE_INT16:     return between<int16_t>(a, b, ref);
+    case MEMORY_TYPE_UINT16:    return between<uint16_t>(a, b, ref);
+    case MEMORY_TYPE_INT32:     return between<int32_t>(a, b, ref);
+    case MEMORY_TYPE_UINT32:    return between<uint32_t>(a, b, ref);
+    case MEMORY_TYPE_INT64:     return between<int64_t>(a, b, ref);
+    case MEMORY_TYPE_UINT64:    return between<uint64_t>(a, b, ref);
+    case MEMORY_TYPE_FLOAT:     return between<float>(a, b, ref);
+    case MEMORY_TYPE_DOUBLE:    return between<double>(a, b, ref);
+    case MEMORY_TYPE_STRING:    return memcmp(a, ref, size) == 0;
+    default:                    return false;
+    }
+}
+
+bool Scanner::scan_block(const ScanSettings& settings, const uint8_t* a, const uint8_t* b, const uint8_t* data, size_t data_size,
+                         pid_t pid, address_t address, Buffer& out, uint64_t& hits)
+{
+    hits = 0;
+    const size_t size = settings.size;
+    const size_t alignment = std::max<size_t>(settings.alignment, 1);
+    if (size == 0 || data_size < size) return true;
+
+    // the matches are compared first and pushed afterwards, so that both phases are timed once per block
+    matches.clear();
+    {
+        Stats::Timer timer(MEMORY_PHASE_COMPARE);
+        MEMORY_TRACE_SCOPE("compare", address, data_size);
+        const bool equal = (memcmp(a, b, size) == 0);
+        for (size_t j = 0; j <= data_size - size; j += alignment)
+        {
+            if (equal ? (memcmp(a, data + j, size) == 0) : is_between(settings.type, size, a, b, data + j))
+                matches.push_back(j);
+        }
+        Stats::add(MEMORY_STAT_BYTES_COMPARED, data_size);
+    }
+
+    Stats::Timer timer(MEMORY_PHASE_PUSH);
+    MEMORY_TRACE_SCOPE("push", address, matches.size() * size);
+    bool done = true;
+    for (size_t j : matches)
+    {
+        if (full(out, size))
+        {
+            done = false;
+            break;
+        }
+        out.push(pid, address + j, size, settings.type, data + j);
+        ++hits;
+    }
+    Stats::add(MEMORY_STAT_HITS, hits);
+    return done;
+}
+
+scan_status_t Scanner::scan(MemorySource& source, const ScanSettings& settings, const uint8_t* a, const uint8_t* b,
+                            Buffer& out, ScanProgress* progress, const std::atomic_bool* cancel)
+{
+    if (!source.is_valid() || a == nullptr || b == nullptr || settings.size == 0) return MEMORY_SCAN_DONE;
+    const size_t size = settings.size;
+    const size_t alignment = std::max<size_t>(settings.alignment, 1);
+    const size_t split_size = std::max<size_t>(settings.split_size, alignment);
+
+    // query memory regions
+    std::vector<MemoryInfo> regions;
+    {
+        Stats::Timer timer(MEMORY_PHASE_QUERY);
+        MEMORY_TRACE_SCOPE("query", settings.begin, settings.end - settings.begin);
+        source.query(settings.begin, settings.end, regions);
+    }
+    if (progress != nullptr)
+    {
+        uint64_t total = 0;
+        for (const MemoryInfo& region : regions)
+            total += region.size;
+        progress->bytes_total += total;
+        progress->regions_total += regions.size();
+    }
+
+    // a chunk overlaps the next chunk by 'size - 1' bytes, so that values across the border are found
+    const size_t max_rd_size = split_size + size - 1;
+    std::vector<uint8_t> buff;
+    for (const MemoryInfo& region : regions)
+    {
+        MEMORY_TRACE_SCOPE("region", region.base, region.size);
+        const uint8_t* view = source.view(region.base, region.size);    // nothing has to be read from a mapped file
+        if (view == nullptr && buff.empty())
+            buff.resize(max_rd_size);
+        for (address_t i = 0; i < region.size; i += split_size)
+        {
+            if (cancelled(cancel)) return MEMORY_SCAN_CANCELLED;
+
+            const address_t cur_addr = region.base + i;
+            const size_t rd_size = std::min<address_t>(region.size - i, max_rd_size);    // dont read out of bounds of the region
+            const uint8_t* data = (view != nullptr) ? view + i : nullptr;
+            uint64_t hits = 0;
+            if (data == nullptr && rd_size >= size)
+            {
+                Stats::Timer timer(MEMORY_PHASE_READ);
+                MEMORY_TRACE_SCOPE("read", cur_addr, rd_size);
+                if (source.read(cur_addr, rd_size, buff.data()) == rd_size)
+                    data = buff.data();
+            }
+            if (data != nullptr && rd_size >= size && !scan_block(settings, a, b, data, rd_size, source.pid(), cur_addr, out, hits))
+            {
+                if (progress != nullptr) progress->hits += hits;
+                return MEMORY_SCAN_LIMIT;
+            }
+
+            if (progress != nullptr)
+            {
+                progress->bytes += std::min<address_t>(region.size - i, split_size);
+                progress->hits += hits;
+            }
+        }
+        if (progress != nullptr) ++progress->regions;
+    }
+    return MEMORY_SCAN_DONE;
+}
+
+scan_status_t Scanner::filter(const Buffer& in, type_t type, const uint8_t* a, const uint8_t* b, size_t size,
+                              Buffer& out, ScanProgress* progress, const std::atomic_bool* cancel, MemorySource* source)
+{
+    const std::vector<Buffer::Element>& table = in.table();
+    const bool reread = (a == nullptr || b == nullptr);
+    const bool equal = !reread && (memcmp(a, b, size) == 0);
+    if (progress != nullptr)
+    {
+        progress->bytes_total += reread ? in.size() : table.size() * size;
+        progress->regions_total += table.size();
+    }
+
+    // Consecutive results of the same process are read with one batch, at most FILTER_CHUNK at once.
+    // The order of the results is not changed.
+    Process cur_p;
+    IoBatch batch;
+    std::vector<uint8_t> values;
+    std::vector<size_t> offsets;
+    std::vector<const uint8_t*> views;                      // values that are read in place from the source
+    std::vector<std::pair<size_t, const uint8_t*>> kept;    // index into the table and the value to push
+    for (size_t first = 0; first < table.size();)
+    {
+        if (cancelled(cancel)) return MEMORY_SCAN_CANCELLED;
+
+        const pid_t pid = table[first].pid;
+        size_t last = first;
+        size_t bytes = 0;
+        for (; last < table.size() && last - first < FILTER_CHUNK && table[last].pid == pid; last++)
+            bytes += reread ? table[last].size : size;
+
+        values.resize(bytes);
+        offsets.resize(last - first);
+        views.assign(last - first, nullptr);
+        size_t offset = 0;
+        for (size_t i = first; i < last; i++)
+        {
+            const size_t rd_size = reread ? table[i].size : size;
+            offsets[i - first] = offset;
+            if (source != nullptr)
+                views[i - first] = source->view(table[i].address, rd_size);
+            if (views[i - first] == nullptr)
+                batch.add(table[i].address, rd_size, values.data() + offset);
+            offset += rd_size;
+        }
+
+        MemorySource* src = source;
+        if (src == nullptr)
+        {
+            if (pid != cur_p.pid() || !cur_p.is_valid())
+            {
+                cur_p.close();
+                cur_p.init("", pid, 0, 0);    // all other information are irelevent in this context
+                cur_p.open();
+            }
+            src = &cur_p;
+        }
+        const bool opened = src->is_valid();
+        if (opened && batch.size() > 0)
+        {
+            Stats::Timer timer(MEMORY_PHASE_READ);
+            MEMORY_TRACE_SCOPE("read_batch", table[first].address, bytes);
+            batch.read(*src);
+        }
+
+        // values that could not be read are dropped, a reread result keeps its previous value
+        kept.clear();
+        {
+            Stats::Timer timer(MEMORY_PHASE_COMPARE);
+            MEMORY_TRACE_SCOPE("compare", table[first].address, bytes);
+            size_t compared = 0;
+            size_t request = 0;     // the requests of the batch are in the order of the results
+            for (size_t i = first; i < last; i++)
+            {
+                const uint8_t* value = views[i - first];
+                bool failed = !opened;
+                if (value == nullptr)
+                {
+                    failed = batch.requests()[request++].failed || failed;
+                    value = failed ? static_cast<const uint8_t*>(table[i].data) : values.data() + offsets[i - first];
+                }
+                if (failed && !reread) continue;
+                if (!reread) compared += size;
+                if (reread || (equal ? memcmp(a, value, size) == 0 : is_between(type, size, a, b, value)))
+                    kept.emplace_back(i, value);
+            }
+            Stats::add(MEMORY_STAT_BYTES_COMPARED, compared);
+        }
+
+        uint64_t hits = 0;
+        bool limit = false;
+        {
+            Stats::Timer timer(MEMORY_PHASE_PUSH);
+            MEMORY_TRACE_SCOPE("push", table[first].address, kept.size());
+            for (const std::pair<size_t, const uint8_t*>& k : kept)
+            {
+                const Buffer::Element& e = table[k.first];
+                const size_t push_size = reread ? e.size : size;
+                if (full(out, push_size))
+                {
+                    limit = true;
+                    break;
+                }
+                out.push(e.pid, e.address, push_size, reread ? e.type : type, k.second);
+                ++hits;
+            }
+            Stats::add(MEMORY_STAT_HITS, hits);
+        }
+        batch.clear();
+        if (limit)
+        {
+            if (progress != nullptr) progress->hits += hits;
+            return MEMORY_SCAN_LIMIT;
+        }
+
+        if (progress != nullptr)
+        {
+            progress->bytes += bytes;
+            progress->regions += last - first;
+            progress->hits += hits;
+        }
+        first = last;
+    }
+    cur_p.close();
+    return MEMORY_SCAN_DONE;
+}
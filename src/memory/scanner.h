@@ -0,0 +1,130 @@
+/**
+* @file     scanner.h
+* @brief    Definition of the Scanner-class. Scans the memory of processes for values and filters
+*           stored results, with progress reporting and cancellation.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "buffer.h"
+#include "memory_source.h"
+#include <atomic>
+
+namespace memory
+{
+    enum scan_status_t : uint8_t
+    {
+        MEMORY_SCAN_DONE = 0x0,
+        MEMORY_SCAN_LIMIT = 0x1,        // the buffer has reached its limit, the results are incomplete
+        MEMORY_SCAN_CANCELLED = 0x2     // the scan has been cancelled, the results are incomplete
+    };
+
+    /*
+    * The counters can be read by another thread while a scan is running.
+    * The totals are known as soon as the memory regions have been queried.
+    */
+    struct ScanProgress
+    {
+        std::atomic<uint64_t> bytes_total;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> regions_total;
+        std::atomic<uint64_t> regions;
+        std::atomic<uint64_t> hits;
+
+        ScanProgress(void) : bytes_total(0), bytes(0), regions_total(0), regions(0), hits(0) {}
+
+        /** @brief Sets all counters to 0. */
+        void reset(void) noexcept
+        {
+            this->bytes_total = 0;
+            this->bytes = 0;
+            this->regions_total = 0;
+            this->regions = 0;
+            this->hits = 0;
+        }
+    };
+
+    struct ScanSettings
+    {
+        type_t type;
+        size_t size;                    // size of the value, the length of strings
+        uint16_t alignment;
+        address_t begin, end;           // address range that is scanned
+        size_t split_size;              // regions are read in chunks of this size
+    };
+
+    class Scanner
+    {
+    public:
+        constexpr static size_t FILTER_CHUNK = 0x10000;    // number of results that are filtered at once
+
+        /**
+        * @brief Checks if a value is between two values (inclusive).
+        * @param[in] type: type of the values, strings are compared for equality with 'a'
+        * @param[in] size: size of the values
+        * @param[in] a: lower limit
+        * @param[in] b: upper limit
+        * @param[in] ref: value to check
+        * @return 'true' if the value is between 'a' and 'b'.
+        */
+        static bool is_between(type_t type, size_t size, const uint8_t* a, const uint8_t* b, const uint8_t* ref) noexcept;
+
+        /**
+        * @brief Scans a block of memory that has already been read, the matches are added to 'out'.
+        *   Values are checked at every 'settings.alignment' bytes from the beginning of the block.
+        * @param[in] settings: scan settings, the address range is not used
+        * @param[in] a: lower limit, or the exact value if 'a' and 'b' are equal
+        * @param[in] b: upper limit
+        * @param[in] data: bytes of the block
+        * @param[in] data_size: size of the block
+        * @param[in] pid: process of the block
+        * @param[in] address: address of the first byte of the block
+        * @param[out] out: buffer of the matches
+        * @param[out] hits: number of added matches
+        * @return 'false' if the limit of 'out' has been reached.
+        */
+        static bool scan_block(const ScanSettings& settings, const uint8_t* a, const uint8_t* b, const uint8_t* data, size_t data_size,
+                               pid_t pid, address_t address, Buffer& out, uint64_t& hits);
+
+        /**
+        * @brief Scans the memory of a process, snapshot or core dump for values between 'a' and 'b'. The matches are added to 'out'.
+        *   Regions that the source can view are scanned in place, all other regions are read in chunks.
+        *   Cancellation is checked after every chunk, so a scan stops within one chunk.
+        * @param[in] source: open source to scan
+        * @param[in] settings: scan settings
+        * @param[in] a: lower limit, or the exact value if 'a' and 'b' are equal
+        * @param[in] b: upper limit
+        * @param[out] out: buffer of the matches, the scan stops when its limit is reached
+        * @param[out] progress: progress of the scan, may be nullptr
+        * @param[in] cancel: the scan stops if it is set, may be nullptr
+        * @return Status of the scan.
+        */
+        static scan_status_t scan(MemorySource& source, const ScanSettings& settings, const uint8_t* a, const uint8_t* b,
+                                  Buffer& out, ScanProgress* progress, const std::atomic_bool* cancel);
+
+        /**
+        * @brief Reads the current values of stored results and keeps the values between 'a' and 'b'.
+        *   'size' bytes are read of every result and the kept results get the type 'type'.
+        *   If 'a' and 'b' are nullptr all results are kept with their own size, type and new value.
+        *   The order of the results stays the same.
+        * @param[in] in: stored results
+        * @param[in] type: type of the values
+        * @param[in] a: lower limit or nullptr
+        * @param[in] b: upper limit or nullptr
+        * @param[in] size: size of the limits
+        * @param[out] out: filtered results
+        * @param[out] progress: progress of the filter, bytes and regions count results, may be nullptr
+        * @param[in] cancel: filtering stops if it is set, may be nullptr
+        * @param[in] source: all results are read from this source instead of their processes, may be nullptr
+        * @return Status of the filter.
+        */
+        static scan_status_t filter(const Buffer& in, type_t type, const uint8_t* a, const uint8_t* b, size_t size,
+                                    Buffer& out, ScanProgress* progress, const std::atomic_bool* cancel, MemorySource* source = nullptr);
+    };
+}
@@ -0,0 +1,187 @@
+/**
+* @file     screen.cpp
+* @brief    Implementation of the Screen-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "screen.h"
+#include <Windows.h>
+#include <algorithm>
+
+using namespace memory;
+
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+    #define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+
+namespace
+{
+    constexpr const char* SGR_HIGHLIGHT = "\x1b[7m";
+    constexpr const char* SGR_RESET     = "\x1b[0m";
+    constexpr char VERTICAL_CHAR        = '|';
+
+    inline bool is_separator(char c) noexcept
+    {
+        return c == ' ' || c == VERTICAL_CHAR;
+    }
+
+    inline void append_uint(std::string& out, uint32_t x)
+    {
+        char buf[10];
+        int n = 0;
+        do
+        {
+            buf[n++] = static_cast<char>('0' + x % 10);
+            x /= 10;
+        } while (x > 0);
+        while (n > 0)
+            out.push_back(buf[--n]);
+    }
+
+    /** @brief Appends the escape sequence to move the cursor, rows and columns start at 0. */
+    inline void append_move(std::string& out, uint32_t row, uint32_t col)
+    {
+        out += "\x1b[";
+        append_uint(out, row + 1);
+        out.push_back(';');
+        append_uint(out, col + 1);
+        out.push_back('H');
+    }
+}
+
+Screen::Screen(void)
+{
+    this->_frame = 0;
+    this->_highlight = 0;
+    this->_full = true;
+}
+
+bool Screen::enable_virtual_terminal(void) noexcept
+{
+    HANDLE h_out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (h_out == INVALID_HANDLE_VALUE || !GetConsoleMode(h_out, &mode))
+        return false;
+    return SetConsoleMode(h_out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+}
+
+void Screen::set_line(uint32_t row, const std::string& text)
+{
+    if (row >= this->_next.size())
+        this->_next.resize(row + 1);
+    this->_next[row] = text;
+}
+
+void Screen::set_lines(const std::vector<std::string>& lines, uint32_t first_row)
+{
+    if (first_row + lines.size() > this->_next.size())
+        this->_next.resize(first_row + lines.size());
+    for (size_t i = 0; i < lines.size(); i++)
+        this->_next[first_row + i] = lines[i];
+}
+
+void Screen::mark_word(uint32_t row, uint32_t col, const std::string& line)
+{
+    std::vector<uint64_t>& changed = this->_changed[row];
+    changed[col] = this->_frame;
+    if (is_separator(line[col])) return;
+
+    for (uint32_t c = col; c > 0 && !is_separator(line[c - 1]); c--)
+        changed[c - 1] = this->_frame;
+    for (uint32_t c = col + 1; c < line.size() && !is_separator(line[c]); c++)
+        changed[c] = this->_frame;
+}
+
+size_t Screen::present(void)
+{
+    ++this->_frame;
+    const uint32_t rows = static_cast<uint32_t>(std::max(this->_prev.size(), this->_next.size()));
+    this->_next.resize(rows);
+    this->_prev.resize(rows);
+    this->_changed.resize(rows);
+    this->_marked.resize(rows);
+
+    this->_out.clear();
+    if (this->_full)
+        this->_out += "\x1b[?25l\x1b[0m\x1b[2J";    // hide the cursor and clear the screen
+
+    uint32_t cursor_row = UINT32_MAX, cursor_col = 0;
+    bool sgr_highlight = false;
+    for (uint32_t r = 0; r < rows; r++)
+    {
+        // shorter lines are padded with spaces to overwrite the old content
+        std::string& line = this->_next[r];
+        const std::string& old = this->_prev[r];
+        if (line.size() < old.size())
+            line.resize(old.size(), ' ');
+        this->_changed[r].resize(line.size(), 0);
+        this->_marked[r].resize(line.size(), false);
+
+        // the first frame and cleared screens are not highlighted
+        if (this->_highlight > 0 && !this->_full)
+        {
+            for (uint32_t c = 0; c < line.size(); c++)
+            {
+                if (c >= old.size() || line[c] != old[c])
+                    this->mark_word(r, c, line);
+            }
+        }
+
+        for (uint32_t c = 0; c < line.size(); c++)
+        {
+            const uint64_t changed = this->_changed[r][c];
+            const bool highlight = this->_highlight > 0 && changed > 0 && changed + this->_highlight > this->_frame && line[c] != ' ';
+            const bool dirty = this->_full || c >= old.size() || line[c] != old[c] || highlight != this->_marked[r][c];
+            if (!dirty) continue;
+
+            // short gaps of unchanged characters are cheaper to rewrite than to jump over
+            if (cursor_row == r && cursor_col < c && c - cursor_col <= MAX_SKIP)
+            {
+                for (; cursor_col < c; cursor_col++)
+                {
+                    if (this->_marked[r][cursor_col] != sgr_highlight)
+                    {
+                        sgr_highlight = this->_marked[r][cursor_col];
+                        this->_out += sgr_highlight ? SGR_HIGHLIGHT : SGR_RESET;
+                    }
+                    this->_out.push_back(line[cursor_col]);
+                }
+            }
+            else if (cursor_row != r || cursor_col != c)
+                append_move(this->_out, r, c);
+
+            if (highlight != sgr_highlight)
+            {
+                sgr_highlight = highlight;
+                this->_out += highlight ? SGR_HIGHLIGHT : SGR_RESET;
+            }
+            this->_out.push_back(line[c]);
+            this->_marked[r][c] = highlight;
+            cursor_row = r;
+            cursor_col = c + 1;
+        }
+    }
+    if (sgr_highlight)
+        this->_out += SGR_RESET;
+
+    // trailing empty rows are forgotten, they have been cleared on the screen
+    while (!this->_next.empty() && this->_next.back().find_first_not_of(' ') == std::string::npos)
+    {
+        this->_next.pop_back();
+        this->_changed.pop_back();
+        this->_marked.pop_back();
+    }
+    this->_prev.swap(this->_next);
+    this->_next.clear();
+    this->_full = false;
+
+    if (this->_out.empty()) return 0;
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), this->_out.data(), static_cast<DWORD>(this->_out.size()), &written, nullptr);
+    return written;
+}
@@ -0,0 +1,83 @@
+/**
+* @file     screen.h
+* @brief    Definition of the Screen-class. Keeps the last frame of a console window
+*           and only writes the characters that have changed since then.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    class Screen
+    {
+    private:
+        constexpr static uint32_t MAX_SKIP = 6;     // unchanged characters that are rewritten instead of moving the cursor
+
+        std::vector<std::string> _prev, _next;
+        std::vector<std::vector<uint64_t>> _changed;    // frame in which every character has changed the last time
+        std::vector<std::vector<bool>> _marked;         // highlight state of every character on the screen
+        std::string _out;
+        uint64_t _frame;
+        uint32_t _highlight;
+        bool _full;
+
+        /**
+        * @brief Marks a changed character and expands the mark to the whole word,
+        *   words are separated by spaces and table borders.
+        * @param[in] row: row of the character
+        * @param[in] col: column of the character
+        * @param[in] line: new content of the row
+        */
+        void mark_word(uint32_t row, uint32_t col, const std::string& line);
+
+    public:
+        Screen(void);
+        virtual ~Screen(void) = default;
+
+        /**
+        * @brief Enables the processing of ANSI escape sequences for the console.
+        * @return 'true' if the console supports escape sequences.
+        */
+        static bool enable_virtual_terminal(void) noexcept;
+
+        /**
+        * @brief Sets how long changed words are highlighted.
+        * @param[in] frames: number of frames, 0 disables highlighting
+        */
+        void set_highlight(uint32_t frames) noexcept { this->_highlight = frames; }
+
+        /** @brief Forces the next frame to be written completely. */
+        void invalidate(void) noexcept { this->_full = true; }
+
+        /**
+        * @brief Sets a line of the next frame.
+        * @param[in] row: row of the line
+        * @param[in] text: content of the line
+        */
+        void set_line(uint32_t row, const std::string& text);
+
+        /**
+        * @brief Sets multiple lines of the next frame.
+        * @param[in] lines: content of the lines
+        * @param[in] first_row: row of the first line
+        */
+        void set_lines(const std::vector<std::string>& lines, uint32_t first_row = 0);
+
+        /**
+        * @brief Writes the differences between the last and the next frame to the console with one write.
+        *   Rows that have not been set for the next frame are cleared.
+        * @return Number of bytes written.
+        */
+        size_t present(void);
+    };
+}
@@ -0,0 +1,239 @@
+/**
+* @file     shared_results.cpp
+* @brief    Implementation of the SharedResults-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "shared_results.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace memory;
+
+SharedResults::SharedResults(void)
+{
+    this->_mapping = nullptr;
+    this->_view = nullptr;
+    this->_serial = 0;
+    this->_owner = false;
+}
+
+SharedResults::~SharedResults(void)
+{
+    this->close();
+}
+
+bool SharedResults::map_new(const std::string& name, uint64_t capacity) noexcept
+{
+    const uint64_t size = segment_size(capacity);
+    HANDLE mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), name.c_str());
+    if (mapping == nullptr) return false;
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    uint8_t* view = reinterpret_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // the pages of a new mapping are zero, only the header must be initialized
+    Header* h = new (view) Header();
+    h->magic = MAGIC;
+    h->version = VERSION;
+    h->capacity = capacity;
+    h->count = 0;
+    memset(h->moved_to, 0, NAME_SIZE);
+
+    this->_mapping = mapping;
+    this->_view = view;
+    this->_name = name;
+    return true;
+}
+
+bool SharedResults::map_existing(const std::string& name) noexcept
+{
+    HANDLE mapping = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (mapping == nullptr) return false;
+
+    uint8_t* view = reinterpret_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (view == nullptr || reinterpret_cast<Header*>(view)->magic != MAGIC || reinterpret_cast<Header*>(view)->version != VERSION)
+    {
+        if (view != nullptr) UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    this->_mapping = mapping;
+    this->_view = view;
+    this->_name = name;
+    return true;
+}
+
+void SharedResults::unmap(void) noexcept
+{
+    if (this->_view != nullptr)     UnmapViewOfFile(this->_view);
+    if (this->_mapping != nullptr)  CloseHandle(this->_mapping);
+    this->_view = nullptr;
+    this->_mapping = nullptr;
+}
+
+bool SharedResults::create(const std::string& name, uint64_t capacity) noexcept
+{
+    this->close();
+    if (!this->map_new(name, std::max(capacity, MIN_CAPACITY))) return false;
+    this->_base_name = name;
+    this->_owner = true;
+    return true;
+}
+
+bool SharedResults::open(const std::string& name) noexcept
+{
+    this->close();
+    if (!this->map_existing(name)) return false;
+    this->_base_name = name;
+    this->_owner = false;
+    // a viewer may be started after the segment has been moved
+    while (this->follow());
+    return true;
+}
+
+void SharedResults::close(void) noexcept
+{
+    this->unmap();
+    this->_name.clear();
+    this->_base_name.clear();
+    this->_serial = 0;
+    this->_owner = false;
+}
+
+bool SharedResults::publish(const Buffer& buff) noexcept
+{
+    if (!this->_owner || !this->is_valid()) return false;
+    const std::vector<Buffer::Element>& table = buff.table();
+
+    // move the table to a larger segment, the viewers follow the name stored in the old segment
+    if (table.size() > this->header()->capacity)
+    {
+        HANDLE old_mapping = this->_mapping;
+        uint8_t* old_view = this->_view;
+        const std::string old_name = this->_name;
+
+        const std::string new_name = this->_base_name + "_" + std::to_string(this->_serial + 1);
+        if (!this->map_new(new_name, std::max<uint64_t>(table.size() + table.size() / 2, MIN_CAPACITY)))
+        {
+            this->_mapping = old_mapping;
+            this->_view = old_view;
+            this->_name = old_name;
+            return false;
+        }
+        ++this->_serial;
+
+        // the generation continues above the old segment, otherwise a viewer that follows the move
+        // could find the generation it has already read and would keep the old elements
+        Header* old_header = reinterpret_cast<Header*>(old_view);
+        this->header()->generation.store(old_header->generation.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        old_header->sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        strncpy(old_header->moved_to, new_name.c_str(), NAME_SIZE - 1);
+        old_header->generation.fetch_add(1, std::memory_order_relaxed);
+        old_header->sequence.fetch_add(1, std::memory_order_release);
+
+        // the old segment stays alive as long as a viewer has mapped it
+        UnmapViewOfFile(old_view);
+        CloseHandle(old_mapping);
+    }
+
+    Header* h = this->header();
+    Entry* e = this->entries();
+    h->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < table.size(); i++)
+        e[i] = { table[i].pid, static_cast<uint32_t>(table[i].type), table[i].address, static_cast<uint64_t>(table[i].size) };
+    h->count = table.size();
+    h->generation.fetch_add(1, std::memory_order_relaxed);
+    h->sequence.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+uint64_t SharedResults::generation(void) const noexcept
+{
+    if (!this->is_valid()) return 0;
+    return this->header()->generation.load(std::memory_order_acquire);
+}
+
+bool SharedResults::follow(void) noexcept
+{
+    if (this->_owner || !this->is_valid()) return false;
+
+    char moved_to[NAME_SIZE];
+    const Header* h = this->header();
+    uint32_t s0, s1;
+    do
+    {
+        s0 = h->sequence.load(std::memory_order_acquire);
+        memcpy(moved_to, h->moved_to, NAME_SIZE);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s1 = h->sequence.load(std::memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+    moved_to[NAME_SIZE - 1] = '\0';
+    if (moved_to[0] == '\0') return false;
+
+    // the old segment is kept until the new segment has been opened
+    HANDLE old_mapping = this->_mapping;
+    uint8_t* old_view = this->_view;
+    const std::string old_name = this->_name;
+    if (!this->map_existing(moved_to))
+    {
+        this->_mapping = old_mapping;
+        this->_view = old_view;
+        this->_name = old_name;
+        return false;
+    }
+    UnmapViewOfFile(old_view);
+    CloseHandle(old_mapping);
+    return true;
+}
+
+uint64_t SharedResults::read(uint64_t first, uint64_t count, std::vector<Buffer::Element>& elements, uint64_t& total) const
+{
+    elements.clear();
+    total = 0;
+    if (!this->is_valid()) return 0;
+
+    const Header* h = this->header();
+    const Entry* e = this->entries();
+    std::vector<Entry> copy;
+    uint32_t s0, s1;
+    uint64_t generation = 0;
+    do
+    {
+        s0 = h->sequence.load(std::memory_order_acquire);
+        if (s0 & 1) continue;
+
+        total = std::min(h->count, h->capacity);
+        generation = h->generation.load(std::memory_order_relaxed);
+        const uint64_t n = (first < total) ? std::min(count, total - first) : 0;
+        copy.resize(n);
+        if (n > 0)
+            memcpy(copy.data(), e + first, n * sizeof(Entry));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s1 = h->sequence.load(std::memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+
+    elements.reserve(copy.size());
+    for (const Entry& x : copy)
+        elements.push_back({ x.pid, x.address, static_cast<size_t>(x.size), static_cast<type_t>(x.type), nullptr });
+    return generation;
+}
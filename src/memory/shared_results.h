@@ -0,0 +1,145 @@
+/**
+* @file     shared_results.h
+* @brief    Definition of the SharedResults-class. Shares the stored addresses between
+*           the memory application and its viewer processes via named shared memory.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "buffer.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    /*
+    * Layout of the shared memory segment:
+    *   Header
+    *   Entry[capacity]         element table, protected by the seqlock 'Header::sequence'
+    *
+    * There is exactly one writer of the element table (the owner of the segment). Readers never
+    * block the writer, they retry if they have read while the writer was active. If the element table outgrows the segment, the owner
+    * creates a larger segment and stores its name in the header of the old one.
+    */
+    class SharedResults
+    {
+    public:
+        constexpr static uint32_t MAGIC             = 0x4D454D52;   // "MEMR"
+        constexpr static uint32_t VERSION           = 2;
+        constexpr static size_t NAME_SIZE           = 64;
+        constexpr static uint64_t MIN_CAPACITY      = 1024;
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t capacity;                      // maximum number of entries
+            std::atomic<uint32_t> sequence;         // odd while the element table is written
+            std::atomic<uint64_t> generation;       // incremented every time the element table changes
+            uint64_t count;                         // number of valid entries
+            char moved_to[NAME_SIZE];               // name of the new segment if the table has been moved
+        };
+
+        struct Entry
+        {
+            pid_t pid;
+            uint32_t type;
+            uint64_t address;
+            uint64_t size;
+        };
+
+    private:
+        HANDLE _mapping;
+        uint8_t* _view;
+        std::string _name, _base_name;
+        uint32_t _serial;       // suffix of the name if the segment has been moved
+        bool _owner;
+
+        Header* header(void) const noexcept                 { return reinterpret_cast<Header*>(this->_view); }
+        Entry* entries(void) const noexcept                 { return reinterpret_cast<Entry*>(this->_view + sizeof(Header)); }
+        static size_t segment_size(uint64_t capacity) noexcept { return sizeof(Header) + capacity * sizeof(Entry); }
+
+        /**
+        * @brief Creates and maps a new segment.
+        * @param[in] name: name of the segment
+        * @param[in] capacity: maximum number of entries
+        * @return 'true' if the segment has been created.
+        */
+        bool map_new(const std::string& name, uint64_t capacity) noexcept;
+
+        /**
+        * @brief Maps an existing segment.
+        * @param[in] name: name of the segment
+        * @return 'true' if the segment has been mapped.
+        */
+        bool map_existing(const std::string& name) noexcept;
+
+        /** @brief Unmaps the segment. */
+        void unmap(void) noexcept;
+
+    public:
+        SharedResults(void);
+        SharedResults(const SharedResults&) = delete;
+        SharedResults& operator= (const SharedResults&) = delete;
+        virtual ~SharedResults(void);
+
+        /**
+        * @brief Creates a new segment, the calling instance becomes the only writer of the element table.
+        * @param[in] name: name of the segment, must be unique in the session
+        * @param[in] capacity: initial maximum number of entries, the segment grows if required
+        * @return 'true' if the segment has been created.
+        */
+        bool create(const std::string& name, uint64_t capacity = MIN_CAPACITY) noexcept;
+
+        /**
+        * @brief Opens an existing segment. Only memory is mapped, no entries are copied.
+        * @param[in] name: name of the segment
+        * @return 'true' if the segment has been opened.
+        */
+        bool open(const std::string& name) noexcept;
+
+        /** @brief Closes the segment. */
+        void close(void) noexcept;
+
+        /** @return 'true' if a segment is mapped. */
+        bool is_valid(void) const noexcept { return this->_view != nullptr; }
+
+        /** @return Name of the current segment. */
+        const std::string& name(void) const noexcept { return this->_name; }
+
+        /**
+        * @brief Publishes all elements of a buffer (owner only).
+        *   If the buffer does not fit into the segment, it is moved to a larger segment.
+        * @param[in] buff: buffer to publish
+        * @return 'true' if the elements have been published.
+        */
+        bool publish(const Buffer& buff) noexcept;
+
+        /** @return Generation of the element table, it changes every time the elements are published. */
+        uint64_t generation(void) const noexcept;
+
+        /**
+        * @brief Follows the segment if it has been moved (viewer only).
+        * @return 'true' if the segment has been moved and the new segment has been opened.
+        */
+        bool follow(void) noexcept;
+
+        /**
+        * @brief Reads a consistent snapshot of a part of the element table.
+        *   The 'data' pointer of the elements is always 'nullptr'.
+        * @param[in] first: index of the first element
+        * @param[in] count: maximum number of elements to read
+        * @param[out] elements: read elements
+        * @param[out] total: total number of published elements
+        * @return Generation of the snapshot.
+        */
+        uint64_t read(uint64_t first, uint64_t count, std::vector<Buffer::Element>& elements, uint64_t& total) const;
+    };
+}
@@ -0,0 +1,256 @@
+/**
+* @file     snapshot.cpp
+* @brief    Implementation of the snapshot file format.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "snapshot.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+using namespace memory;
+
+namespace
+{
+    struct Chunk
+    {
+        size_t region;
+        address_t begin;
+        size_t size;
+        std::vector<bool> failed;   // one entry per page, empty if the whole chunk has been read
+    };
+
+    inline uint64_t align(uint64_t x, uint64_t alignment) noexcept
+    {
+        return (x + alignment - 1) / alignment * alignment;
+    }
+
+    inline size_t page_count(address_t begin, size_t size) noexcept
+    {
+        return (begin + size - 1) / snapshot::PAGE_SIZE - begin / snapshot::PAGE_SIZE + 1;
+    }
+
+    /** @brief Reads a chunk into the mapped file, a chunk that cannot be read at once is read page by page. */
+    void read_chunk(Process& proc, Chunk& chunk, uint8_t* dst)
+    {
+        MEMORY_TRACE_SCOPE("snapshot_read", chunk.begin, chunk.size);
+        if (proc.read(chunk.begin, chunk.size, dst) == chunk.size) return;
+
+        const address_t first_page = chunk.begin / snapshot::PAGE_SIZE;
+        const address_t end = chunk.begin + chunk.size;
+        chunk.failed.assign(page_count(chunk.begin, chunk.size), false);
+        for (size_t p = 0; p < chunk.failed.size(); p++)
+        {
+            const address_t page_begin = std::max(chunk.begin, (first_page + p) * snapshot::PAGE_SIZE);
+            const address_t page_end = std::min(end, (first_page + p + 1) * snapshot::PAGE_SIZE);
+            if (proc.read(page_begin, page_end - page_begin, dst + (page_begin - chunk.begin)) != page_end - page_begin)
+                chunk.failed[p] = true;
+        }
+    }
+
+    /** @brief Appends a readable range to the index, it is merged with the previous range if both are contiguous. */
+    void add_range(std::vector<snapshot::Region>& index, address_t base, size_t size, uint64_t offset)
+    {
+        if (size == 0) return;
+        if (!index.empty())
+        {
+            snapshot::Region& last = index.back();
+            if (last.base + last.size == base && last.offset + last.size == offset)
+            {
+                last.size += size;
+                return;
+            }
+        }
+        index.push_back({ base, size, offset });
+    }
+}
+
+bool snapshot::write(const std::string& path, Process& proc, address_t begin, address_t end, uint32_t threads,
+                     WriteResult& result, const std::atomic_bool* cancel)
+{
+    result = { 0, 0, 0, 0 };
+    if (!proc.is_valid() || begin >= end) return false;
+
+    // regions clipped to 'begin' and 'end', every region starts at an aligned offset of the file
+    std::vector<MemoryInfo> infos;
+    proc.query(begin, end, infos);
+    std::vector<Region> regions;
+    uint64_t offset = align(sizeof(FileHeader), DATA_ALIGNMENT);
+    for (const MemoryInfo& info : infos)
+    {
+        const address_t r_begin = std::max<address_t>(info.base, begin);
+        const address_t r_end = std::min<address_t>(info.base + info.size, end);
+        if (r_begin >= r_end) continue;
+        regions.push_back({ r_begin, r_end - r_begin, offset });
+        offset = align(offset + (r_end - r_begin), DATA_ALIGNMENT);
+    }
+
+    // the index cannot have more entries than pages, the unused part is cut off at the end
+    std::vector<Chunk> chunks;
+    uint64_t max_entries = 0;
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        for (uint64_t j = 0; j < regions[i].size; j += CHUNK_SIZE)
+        {
+            const size_t size = std::min<uint64_t>(regions[i].size - j, CHUNK_SIZE);
+            chunks.push_back({ i, regions[i].base + j, size, {} });
+            max_entries += page_count(regions[i].base + j, size);
+        }
+    }
+    const uint64_t index_offset = offset;
+    const uint64_t max_size = index_offset + max_entries * sizeof(Region);
+
+    HANDLE file = CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == MEMORY_INVALID_HANDLE) return false;
+
+    // pages that are never written do not take space, if the file system supports sparse files
+    DWORD returned = 0;
+    DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr);
+
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(max_size);
+    HANDLE mapping = MEMORY_NULL_HANDLE;
+    uint8_t* view = nullptr;
+    if (SetFilePointerEx(file, size, nullptr, FILE_BEGIN) && SetEndOfFile(file))
+        mapping = CreateFileMapping(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(max_size >> 32), static_cast<DWORD>(max_size), nullptr);
+    if (mapping != MEMORY_NULL_HANDLE)
+        view = reinterpret_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (view == nullptr)
+    {
+        if (mapping != MEMORY_NULL_HANDLE)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        std::remove(path.c_str());
+        return false;
+    }
+
+    // every thread takes the next chunk, the chunks do not overlap in the file
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < chunks.size(); i = next++)
+        {
+            if (cancel != nullptr && cancel->load(std::memory_order_relaxed)) return;
+            Chunk& chunk = chunks[i];
+            const Region& region = regions[chunk.region];
+            read_chunk(proc, chunk, view + region.offset + (chunk.begin - region.base));
+        }
+    };
+    if (threads == 0)
+        threads = std::min<uint32_t>(std::max<uint32_t>(std::thread::hardware_concurrency(), 1), MAX_THREADS);
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, std::max<size_t>(chunks.size(), 1)));
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < threads; i++)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool)
+        t.join();
+
+    const bool cancelled = (cancel != nullptr && cancel->load(std::memory_order_relaxed));
+    std::vector<Region> index;
+    if (!cancelled)
+    {
+        // only the readable pages are added to the index
+        for (const Chunk& chunk : chunks)
+        {
+            const Region& region = regions[chunk.region];
+            const uint64_t chunk_offset = region.offset + (chunk.begin - region.base);
+            if (chunk.failed.empty())
+            {
+                add_range(index, chunk.begin, chunk.size, chunk_offset);
+                result.bytes += chunk.size;
+                continue;
+            }
+
+            const address_t first_page = chunk.begin / PAGE_SIZE;
+            for (size_t p = 0; p < chunk.failed.size(); p++)
+            {
+                const address_t page_begin = std::max(chunk.begin, (first_page + p) * PAGE_SIZE);
+                const address_t page_end = std::min(chunk.begin + chunk.size, (first_page + p + 1) * PAGE_SIZE);
+                if (chunk.failed[p])
+                    result.failed_bytes += page_end - page_begin;
+                else
+                {
+                    add_range(index, page_begin, page_end - page_begin, chunk_offset + (page_begin - chunk.begin));
+                    result.bytes += page_end - page_begin;
+                }
+            }
+        }
+
+        FileHeader header = { FILE_MAGIC, VERSION, ENDIAN_MARK, 0, proc.pid(), static_cast<uint64_t>(std::time(nullptr)),
+                              index.size(), index_offset, result.bytes, result.failed_bytes };
+        if (!index.empty())
+            memcpy(view + index_offset, index.data(), index.size() * sizeof(Region));
+        memcpy(view, &header, sizeof(FileHeader));
+    }
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+
+    // cut off the unused part of the index
+    result.regions = index.size();
+    result.file_size = index_offset + index.size() * sizeof(Region);
+    size.QuadPart = static_cast<LONGLONG>(result.file_size);
+    const bool truncated = !cancelled && SetFilePointerEx(file, size, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+    CloseHandle(file);
+    if (!truncated)
+    {
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+Snapshot::Snapshot(void)
+{
+    memset(&this->_header, 0, sizeof(snapshot::FileHeader));
+}
+
+bool Snapshot::open(const std::string& path)
+{
+    using namespace snapshot;
+    this->close();
+
+    const uint8_t* view = this->map(path);
+    if (view == nullptr) return false;
+    const uint64_t size = this->file_size();
+    if (size < sizeof(FileHeader))
+    {
+        this->close();
+        return false;
+    }
+
+    // the header, the index and the bytes of every region must be within the file
+    memcpy(&this->_header, view, sizeof(FileHeader));
+    const FileHeader& h = this->_header;
+    bool valid = (h.magic == FILE_MAGIC && h.version == VERSION && h.endian == ENDIAN_MARK && h.index_offset <= size
+                  && h.region_count <= (size - h.index_offset) / sizeof(Region));
+    std::vector<MappedSource::Region> regions;
+    for (uint64_t i = 0; valid && i < h.region_count; i++)
+    {
+        Region r;
+        memcpy(&r, view + h.index_offset + i * sizeof(Region), sizeof(Region));
+        valid = (r.offset <= h.index_offset && r.size <= h.index_offset - r.offset);
+        regions.push_back({ r.base, static_cast<size_t>(r.size), r.offset });
+    }
+    if (!valid || !this->set_regions(std::move(regions)))
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+void Snapshot::close(void) noexcept
+{
+    this->unmap();
+    memset(&this->_header, 0, sizeof(snapshot::FileHeader));
+}
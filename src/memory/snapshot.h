@@ -0,0 +1,119 @@
+/**
+* @file     snapshot.h
+* @brief    File format of address-space snapshots and the Snapshot-class to read them.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "memory_source.h"
+#include "process.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*
+* Layout of a snapshot file:
+*   FileHeader
+*   data        the bytes of every region, each region starts at a multiple of DATA_ALIGNMENT
+*   index       Region[region_count] at 'index_offset', sorted by base address
+*
+* The file is sparse, pages that could not be read and the gaps between the regions are never written.
+* Only readable pages are part of the index, a region of the process that contains unreadable pages is
+* split into several regions. The file is written in the byte order of the host.
+*/
+
+namespace memory
+{
+    namespace snapshot
+    {
+        constexpr uint32_t FILE_MAGIC       = 0x504E534D;   // "MSNP"
+        constexpr uint32_t VERSION          = 1;
+        constexpr uint32_t ENDIAN_MARK      = 0x01020304;
+        constexpr uint64_t DATA_ALIGNMENT   = 0x10000;      // allocation granularity, regions can be mapped separately
+        constexpr uint64_t PAGE_SIZE        = 0x1000;
+        constexpr size_t CHUNK_SIZE         = 0x400000;     // 4MB per read
+        constexpr uint32_t MAX_THREADS      = 8;
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t endian;
+            uint32_t flags;             // reserved, 0
+            uint64_t pid;
+            uint64_t time;              // seconds since 1970
+            uint64_t region_count;
+            uint64_t index_offset;
+            uint64_t bytes;             // readable bytes of all regions
+            uint64_t failed_bytes;      // bytes that could not be read
+        };
+
+        struct Region
+        {
+            uint64_t base;
+            uint64_t size;
+            uint64_t offset;            // offset of the bytes in the file
+        };
+#pragma pack(pop)
+
+        struct WriteResult
+        {
+            uint64_t regions;           // regions in the index
+            uint64_t bytes;
+            uint64_t failed_bytes;
+            uint64_t file_size;
+        };
+
+        /**
+        * @brief Writes the memory of a process to a snapshot file. The regions are read in chunks of CHUNK_SIZE
+        *        by several threads directly into the mapped file.
+        * @param[in] path: path of the file
+        * @param[in] proc: opened process
+        * @param[in] begin: first address
+        * @param[in] end: address after the last address, the regions are clipped to 'begin' and 'end'
+        * @param[in] threads: number of threads, 0 uses one thread per processor up to MAX_THREADS
+        * @param[out] result: regions and bytes of the snapshot
+        * @param[in] cancel: stops writing if set, may be nullptr
+        * @return 'false' if the file could not be written or writing has been cancelled, the file is removed then.
+        */
+        bool write(const std::string& path, Process& proc, address_t begin, address_t end, uint32_t threads,
+                   WriteResult& result, const std::atomic_bool* cancel = nullptr);
+    }
+
+    /*
+    * A snapshot file that is read like the memory of a process. Views point directly into the mapped file,
+    * so they are only valid as long as the file is open.
+    */
+    class Snapshot : public MappedSource
+    {
+    private:
+        snapshot::FileHeader _header;
+
+    public:
+        Snapshot(void);
+        virtual ~Snapshot(void) = default;
+
+        /**
+        * @brief Opens and maps a snapshot file.
+        * @param[in] path: path of the file
+        * @return 'false' if the file could not be mapped or is not a valid snapshot.
+        */
+        bool open(const std::string& path) override;
+        void close(void) noexcept override;
+
+        const char* format(void) const noexcept override { return "snapshot"; }
+
+        /** @return ID of the process the snapshot has been taken from. */
+        pid_t pid(void) const noexcept override { return static_cast<pid_t>(this->_header.pid); }
+
+        /** @return Time the snapshot has been taken, in seconds since 1970. */
+        uint64_t time(void) const noexcept override { return this->_header.time; }
+    };
+}
@@ -0,0 +1,160 @@
+/**
+* @file     stats.cpp
+* @brief    Implementation of the Stats-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "stats.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+    constexpr size_t VALUE_COUNT = MEMORY_STAT_COUNT + MEMORY_PHASE_COUNT;    // counters followed by the phase times
+
+    struct Slot
+    {
+        std::atomic<uint64_t> values[VALUE_COUNT];
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Slot*> slots;
+        uint64_t retired[VALUE_COUNT] = {};
+    };
+
+    Registry& registry(void)
+    {
+        static Registry r;
+        return r;
+    }
+
+    /*
+    * Registers the slot of a thread on its first use and retires it when the thread exits.
+    * The registry is constructed before the first slot, so it is destroyed after the last one.
+    */
+    struct LocalSlot
+    {
+        Slot slot;
+
+        LocalSlot(void)
+        {
+            for (std::atomic<uint64_t>& value : this->slot.values)
+                value.store(0, std::memory_order_relaxed);
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.slots.push_back(&this->slot);
+        }
+
+        ~LocalSlot(void)
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t i = 0; i < VALUE_COUNT; i++)
+                r.retired[i] += this->slot.values[i].load(std::memory_order_relaxed);
+            r.slots.erase(std::find(r.slots.begin(), r.slots.end(), &this->slot));
+        }
+    };
+
+    thread_local LocalSlot local_slot;
+
+    inline void add_value(size_t i, uint64_t n) noexcept
+    {
+        // only the own thread writes the slot, other threads only read it
+        std::atomic<uint64_t>& value = local_slot.slot.values[i];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void to_snapshot(const uint64_t* values, Stats::Snapshot& s) noexcept
+    {
+        std::copy(values, values + MEMORY_STAT_COUNT, s.counters);
+        std::copy(values + MEMORY_STAT_COUNT, values + VALUE_COUNT, s.phase_ns);
+    }
+}
+
+void Stats::add(stat_t stat, uint64_t n) noexcept
+{
+    add_value(stat, n);
+}
+
+void Stats::add_time(phase_t phase, uint64_t ns) noexcept
+{
+    add_value(MEMORY_STAT_COUNT + phase, ns);
+}
+
+void Stats::reset_thread(void) noexcept
+{
+    for (std::atomic<uint64_t>& value : local_slot.slot.values)
+        value.store(0, std::memory_order_relaxed);
+}
+
+void Stats::thread_snapshot(Snapshot& s) noexcept
+{
+    uint64_t values[VALUE_COUNT];
+    for (size_t i = 0; i < VALUE_COUNT; i++)
+        values[i] = local_slot.slot.values[i].load(std::memory_order_relaxed);
+    to_snapshot(values, s);
+}
+
+void Stats::snapshot(Snapshot& s)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t values[VALUE_COUNT];
+    std::copy(r.retired, r.retired + VALUE_COUNT, values);
+    for (const Slot* slot : r.slots)
+    {
+        for (size_t i = 0; i < VALUE_COUNT; i++)
+            values[i] += slot->values[i].load(std::memory_order_relaxed);
+    }
+    to_snapshot(values, s);
+}
+
+void Stats::reset(void)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::fill(r.retired, r.retired + VALUE_COUNT, 0);
+    for (Slot* slot : r.slots)
+    {
+        for (std::atomic<uint64_t>& value : slot->values)
+            value.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* Stats::name(stat_t stat) noexcept
+{
+    constexpr static const char* names[MEMORY_STAT_COUNT] = {
+        "regions", "regions_skipped", "read_calls", "bytes_read", "reads_failed", "bytes_compared", "hits", "reallocations"
+    };
+    return (stat < MEMORY_STAT_COUNT) ? names[stat] : "";
+}
+
+const char* Stats::name(phase_t phase) noexcept
+{
+    constexpr static const char* names[MEMORY_PHASE_COUNT] = { "query", "read", "compare", "push" };
+    return (phase < MEMORY_PHASE_COUNT) ? names[phase] : "";
+}
+
+void Stats::to_json(const Snapshot& s, std::string& json)
+{
+    std::stringstream ss;
+    ss << "{";
+    for (uint8_t i = 0; i < MEMORY_STAT_COUNT; i++)
+        ss << (i > 0 ? ", \"" : "\"") << name(static_cast<stat_t>(i)) << "\": " << s.counters[i];
+    for (uint8_t i = 0; i < MEMORY_PHASE_COUNT; i++)
+        ss << ", \"" << name(static_cast<phase_t>(i)) << "_ns\": " << s.phase_ns[i];
+    ss << "}";
+    json = ss.str();
+}
@@ -0,0 +1,109 @@
+/**
+* @file     stats.h
+* @brief    Definition of the Stats-class. Counters and phase timers of the memory operations.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace memory
+{
+    enum stat_t : uint8_t
+    {
+        MEMORY_STAT_REGIONS = 0x0,              // regions that have been enumerated by Process::query
+        MEMORY_STAT_REGIONS_SKIPPED = 0x1,      // enumerated regions that are not committed or not accessible
+        MEMORY_STAT_READ_CALLS = 0x2,
+        MEMORY_STAT_BYTES_READ = 0x3,
+        MEMORY_STAT_READS_FAILED = 0x4,         // reads that have returned less bytes than requested
+        MEMORY_STAT_BYTES_COMPARED = 0x5,
+        MEMORY_STAT_HITS = 0x6,
+        MEMORY_STAT_REALLOCATIONS = 0x7,        // allocations and reallocations of the memory of a Buffer
+        MEMORY_STAT_COUNT = 0x8
+    };
+
+    enum phase_t : uint8_t
+    {
+        MEMORY_PHASE_QUERY = 0x0,
+        MEMORY_PHASE_READ = 0x1,
+        MEMORY_PHASE_COMPARE = 0x2,
+        MEMORY_PHASE_PUSH = 0x3,
+        MEMORY_PHASE_COUNT = 0x4
+    };
+
+    /*
+    * Every thread counts into its own slot, so counting is a relaxed atomic addition without contention.
+    * The slot of a thread that exits is added to the retired counts. An operation that runs on one thread
+    * resets the slot of its thread first and takes the snapshot of its thread afterwards.
+    */
+    class Stats
+    {
+    public:
+        struct Snapshot
+        {
+            uint64_t counters[MEMORY_STAT_COUNT];
+            uint64_t phase_ns[MEMORY_PHASE_COUNT];
+        };
+
+        /* Adds the time from construction to destruction to a phase of the current thread. */
+        class Timer
+        {
+        private:
+            phase_t _phase;
+            std::chrono::steady_clock::time_point _t0;
+
+        public:
+            explicit Timer(phase_t phase) noexcept : _phase(phase), _t0(std::chrono::steady_clock::now()) {}
+            Timer(const Timer&) = delete;
+            Timer& operator= (const Timer&) = delete;
+            ~Timer(void) { Stats::add_time(this->_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->_t0).count()); }
+        };
+
+        /**
+        * @brief Adds to a counter of the current thread.
+        * @param[in] stat: counter
+        * @param[in] n: value to add
+        */
+        static void add(stat_t stat, uint64_t n = 1) noexcept;
+
+        /**
+        * @brief Adds to the time of a phase of the current thread.
+        * @param[in] phase: phase
+        * @param[in] ns: time in nanoseconds
+        */
+        static void add_time(phase_t phase, uint64_t ns) noexcept;
+
+        /** @brief Sets all counters and times of the current thread to 0. */
+        static void reset_thread(void) noexcept;
+
+        /** @param[out] s: counters and times of the current thread */
+        static void thread_snapshot(Snapshot& s) noexcept;
+
+        /** @param[out] s: counters and times of all threads, including the threads that have exited */
+        static void snapshot(Snapshot& s);
+
+        /** @brief Sets all counters and times of all threads to 0. */
+        static void reset(void);
+
+        /** @return Name of a counter, as used in JSON. */
+        static const char* name(stat_t stat) noexcept;
+
+        /** @return Name of a phase, as used in JSON. */
+        static const char* name(phase_t phase) noexcept;
+
+        /**
+        * @brief Converts a snapshot into one JSON object: every counter and "<phase>_ns" for every phase.
+        * @param[in] s: snapshot
+        * @param[out] json: JSON object
+        */
+        static void to_json(const Snapshot& s, std::string& json);
+    };
+}
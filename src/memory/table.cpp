@@ -11,104 +11,204 @@
 
 #include "table.h"
 #include "utility.h"
+#include <cstring>
 #include <iostream>
 #include <fstream>
 
 using namespace memory;
 
+Table::Table(void) noexcept
+{
+    this->unused = 0;
+    this->widths_valid = true;
+}
+
 void Table::add_column(const std::string& title) noexcept
 {
+    this->clear_entries();
     this->cols.push_back(title);
+    this->widths.push_back(title.size());
 }
 
 void Table::add(const std::vector<std::string>& entry) noexcept
 {
-    std::vector<std::string> vec = entry;
-    vec.resize(this->cols.size());
-    this->entries.push_back(vec);
+    for (size_t col = 0; col < this->cols.size(); col++)
+    {
+        const uint32_t size = (col < entry.size()) ? entry[col].size() : 0;
+        this->cells.push_back({ this->arena.size(), size });
+        if (size > 0)
+            this->arena.append(entry[col]);
+        if (size > this->widths[col])
+            this->widths[col] = size;
+    }
 }
 
-void Table::remove(table_iterator iter) noexcept
+void Table::set(uint32_t row, uint32_t col, std::string_view str) noexcept
 {
-    this->entries.erase(iter);
+    Cell& c = this->cells[static_cast<size_t>(row) * this->cols.size() + col];
+    if (str.size() == c.size)
+    {
+        memcpy(this->arena.data() + c.offset, str.data(), str.size());
+        return;
+    }
+
+    // the cell is moved to the end of the arena
+    this->unused += c.size;
+    if (str.size() < c.size)
+        this->widths_valid = false;
+    else if (str.size() > this->widths[col])
+        this->widths[col] = str.size();
+    c = { this->arena.size(), static_cast<uint32_t>(str.size()) };
+    this->arena.append(str);
+
+    if (this->unused > this->arena.size() / 2)
+        this->compact();
 }
 
-void Table::remove(const_table_iterator iter) noexcept
+std::string_view Table::cell(uint32_t row, uint32_t col) const noexcept
 {
-    this->entries.erase(iter);
+    const Cell& c = this->cells[static_cast<size_t>(row) * this->cols.size() + col];
+    return std::string_view(this->arena.data() + c.offset, c.size);
 }
 
-void Table::get_max_width(uint32_t* width) const noexcept
+void Table::remove(uint32_t row) noexcept
 {
-    for (size_t i = 0; i < this->cols.size(); i++)
-        width[i] = this->cols[i].size();
+    if (row >= this->entry_count()) return;
+
+    const auto first = this->cells.begin() + static_cast<size_t>(row) * this->cols.size();
+    for (auto iter = first; iter != first + this->cols.size(); iter++)
+        this->unused += iter->size;
+    this->cells.erase(first, first + this->cols.size());
+    this->widths_valid = false;
+
+    if (this->unused > this->arena.size() / 2)
+        this->compact();
+}
 
-    for (auto iter = this->entries.begin(); iter != this->entries.end(); iter++)
+void Table::compact(void)
+{
+    std::string compacted;
+    compacted.reserve(this->arena.size() - this->unused);
+    for (Cell& c : this->cells)
     {
-        for (size_t i = 0; i < iter->size(); i++)
-        {
-            if ((*iter)[i].size() > width[i])
-                width[i] = (*iter)[i].size();
-        }
+        const size_t offset = compacted.size();
+        compacted.append(this->arena, c.offset, c.size);
+        c.offset = offset;
     }
+    this->arena.swap(compacted);
+    this->unused = 0;
 }
 
-void Table::get_line(const uint32_t* width, const std::vector<std::string>& entry, std::string& line) const noexcept
+void Table::update_widths(void) const noexcept
+{
+    if (this->widths_valid) return;
+
+    const size_t n_cols = this->cols.size();
+    for (size_t col = 0; col < n_cols; col++)
+        this->widths[col] = this->cols[col].size();
+    for (size_t i = 0; i < this->cells.size(); i++)
+    {
+        if (this->cells[i].size > this->widths[i % n_cols])
+            this->widths[i % n_cols] = this->cells[i].size;
+    }
+    this->widths_valid = true;
+}
+
+size_t Table::line_size(void) const noexcept
+{
+    this->update_widths();
+    size_t size = 1;
+    for (uint32_t w : this->widths)
+        size += w + 3;  // vertical char + 2 spaces
+    return size;
+}
+
+void Table::write_line(const std::string_view* cells, char* dst) const noexcept
 {
-    line.clear();
     for (size_t col = 0; col < this->cols.size(); col++)
     {
-        line.push_back(VERTICAL_CHAR);
-        line.push_back(' ');
-        line += entry[col]; // seems to be faster than string::insert
-        line.insert(line.size(), width[col] - entry[col].size(), ' ');
-        line.push_back(' ');
+        *dst++ = VERTICAL_CHAR;
+        *dst++ = ' ';
+        memcpy(dst, cells[col].data(), cells[col].size());
+        memset(dst + cells[col].size(), ' ', this->widths[col] - cells[col].size() + 1);
+        dst += this->widths[col] + 1;
     }
-    line.push_back(VERTICAL_CHAR);
+    *dst = VERTICAL_CHAR;
 }
 
-void Table::get_separator_line(const uint32_t* width, std::string& line) const noexcept
+void Table::write_separator_line(char* dst) const noexcept
 {
-    line.clear();
     for (size_t col = 0; col < this->cols.size(); col++)
     {
-        line.push_back(CORNER_CHAR);
-        line.insert(line.size(), width[col] + 2, HORIZONTAL_CHAR);
+        *dst++ = CORNER_CHAR;
+        memset(dst, HORIZONTAL_CHAR, this->widths[col] + 2);
+        dst += this->widths[col] + 2;
     }
-    line.push_back(CORNER_CHAR);
+    *dst = CORNER_CHAR;
+}
+
+void Table::render_buffer(std::string& buffer) const
+{
+    const size_t n_cols = this->cols.size();
+    const size_t line = this->line_size() + 1;
+    const size_t n_lines = this->entry_count() + 4;
+    buffer.resize(n_lines * line);
+
+    char* dst = buffer.data();
+    std::vector<std::string_view> row(n_cols);
+    this->write_separator_line(dst);
+    dst[line - 1] = '\n';
+    dst += line;
+
+    for (size_t col = 0; col < n_cols; col++)
+        row[col] = this->cols[col];
+    this->write_line(row.data(), dst);
+    dst[line - 1] = '\n';
+    memcpy(dst + line, buffer.data(), line);
+    dst += 2 * line;
+
+    for (size_t i = 0; i < this->cells.size(); i += n_cols)
+    {
+        for (size_t col = 0; col < n_cols; col++)
+            row[col] = std::string_view(this->arena.data() + this->cells[i + col].offset, this->cells[i + col].size);
+        this->write_line(row.data(), dst);
+        dst[line - 1] = '\n';
+        dst += line;
+    }
+    memcpy(dst, buffer.data(), line);
 }
 
 void Table::clear(void) noexcept
 {
     this->cols.clear();
-    this->entries.clear();
+    this->widths.clear();
+    this->clear_entries();
 }
 
 void Table::clear_entries(void) noexcept
 {
-    this->entries.clear();
+    this->cells.clear();
+    this->arena.clear();
+    this->unused = 0;
+    for (size_t col = 0; col < this->cols.size(); col++)
+        this->widths[col] = this->cols[col].size();
+    this->widths_valid = true;
 }
 
-void Table::print(void) const noexcept
+void Table::render(std::vector<std::string>& lines) const
 {
-    uint32_t width[this->cols.size()];
-    this->get_max_width(width);
-
-    std::string sep_line, line;
-    this->get_separator_line(width, sep_line);
-    this->get_line(width, this->cols, line);
-
-    std::cout << sep_line << std::endl;
-    std::cout << line << std::endl;
-    std::cout << sep_line << std::endl;
-
-    for (const std::vector<std::string>& entry : this->entries)
-    {
-        this->get_line(width, entry, line);
-        std::cout << line << std::endl;
-    }
+    this->render_buffer(this->out);
+    const size_t line = this->line_size() + 1;
+    lines.resize(this->out.size() / line);
+    for (size_t i = 0; i < lines.size(); i++)
+        lines[i].assign(this->out, i * line, line - 1);
+}
 
-    std::cout << sep_line << std::endl;
+void Table::print(void) const noexcept
+{
+    this->render_buffer(this->out);
+    std::cout.write(this->out.data(), this->out.size());
+    std::cout.flush();
 }
 
 bool Table::print_to_file(const std::string& path) const noexcept
@@ -145,18 +245,14 @@ bool Table::print_to_file(const std::string& path) const noexcept
     file.write(reinterpret_cast<const char*>(&entry_count), sizeof(uint32_t));
 
     // print entries
-    for (const std::vector<std::string>& entry: this->entries)
+    for (const Cell& c : this->cells)
     {
-        // print columns of entry
-        for (const std::string& str : entry)
-        {
-            // pint column string size
-            uint64_t size = utility::htons<uint64_t>(static_cast<uint64_t>(str.size()));
-            file.write(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+        // pint column string size
+        uint64_t size = utility::htons<uint64_t>(static_cast<uint64_t>(c.size));
+        file.write(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
 
-            // print string
-            file.write(str.data(), str.size());
-        }
+        // print string
+        file.write(this->arena.data() + c.offset, c.size);
     }
 
     file.close();
@@ -234,36 +330,10 @@ bool Table::read_from_file(const std::string& path) noexcept
 
 uint32_t Table::entry_count(void) const noexcept
 {
-    return this->entries.size();
+    return this->cols.empty() ? 0 : this->cells.size() / this->cols.size();
 }
 
 uint32_t Table::col_count(void) const noexcept
 {
     return this->cols.size();
 }
-
-Table::table_iterator Table::begin(void) noexcept
-{
-    return this->entries.begin();
-}
-
-Table::table_iterator Table::end(void) noexcept
-{
-    return this->entries.end();
-}
-
-Table::const_table_iterator Table::begin(void) const noexcept
-{
-    return this->entries.begin();
-}
-
-
-Table::const_table_iterator Table::end(void) const noexcept
-{
-    return this->entries.end();
-}
-
-std::list<std::vector<std::string>>& Table::get_entries(void) noexcept
-{
-    return this->entries;
-}
@@ -11,72 +11,106 @@
 
 #pragma once
 
-#include <vector>
-#include <list>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace memory
 {
+    /*
+    * The cells of all entries are stored in one contiguous character arena, every cell is
+    * referenced by its offset and size. Cells of an entry are stored consecutively, so the
+    * cell (row, col) is located at 'row * col_count() + col'. Replaced and removed cells
+    * leave unused characters in the arena, which are compacted if they take up more than
+    * half of it.
+    */
     class Table
     {
     private:
+        struct Cell
+        {
+            size_t offset;
+            uint32_t size;
+        };
+
         std::vector<std::string> cols;
-        std::list<std::vector<std::string>> entries;
+        std::vector<Cell> cells;
+        std::string arena;
+        size_t unused;                          // number of unused characters in the arena
+        mutable std::vector<uint32_t> widths;   // maximum width of every column, maintained on add
+        mutable bool widths_valid;              // 'false' if a cell has become smaller or has been removed
+        mutable std::string out;                // output buffer, reused by every print
 
-    protected:
-        using table_iterator = std::list<std::vector<std::string>>::iterator;
-        using const_table_iterator = std::list<std::vector<std::string>>::const_iterator;
+        /** @brief Removes the unused characters of the arena. */
+        void compact(void);
 
-        constexpr static char CORNER_CHAR = '+';
-        constexpr static char HORIZONTAL_CHAR = '-';
-        constexpr static char VERTICAL_CHAR = '|';
+        /** @brief Recomputes the column widths if they are not valid. */
+        void update_widths(void) const noexcept;
 
         /**
-        * @brief Returns the maximum column width.
-        * @param[out] width: max column width
+        * @brief Writes a line of the table.
+        * @param[in] cells: content of every column
+        * @param[out] dst: destination of the line, 'line_size()' characters
         */
-        void get_max_width(uint32_t* width) const noexcept;
+        void write_line(const std::string_view* cells, char* dst) const noexcept;
 
         /**
-        * @brief Generates a line to print from an entry.
-        * @param[in] width: width of the column
-        * @param[in] entry: the entry to print
-        * @param[out] line: line-string
+        * @brief Writes a line to separate sections of the table.
+        * @param[out] dst: destination of the line, 'line_size()' characters
         */
-        void get_line(const uint32_t* width, const std::vector<std::string>& entry, std::string& line) const noexcept;
+        void write_separator_line(char* dst) const noexcept;
+
+    protected:
+        constexpr static char CORNER_CHAR = '+';
+        constexpr static char HORIZONTAL_CHAR = '-';
+        constexpr static char VERTICAL_CHAR = '|';
+
+        /** @return Number of characters of one rendered line, excluding the line break. */
+        size_t line_size(void) const noexcept;
 
         /**
-        * @brief Generates a line to separate sections of the table.
-        * @param[in] width: width of the column
-        * @param[out] line: line-string
+        * @brief Renders the table into one buffer, every line is terminated by a line break.
+        * @param[out] buffer: rendered table
         */
-        void get_separator_line(const uint32_t* width, std::string& line) const noexcept;
-
-        /** @return All entries. */
-        std::list<std::vector<std::string>>& get_entries(void) noexcept;
+        void render_buffer(std::string& buffer) const;
 
     public:
-        Table(void) noexcept = default;
+        Table(void) noexcept;
         virtual ~Table(void) = default;
 
         /**
-        * @brief Adds a column to the table.
+        * @brief Adds a column to the table, all entries are removed.
         * @param[in] title: title of the column
         */
         void add_column(const std::string& title) noexcept;
 
         /**
         * @brief Adds a new entry at the end of the table.
-        * @param[in] entry: entry for every column
+        * @param[in] entry: entry for every column, missing columns are empty
         */
         void add(const std::vector<std::string>& entry) noexcept;
 
+        /**
+        * @brief Replaces the content of a cell.
+        * @param[in] row: index of the entry
+        * @param[in] col: index of the column
+        * @param[in] str: new content
+        */
+        void set(uint32_t row, uint32_t col, std::string_view str) noexcept;
+
+        /**
+        * @param[in] row: index of the entry
+        * @param[in] col: index of the column
+        * @return Content of a cell, it is valid until the table is modified.
+        */
+        std::string_view cell(uint32_t row, uint32_t col) const noexcept;
+
         /**
         * @brief Removes an entry.
-        * @param[in] iter: iterator to the element to remove
+        * @param[in] row: index of the entry to remove
         */
-        void remove(table_iterator iter) noexcept;
-        void remove(const_table_iterator iter) noexcept;
+        void remove(uint32_t row) noexcept;
 
         /** @return Number of columns. */
         uint32_t col_count(void) const noexcept;
@@ -84,21 +118,19 @@ namespace memory
         /** @return Number of entries. */
         uint32_t entry_count(void) const noexcept;
 
-        /** @return An iterator to the first entry. */
-        table_iterator begin(void) noexcept;
-        const_table_iterator begin(void) const noexcept;
-
-        /** @return An iterator AFTER the last entry. */
-        table_iterator end(void) noexcept;
-        const_table_iterator end(void) const noexcept;
-
         /** @brief Cleares the whole table. */
         void clear(void) noexcept;
 
         /** @brief Cleares all entries. */
         void clear_entries(void) noexcept;
 
-        /** @brief Prints the table. */
+        /**
+        * @brief Renders the table into lines without printing it.
+        * @param[out] lines: rendered lines
+        */
+        virtual void render(std::vector<std::string>& lines) const;
+
+        /** @brief Prints the table with a single write. */
         virtual void print(void) const noexcept;
 
         /** 
@@ -118,37 +150,60 @@ namespace memory
         virtual bool read_from_file(const std::string& path) noexcept;
     };
 
-    class HexDump : protected Table
+    /*
+    * The memory table is stored as one buffer of fixed-width lines, that is reused for every frame:
+    *   +------------------+---------------------+----------+
+    *   | 0000000000001000 | 00 01 02 03  04 ... | ........ |
+    *   +------------------+---------------------+----------+
+    * The address, the bytes and the optional ASCII column are encoded directly into their place.
+    */
+    class HexDump
     {
     private:
+        constexpr static char CORNER_CHAR = '+';
+        constexpr static char HORIZONTAL_CHAR = '-';
+        constexpr static char VERTICAL_CHAR = '|';
+        constexpr static uint32_t ADDRESS_SIZE = 16;    // number of characters of an address
+
         uint32_t _width;
-        table_iterator iter;
-        std::string init_hex_string;
+        uint32_t _lines;
+        uint32_t _row;              // internal iterator
+        bool _ascii;
+        size_t _line_size;          // number of characters of a line, including the line break
+        size_t _hex_offset;         // offset of the bytes within a line
+        size_t _ascii_offset;       // offset of the ASCII column within a line
+        std::string _buffer;        // separator line, memory lines, separator line
+        std::string _init_line;     // memory line of the address 0x0 with 0-bytes
 
-        /** @brief Initializes 'init_hex_string' width 0-bytes. */
-        void init_hex(void) noexcept;
+        /** @brief Rebuilds the line template and the buffer. */
+        void init_lines(void);
 
-    protected:
-        constexpr static char NULLPTR_STR[] = "0000000000000000";   // address: 0x0 in string format
+        /** @return Pointer to the beginning of a memory line. */
+        char* line(uint32_t row) noexcept { return this->_buffer.data() + (row + 1) * this->_line_size; }
 
+    protected:
         /**
-        * @brief Encodes bytes into a string.
+        * @brief Encodes bytes into their place within a line, 16 bytes are encoded at once.
+        *   The bytes are separated by a space and every 4 bytes by an additional space.
         * @param[in] bytes: bytes to encode
-        * @param[out] str: encoded string
+        * @param[in] count: number of bytes
+        * @param[out] hex: destination of the encoded bytes, '3 * count - 1 + (count - 1) / 4' characters
+        * @param[out] ascii: destination of the ASCII characters, 'count' characters,
+        *   can be nullptr if the ASCII column is not shown
         */
-        void encode_hex(const uint8_t* bytes, std::string& str) noexcept;
+        static void encode_hex(const uint8_t* bytes, uint32_t count, char* hex, char* ascii) noexcept;
 
         /**
-        * @brief Encodes an address into a string.
+        * @brief Encodes an address into 16 hexadecimal characters.
         * @param[in] address: address to encode
-        * @param[out] str: encoded string
+        * @param[out] str: destination of the encoded address
         */
-        void encode_addr(uint64_t address, std::string& str) noexcept;
+        static void encode_addr(uint64_t address, char* str) noexcept;
 
     public:
         HexDump(void) noexcept;
-        explicit HexDump(uint32_t lines, uint32_t width = 0x10);
-        virtual ~HexDump(void);
+        explicit HexDump(uint32_t lines, uint32_t width = 0x10, bool ascii = false);
+        virtual ~HexDump(void) = default;
 
         /**
         * @brief Sets the bytes at the internal iterator.
@@ -163,6 +218,13 @@ namespace memory
         */
         void set(uint64_t address, const uint8_t* bytes) noexcept;
 
+        /**
+        * @brief Marks bytes at the internal iterator as unreadable, they are shown as "??".
+        * @param[in] first: index of the first byte within the line
+        * @param[in] count: number of bytes
+        */
+        void set_unreadable(uint32_t first, uint32_t count) noexcept;
+
         /** @brief Scrolls the memory-table up. */
         void scroll_up(void) noexcept;
 
@@ -182,19 +244,31 @@ namespace memory
         void back(void) noexcept;
 
         /**
-        * @brief Resizes the memory-table.
+        * @brief Resizes the memory-table, all lines are reset.
         * @param[in] lines: new line count
         * @param[in] width: new width
         */
         void resize(uint32_t lines, uint32_t width);
 
+        /**
+        * @brief Shows or hides the ASCII column, all lines are reset.
+        * @param[in] ascii: 'true' to show the ASCII column
+        */
+        void show_ascii(bool ascii);
+
         /** @return Number of lines. */
         uint32_t line_count(void) const noexcept;
 
         /** @return Current width. */
         uint32_t width(void) const noexcept;
 
-        /** @brief Prints the memory table. */
-        virtual void print(void) const noexcept override;
+        /**
+        * @brief Renders the memory table into lines without printing it.
+        * @param[out] lines: rendered lines
+        */
+        void render(std::vector<std::string>& lines) const;
+
+        /** @brief Prints the memory table with a single write. */
+        void print(void) const noexcept;
     };
 }
@@ -0,0 +1,210 @@
+/**
+* @file     trace.cpp
+* @brief    Implementation of the Trace-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+    struct ThreadEvents
+    {
+        uint32_t tid;
+        std::vector<Trace::Event> events;
+    };
+
+    struct ThreadBuffer
+    {
+        uint32_t tid;
+        std::unique_ptr<Trace::Event[]> events;
+        std::atomic<size_t> size;       // events below 'size' are complete
+        std::atomic<uint64_t> epoch;    // epoch of the events, only written by the own thread
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<ThreadBuffer*> buffers;
+        std::vector<ThreadEvents> retired;
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> epoch{0};     // incremented by every clear
+        uint32_t next_tid = 1;
+    };
+
+    Registry& registry(void)
+    {
+        static Registry r;
+        return r;
+    }
+
+    /** @return Number of complete events of a buffer, a buffer of an older epoch is empty. */
+    size_t events(const Registry& r, const ThreadBuffer& buffer) noexcept
+    {
+        // the size has been reset before the epoch of the buffer has been updated
+        if (buffer.epoch.load(std::memory_order_acquire) != r.epoch.load(std::memory_order_acquire)) return 0;
+        return buffer.size.load(std::memory_order_acquire);
+    }
+
+    thread_local bool excluded = false;
+
+    /* Registers the buffer of a thread on its first event and keeps its events when the thread exits. */
+    struct LocalBuffer
+    {
+        ThreadBuffer buffer;
+
+        LocalBuffer(void)
+        {
+            this->buffer.events.reset(new Trace::Event[Trace::EVENT_CAPACITY]);
+            this->buffer.size.store(0, std::memory_order_relaxed);
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            this->buffer.epoch.store(r.epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            this->buffer.tid = r.next_tid++;
+            r.buffers.push_back(&this->buffer);
+        }
+
+        ~LocalBuffer(void)
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            const size_t n = events(r, this->buffer);
+            if (n > 0)
+                r.retired.push_back({ this->buffer.tid, std::vector<Trace::Event>(this->buffer.events.get(), this->buffer.events.get() + n) });
+            r.buffers.erase(std::find(r.buffers.begin(), r.buffers.end(), &this->buffer));
+        }
+    };
+
+    uint64_t now_ns(void) noexcept
+    {
+        using namespace std::chrono;
+        static const steady_clock::time_point epoch = steady_clock::now();
+        return duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+    }
+}
+
+Trace::Scope::Scope(const char* name, uint64_t address, uint64_t bytes) noexcept
+    : _name(name), _address(address), _bytes(bytes), _begin_ns(now_ns())
+{}
+
+Trace::Scope::~Scope(void)
+{
+    const Event e = { this->_name, this->_begin_ns, now_ns() - this->_begin_ns, this->_address, this->_bytes };
+    Trace::record(e);
+}
+
+void Trace::record(const Event& e) noexcept
+{
+    if (excluded) return;
+    thread_local LocalBuffer local;
+    ThreadBuffer& buffer = local.buffer;
+
+    // the events of an older epoch have been cleared, only the own thread resets its buffer
+    const uint64_t epoch = registry().epoch.load(std::memory_order_acquire);
+    if (buffer.epoch.load(std::memory_order_relaxed) != epoch)
+    {
+        buffer.size.store(0, std::memory_order_relaxed);
+        buffer.epoch.store(epoch, std::memory_order_release);
+    }
+
+    // only the own thread appends, the event is published by the release store of the size
+    const size_t n = buffer.size.load(std::memory_order_relaxed);
+    if (n >= EVENT_CAPACITY)
+    {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[n] = e;
+    buffer.size.store(n + 1, std::memory_order_release);
+}
+
+void Trace::exclude_thread(void) noexcept
+{
+    excluded = true;
+}
+
+uint64_t Trace::now(void) noexcept
+{
+    return now_ns();
+}
+
+size_t Trace::size(uint64_t begin_ns)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto count = [begin_ns](const Event* first, const Event* last)
+    {
+        return static_cast<size_t>(std::count_if(first, last, [begin_ns](const Event& e) { return e.begin_ns >= begin_ns; }));
+    };
+    size_t n = 0;
+    for (const ThreadBuffer* buffer : r.buffers)
+        n += count(buffer->events.get(), buffer->events.get() + events(r, *buffer));
+    for (const ThreadEvents& t : r.retired)
+        n += count(t.events.data(), t.events.data() + t.events.size());
+    return n;
+}
+
+uint64_t Trace::dropped(void)
+{
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+void Trace::clear(void)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.epoch.fetch_add(1, std::memory_order_acq_rel);
+    r.retired.clear();
+    r.dropped.store(0, std::memory_order_relaxed);
+}
+
+bool Trace::write_json(const std::string& path, uint32_t pid, uint64_t begin_ns)
+{
+    // copy the completed events, so that the file is written without holding the lock
+    std::vector<ThreadEvents> threads;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        threads = r.retired;
+        for (const ThreadBuffer* buffer : r.buffers)
+        {
+            const size_t n = events(r, *buffer);
+            threads.push_back({ buffer->tid, std::vector<Event>(buffer->events.get(), buffer->events.get() + n) });
+        }
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) return false;
+
+    // complete events ("ph": "X"), the timestamps are in microseconds
+    bool first = true;
+    file << "{\"traceEvents\": [" << std::fixed << std::setprecision(3);
+    for (const ThreadEvents& t : threads)
+    {
+        for (const Event& e : t.events)
+        {
+            if (e.begin_ns < begin_ns) continue;
+            file << (first ? "\n" : ",\n") << "{\"name\": \"" << e.name << "\", \"cat\": \"memory\", \"ph\": \"X\", \"ts\": " << e.begin_ns / 1000.0
+                 << ", \"dur\": " << e.duration_ns / 1000.0 << ", \"pid\": " << pid << ", \"tid\": " << t.tid
+                 << ", \"args\": {\"address\": \"0x" << std::hex << e.address << std::dec << "\", \"bytes\": " << e.bytes << "}}";
+            first = false;
+        }
+    }
+    file << "\n], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped\": " << dropped() << "}}" << std::endl;
+    return static_cast<bool>(file);
+}
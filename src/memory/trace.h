@@ -0,0 +1,106 @@
+/**
+* @file     trace.h
+* @brief    Definition of the Trace-class. Timeline of the memory operations in the Chrome trace-event format.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+* Tracing is compiled in with the definition MEMORY_TRACE (CMake option MEMORY_TRACE). Without it
+* MEMORY_TRACE_SCOPE expands to nothing and its arguments are not evaluated.
+*/
+#ifdef MEMORY_TRACE
+    #define MEMORY_TRACE_CONCAT_IMPL(a, b) a##b
+    #define MEMORY_TRACE_CONCAT(a, b) MEMORY_TRACE_CONCAT_IMPL(a, b)
+    #define MEMORY_TRACE_SCOPE(name, address, bytes) memory::Trace::Scope MEMORY_TRACE_CONCAT(_trace_scope_, __LINE__)(name, address, bytes)
+#else
+    #define MEMORY_TRACE_SCOPE(name, address, bytes) ((void)0)
+#endif
+
+namespace memory
+{
+    /*
+    * Every thread records into its own buffer of EVENT_CAPACITY events without locking, further events of
+    * a full buffer are dropped. The buffer of a thread that exits is kept until the events are cleared.
+    * The events can be exported and cleared while threads are recording, an event is exported once it has ended.
+    * Clearing starts a new epoch, a buffer of an older epoch counts as empty and is reset by its own thread.
+    */
+    class Trace
+    {
+    public:
+#ifdef MEMORY_TRACE
+        constexpr static bool ENABLED = true;
+#else
+        constexpr static bool ENABLED = false;
+#endif
+        constexpr static size_t EVENT_CAPACITY = 0x10000;   // events per thread
+
+        struct Event
+        {
+            const char* name;       // must be a string literal
+            uint64_t begin_ns;      // since the first event of the process
+            uint64_t duration_ns;
+            uint64_t address;
+            uint64_t bytes;
+        };
+
+        /* Records an event from construction to destruction on the current thread. */
+        class Scope
+        {
+        private:
+            const char* _name;
+            uint64_t _address, _bytes, _begin_ns;
+
+        public:
+            Scope(const char* name, uint64_t address, uint64_t bytes) noexcept;
+            Scope(const Scope&) = delete;
+            Scope& operator= (const Scope&) = delete;
+            ~Scope(void);
+        };
+
+        /**
+        * @brief Records an event on the current thread.
+        * @param[in] e: event
+        */
+        static void record(const Event& e) noexcept;
+
+        /**
+        * @brief Stops recording the events of the current thread, for threads that run in the background
+        *   and do not belong to an operation.
+        */
+        static void exclude_thread(void) noexcept;
+
+        /** @return Current time of the trace in nanoseconds, the same clock as Event::begin_ns. */
+        static uint64_t now(void) noexcept;
+
+        /**
+        * @param[in] begin_ns: only events that have begun at or after this time are counted
+        * @return Number of recorded events of all threads.
+        */
+        static size_t size(uint64_t begin_ns = 0);
+
+        /** @return Number of events that have been dropped because a buffer was full. */
+        static uint64_t dropped(void);
+
+        /** @brief Removes the events of all threads. */
+        static void clear(void);
+
+        /**
+        * @brief Writes all recorded events as Chrome trace-event JSON, that can be opened with chrome://tracing or Perfetto.
+        * @param[in] path: file name
+        * @param[in] pid: process ID that is written to every event
+        * @param[in] begin_ns: only events that have begun at or after this time are written
+        * @return 'true' if the file has been written
+        */
+        static bool write_json(const std::string& path, uint32_t pid, uint64_t begin_ns = 0);
+    };
+}
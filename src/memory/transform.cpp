@@ -0,0 +1,314 @@
+/**
+* @file     transform.cpp
+* @brief    Implementation of arithmetic transformations over packed values.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "transform.h"
+#include <immintrin.h>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+using namespace memory;
+
+namespace
+{
+    /*
+    * The kernels work on packed arrays, the generic loops are written without branches
+    * so that the compiler can vectorize them. Operations which have a dedicated SIMD
+    * instruction (saturating 8/16-bit arithmetic, floating point arithmetic) are written
+    * explicitly with intrinsics.
+    */
+
+    template<typename T, typename F>
+    inline void apply(T* v, size_t n, F f) noexcept
+    {
+        for (size_t i = 0; i < n; i++)
+            v[i] = f(v[i]);
+    }
+
+    template<typename T>
+    inline T wrap_add(T x, T a) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(x) + static_cast<U>(a)));
+    }
+
+    template<typename T>
+    inline T wrap_sub(T x, T a) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(x) - static_cast<U>(a)));
+    }
+
+    template<typename T>
+    inline T wrap_mul(T x, T a) noexcept
+    {
+        // 8 and 16 bit values are promoted to int, which could overflow
+        using U = std::make_unsigned_t<T>;
+        using W = std::conditional_t<(sizeof(T) < sizeof(uint32_t)), uint32_t, U>;
+        return static_cast<T>(static_cast<U>(static_cast<W>(static_cast<U>(x)) * static_cast<W>(static_cast<U>(a))));
+    }
+
+    template<typename T>
+    inline T sat_add(T x, T a) noexcept
+    {
+        T r;
+        if (!__builtin_add_overflow(x, a, &r)) return r;
+        return (std::is_signed<T>::value && a < 0) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+
+    template<typename T>
+    inline T sat_sub(T x, T a) noexcept
+    {
+        T r;
+        if (!__builtin_sub_overflow(x, a, &r)) return r;
+        return (std::is_signed<T>::value && a < 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+    }
+
+    template<typename T>
+    inline T sat_mul(T x, T a) noexcept
+    {
+        T r;
+        if (!__builtin_mul_overflow(x, a, &r)) return r;
+        return (std::is_signed<T>::value && ((x < 0) != (a < 0))) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+
+    template<typename T>
+    inline T min_of(T x, T a) noexcept { return (x < a) ? x : a; }
+
+    template<typename T>
+    inline T max_of(T x, T a) noexcept { return (x > a) ? x : a; }
+
+    /**
+    * @brief Saturating 8/16-bit addition and subtraction with SSE2.
+    * @return Number of processed values, the rest must be processed by the generic kernel.
+    */
+    template<typename T>
+    size_t sse_saturate(transform_t op, T a, T* v, size_t n) noexcept
+    {
+        if (op != MEMORY_TRANSFORM_ADD && op != MEMORY_TRANSFORM_SUB) return 0;
+
+        constexpr size_t lanes = sizeof(__m128i) / sizeof(T);
+        const __m128i va = (sizeof(T) == 1) ? _mm_set1_epi8(static_cast<char>(a)) : _mm_set1_epi16(static_cast<short>(a));
+        const bool add = (op == MEMORY_TRANSFORM_ADD);
+
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+        {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+            if (sizeof(T) == 1 && std::is_signed<T>::value)     x = add ? _mm_adds_epi8(x, va)  : _mm_subs_epi8(x, va);
+            if (sizeof(T) == 1 && !std::is_signed<T>::value)    x = add ? _mm_adds_epu8(x, va)  : _mm_subs_epu8(x, va);
+            if (sizeof(T) == 2 && std::is_signed<T>::value)     x = add ? _mm_adds_epi16(x, va) : _mm_subs_epi16(x, va);
+            if (sizeof(T) == 2 && !std::is_signed<T>::value)    x = add ? _mm_adds_epu16(x, va) : _mm_subs_epu16(x, va);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(v + i), x);
+        }
+        return i;
+    }
+
+    /**
+    * @brief Floating point arithmetic with AVX.
+    * @return Number of processed values, the rest must be processed by the generic kernel.
+    */
+    size_t avx_float(transform_t op, float a, float b, float* v, size_t n) noexcept
+    {
+        const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(v + i);
+            switch (op)
+            {
+            case MEMORY_TRANSFORM_ADD:      x = _mm256_add_ps(x, va); break;
+            case MEMORY_TRANSFORM_SUB:      x = _mm256_sub_ps(x, va); break;
+            case MEMORY_TRANSFORM_MUL:      x = _mm256_mul_ps(x, va); break;
+            case MEMORY_TRANSFORM_MIN:      x = _mm256_min_ps(x, va); break;
+            case MEMORY_TRANSFORM_MAX:      x = _mm256_max_ps(x, va); break;
+            case MEMORY_TRANSFORM_CLAMP:    x = _mm256_min_ps(_mm256_max_ps(x, va), vb); break;
+            default: return 0;
+            }
+            _mm256_storeu_ps(v + i, x);
+        }
+        return i;
+    }
+
+    size_t avx_double(transform_t op, double a, double b, double* v, size_t n) noexcept
+    {
+        const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d x = _mm256_loadu_pd(v + i);
+            switch (op)
+            {
+            case MEMORY_TRANSFORM_ADD:      x = _mm256_add_pd(x, va); break;
+            case MEMORY_TRANSFORM_SUB:      x = _mm256_sub_pd(x, va); break;
+            case MEMORY_TRANSFORM_MUL:      x = _mm256_mul_pd(x, va); break;
+            case MEMORY_TRANSFORM_MIN:      x = _mm256_min_pd(x, va); break;
+            case MEMORY_TRANSFORM_MAX:      x = _mm256_max_pd(x, va); break;
+            case MEMORY_TRANSFORM_CLAMP:    x = _mm256_min_pd(_mm256_max_pd(x, va), vb); break;
+            default: return 0;
+            }
+            _mm256_storeu_pd(v + i, x);
+        }
+        return i;
+    }
+
+    template<typename T>
+    bool transform_integral(transform_t op, T a, T b, bool saturate, T* v, size_t n) noexcept
+    {
+        if (saturate && sizeof(T) <= 2)
+        {
+            const size_t done = sse_saturate<T>(op, a, v, n);
+            v += done;
+            n -= done;
+        }
+
+        switch (op)
+        {
+        case MEMORY_TRANSFORM_ADD:
+            if (saturate)   apply(v, n, [a](T x) { return sat_add(x, a); });
+            else            apply(v, n, [a](T x) { return wrap_add(x, a); });
+            return true;
+        case MEMORY_TRANSFORM_SUB:
+            if (saturate)   apply(v, n, [a](T x) { return sat_sub(x, a); });
+            else            apply(v, n, [a](T x) { return wrap_sub(x, a); });
+            return true;
+        case MEMORY_TRANSFORM_MUL:
+            if (saturate)   apply(v, n, [a](T x) { return sat_mul(x, a); });
+            else            apply(v, n, [a](T x) { return wrap_mul(x, a); });
+            return true;
+        case MEMORY_TRANSFORM_XOR:      apply(v, n, [a](T x) { return static_cast<T>(x ^ a); });            return true;
+        case MEMORY_TRANSFORM_AND:      apply(v, n, [a](T x) { return static_cast<T>(x & a); });            return true;
+        case MEMORY_TRANSFORM_OR:       apply(v, n, [a](T x) { return static_cast<T>(x | a); });            return true;
+        case MEMORY_TRANSFORM_MIN:      apply(v, n, [a](T x) { return min_of(x, a); });                     return true;
+        case MEMORY_TRANSFORM_MAX:      apply(v, n, [a](T x) { return max_of(x, a); });                     return true;
+        case MEMORY_TRANSFORM_CLAMP:    apply(v, n, [a, b](T x) { return min_of(max_of(x, a), b); });      return true;
+        default:                        return false;
+        }
+    }
+
+    template<typename T>
+    bool transform_floating_point(transform_t op, T a, T b, T* v, size_t n) noexcept
+    {
+        size_t done;
+        if constexpr (std::is_same<T, float>::value)    done = avx_float(op, a, b, v, n);
+        else                                            done = avx_double(op, a, b, v, n);
+        v += done;
+        n -= done;
+
+        switch (op)
+        {
+        case MEMORY_TRANSFORM_ADD:      apply(v, n, [a](T x) { return x + a; });                            return true;
+        case MEMORY_TRANSFORM_SUB:      apply(v, n, [a](T x) { return x - a; });                            return true;
+        case MEMORY_TRANSFORM_MUL:      apply(v, n, [a](T x) { return x * a; });                            return true;
+        case MEMORY_TRANSFORM_MIN:      apply(v, n, [a](T x) { return min_of(x, a); });                     return true;
+        case MEMORY_TRANSFORM_MAX:      apply(v, n, [a](T x) { return max_of(x, a); });                     return true;
+        case MEMORY_TRANSFORM_CLAMP:    apply(v, n, [a, b](T x) { return min_of(max_of(x, a), b); });      return true;
+        default:                        return false;   // bitwise operations are not defined for floating point values
+        }
+    }
+
+    template<typename T>
+    bool dispatch(transform_t op, const uint8_t* _a, const uint8_t* _b, bool saturate, uint8_t* values, size_t count) noexcept
+    {
+        T a, b;
+        memcpy(&a, _a, sizeof(T));
+        if (_b != nullptr)  memcpy(&b, _b, sizeof(T));
+        else                b = a;
+
+        // the values are packed, but the array itself does not need to be aligned
+        T* v = reinterpret_cast<T*>(values);
+        if constexpr (std::is_floating_point<T>::value)
+            return transform_floating_point<T>(op, a, b, v, count);
+        else
+            return transform_integral<T>(op, a, b, saturate, v, count);
+    }
+}
+
+transform_t memory::to_transform(const std::string& str) noexcept
+{
+    if (str == "add")   return MEMORY_TRANSFORM_ADD;
+    if (str == "sub")   return MEMORY_TRANSFORM_SUB;
+    if (str == "mul")   return MEMORY_TRANSFORM_MUL;
+    if (str == "xor")   return MEMORY_TRANSFORM_XOR;
+    if (str == "and")   return MEMORY_TRANSFORM_AND;
+    if (str == "or")    return MEMORY_TRANSFORM_OR;
+    if (str == "min")   return MEMORY_TRANSFORM_MIN;
+    if (str == "max")   return MEMORY_TRANSFORM_MAX;
+    if (str == "clamp") return MEMORY_TRANSFORM_CLAMP;
+    return MEMORY_TRANSFORM_INVALID;
+}
+
+bool memory::transform(type_t type, transform_t op, const uint8_t* a, const uint8_t* b, bool saturate, uint8_t* values, size_t count) noexcept
+{
+    if (a == nullptr || (op == MEMORY_TRANSFORM_CLAMP && b == nullptr)) return false;
+
+    switch (type)
+    {
+    case MEMORY_TYPE_INT8:      return dispatch<int8_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_UINT8:     return dispatch<uint8_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_INT16:     return dispatch<int16_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_UINT16:    return dispatch<uint16_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_INT32:     return dispatch<int32_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_UINT32:    return dispatch<uint32_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_INT64:     return dispatch<int64_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_UINT64:    return dispatch<uint64_t>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_FLOAT:     return dispatch<float>(op, a, b, saturate, values, count);
+    case MEMORY_TYPE_DOUBLE:    return dispatch<double>(op, a, b, saturate, values, count);
+    default:                    return false;
+    }
+}
+
+uint64_t memory::transform(Process& proc, const std::vector<address_t>& addresses, type_t type, size_t size, transform_t op,
+                           const uint8_t* a, const uint8_t* b, bool saturate, std::vector<uint8_t>& values, std::vector<bool>& written,
+                           IoBatch::Result& read_result, IoBatch::Result& write_result)
+{
+    const size_t n = addresses.size();
+    values.assign(n * size, 0);
+    written.assign(n, false);
+    read_result = write_result = { proc.pid(), 0, 0, 0, 0 };
+
+    // read all values into one packed array
+    IoBatch batch;
+    for (size_t i = 0; i < n; i++)
+        batch.add(addresses[i], size, values.data() + i * size);
+    read_result = batch.read(proc);
+
+    // Unread values are zero and are transformed as well, this keeps the kernel free of branches.
+    // They are excluded from writing afterwards.
+    if (!transform(type, op, a, b, saturate, values.data(), n))
+        return 0;
+
+    std::vector<size_t> index;
+    index.reserve(n);
+    const std::vector<IoBatch::Request>& reads = batch.requests();
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!reads[i].failed)
+            index.push_back(i);
+    }
+
+    batch.clear();
+    for (size_t i : index)
+        batch.add(addresses[i], size, values.data() + i * size);
+    write_result = batch.write(proc);
+
+    uint64_t count = 0;
+    const std::vector<IoBatch::Request>& writes = batch.requests();
+    for (size_t k = 0; k < index.size(); k++)
+    {
+        if (!writes[k].failed)
+        {
+            written[index[k]] = true;
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,84 @@
+/**
+* @file     transform.h
+* @brief    Definition of arithmetic transformations over packed values.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "io_batch.h"
+#include <string>
+#include <vector>
+
+namespace memory
+{
+    enum transform_t : uint8_t
+    {
+        MEMORY_TRANSFORM_INVALID = 0x0,
+        MEMORY_TRANSFORM_ADD = 0x1,     // x = x + a
+        MEMORY_TRANSFORM_SUB = 0x2,     // x = x - a
+        MEMORY_TRANSFORM_MUL = 0x3,     // x = x * a
+        MEMORY_TRANSFORM_XOR = 0x4,     // x = x ^ a, integral types only
+        MEMORY_TRANSFORM_AND = 0x5,     // x = x & a, integral types only
+        MEMORY_TRANSFORM_OR = 0x6,      // x = x | a, integral types only
+        MEMORY_TRANSFORM_MIN = 0x7,     // x = min(x, a), limits the value to at most a
+        MEMORY_TRANSFORM_MAX = 0x8,     // x = max(x, a), limits the value to at least a
+        MEMORY_TRANSFORM_CLAMP = 0x9    // x = min(max(x, a), b)
+    };
+
+    /**
+    * @brief Converts a string to a transformation.
+    * @param[in] str: name of the transformation (add, sub, mul, xor, and, or, min, max, clamp)
+    * @return The transformation or MEMORY_TRANSFORM_INVALID if the name is unknown.
+    */
+    transform_t to_transform(const std::string& str) noexcept;
+
+    /**
+    * @param[in] op: transformation
+    * @return Number of operands the transformation requires.
+    */
+    inline uint32_t transform_operands(transform_t op) noexcept { return (op == MEMORY_TRANSFORM_CLAMP) ? 2 : 1; }
+
+    /**
+    * @brief Applies a transformation to an array of packed values of the same type.
+    *   Integral types wrap around on overflow, unless 'saturate' is set,
+    *   in which case the result is clamped to the limits of the type.
+    * @param[in] type: type of the values, must not be MEMORY_TYPE_STRING
+    * @param[in] op: transformation to apply
+    * @param[in] a: first operand, stored as the type of the values
+    * @param[in] b: second operand (only for MEMORY_TRANSFORM_CLAMP), may be nullptr otherwise
+    * @param[in] saturate: saturating arithmetic for integral types
+    * @param[in,out] values: packed values
+    * @param[in] count: number of values
+    * @return 'true' if the transformation has been applied and
+    *   'false' if the transformation is not supported for the type.
+    */
+    bool transform(type_t type, transform_t op, const uint8_t* a, const uint8_t* b, bool saturate, uint8_t* values, size_t count) noexcept;
+
+    /**
+    * @brief Transforms values in the memory of a process (read-modify-write).
+    *   All values are read with one batch, transformed locally and written back with one batch.
+    *   Values that could not be read are not written.
+    * @param[in] proc: opened process
+    * @param[in] addresses: addresses of the values
+    * @param[in] type: type of the values, must not be MEMORY_TYPE_STRING
+    * @param[in] size: size of one value
+    * @param[in] op: transformation to apply
+    * @param[in] a: first operand
+    * @param[in] b: second operand (only for MEMORY_TRANSFORM_CLAMP), may be nullptr otherwise
+    * @param[in] saturate: saturating arithmetic for integral types
+    * @param[out] values: new packed values, 'addresses.size() * size' bytes
+    * @param[out] written: indicator for every value if it has been written
+    * @param[out] read_result: statistics of the read batch
+    * @param[out] write_result: statistics of the write batch
+    * @return Number of written values.
+    */
+    uint64_t transform(Process& proc, const std::vector<address_t>& addresses, type_t type, size_t size, transform_t op,
+                       const uint8_t* a, const uint8_t* b, bool saturate, std::vector<uint8_t>& values, std::vector<bool>& written,
+                       IoBatch::Result& read_result, IoBatch::Result& write_result);
+}
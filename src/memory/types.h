@@ -13,6 +13,7 @@
 
 #include <Windows.h>
 #include <cstdint>
+#include <string>
 
 #define MEMORY_NULL_HANDLE      nullptr
 #define MEMORY_INVALID_HANDLE   INVALID_HANDLE_VALUE
@@ -48,4 +49,11 @@ namespace memory
         address_t base;
         address_t size;
     };
+
+    struct ModuleInfo
+    {
+        std::string name;
+        address_t base;
+        address_t size;
+    };
 }
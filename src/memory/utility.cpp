@@ -11,14 +11,81 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 #include "utility.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
-#include <sstream>
-#include <inttypes.h>
 
 using namespace memory;
 
 void to_lover_case(std::string& str) noexcept;
 
+/** @brief Unsigned integer with the same size as T, hexadecimal numbers are the bits of a value. */
+template<typename T> struct bits_of;
+template<> struct bits_of<int8_t>   { using type = uint8_t; };
+template<> struct bits_of<uint8_t>  { using type = uint8_t; };
+template<> struct bits_of<int16_t>  { using type = uint16_t; };
+template<> struct bits_of<uint16_t> { using type = uint16_t; };
+template<> struct bits_of<int32_t>  { using type = uint32_t; };
+template<> struct bits_of<uint32_t> { using type = uint32_t; };
+template<> struct bits_of<int64_t>  { using type = uint64_t; };
+template<> struct bits_of<uint64_t> { using type = uint64_t; };
+template<> struct bits_of<float>    { using type = uint32_t; };
+template<> struct bits_of<double>   { using type = uint64_t; };
+
+template<typename T>
+size_t format_number(const uint8_t* buff, bool hex, char* out) noexcept
+{
+    constexpr static char table[] = "0123456789ABCDEF";
+
+    if (hex)
+    {
+        typename bits_of<T>::type x;
+        memcpy(&x, buff, sizeof(T));
+
+        // uppercase digits without leading zeros, at least one digit
+        int32_t i = sizeof(T) * 8 - 4;
+        while (i > 0 && ((x >> i) & 0x0F) == 0)
+            i -= 4;
+        char* p = out;
+        for (; i >= 0; i -= 4)
+            *p++ = table[(x >> i) & 0x0F];
+        return p - out;
+    }
+
+    T x;
+    memcpy(&x, buff, sizeof(T));
+    return std::to_chars(out, out + utility::MAX_VALUE_CHARS, x).ptr - out;
+}
+
+template<typename T>
+parse_result_t parse_number(const std::string& str, bool hex, uint8_t* buff) noexcept
+{
+    const char* first = str.data();
+    const char* const last = str.data() + str.size();
+    std::from_chars_result res;
+
+    if (hex)
+    {
+        if (str.size() >= 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X'))
+            first += 2;
+        typename bits_of<T>::type x;
+        res = std::from_chars(first, last, x, 16);
+        if (res.ec == std::errc() && res.ptr == last)
+            memcpy(buff, &x, sizeof(T));
+    }
+    else
+    {
+        T x;
+        res = std::from_chars(first, last, x);
+        if (res.ec == std::errc() && res.ptr == last)
+            memcpy(buff, &x, sizeof(T));
+    }
+
+    if (res.ec == std::errc::result_out_of_range)   return MEMORY_PARSE_OUT_OF_RANGE;
+    if (res.ec != std::errc() || res.ptr != last)   return MEMORY_PARSE_INVALID;
+    return MEMORY_PARSE_OK;
+}
+
 void to_lover_case(std::string& str) noexcept
 {
     for (char& c : str)
@@ -98,207 +165,53 @@ bool utility::read_addresses_from_file(const std::string& path, std::vector<memo
 
 void utility::to_string(const uint8_t* buff, size_t size, type_t type, bool hex, std::string& str)
 {
-    std::stringstream ss;
-
-    str.clear();
-    switch (type)
-    {
-    case MEMORY_TYPE_INT8:
-    {
-        int8_t x;
-        memcpy(&x, buff, sizeof(int8_t));
-
-        if (hex)
-            to_hex_str_no_zero<int8_t>(x, str);
-        else
-        {
-            ss << static_cast<int16_t>(x);  // int8_t is interpreted as char-type
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_UINT8:
-    {
-        uint8_t x;
-        memcpy(&x, buff, sizeof(uint8_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint8_t>(x, str);
-        else
-        {
-            ss << static_cast<uint16_t>(x);  // uint8_t is interpreted as char-type
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_INT16:
+    // the string keeps its capacity, formatting a table does not allocate per value
+    if (type == MEMORY_TYPE_STRING)
     {
-        int16_t x;
-        memcpy(&x, buff, sizeof(int16_t));
-
-        if (hex)
-            to_hex_str_no_zero<int16_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_UINT16:
-    {
-        uint16_t x;
-        memcpy(&x, buff, sizeof(uint16_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint16_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_INT32:
-    {
-        int32_t x;
-        memcpy(&x, buff, sizeof(int32_t));
-
-        if (hex)
-            to_hex_str_no_zero<int32_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_UINT32:
-    {
-        uint32_t x;
-        memcpy(&x, buff, sizeof(uint32_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint32_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_INT64:
-    {
-        int64_t x;
-        memcpy(&x, buff, sizeof(int64_t));
-
-        if (hex)
-            to_hex_str_no_zero<int64_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_UINT64:
-    {
-        uint64_t x;
-        memcpy(&x, buff, sizeof(uint64_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint64_t>(x, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_FLOAT:
-    {
-        float x;
-        uint32_t x2;
-        memcpy(&x, buff, sizeof(float));
-        memcpy(&x2, buff, sizeof(uint32_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint32_t>(x2, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_DOUBLE:
-    {
-        double x;
-        uint64_t x2;
-        memcpy(&x, buff, sizeof(double));
-        memcpy(&x2, buff, sizeof(uint64_t));
-
-        if (hex)
-            to_hex_str_no_zero<uint64_t>(x2, str);
-        else
-        {
-            ss << x;
-            str = ss.str();
-        }
-        break;
-    }
-    case MEMORY_TYPE_STRING:
-    {
-        str.resize(size);
-        memcpy(str.data(), buff, size);
-        break;
-    }
-    default:
-        break;
+        str.assign(reinterpret_cast<const char*>(buff), size);
+        return;
     }
+    char chars[MAX_VALUE_CHARS];
+    str.assign(chars, format_value(buff, type, hex, chars));
 }
 
-void utility::to_bytes(const std::string& str, size_t size, memory::type_t type, bool hex, uint8_t* buff)
+size_t utility::format_value(const uint8_t* buff, type_t type, bool hex, char* out) noexcept
 {
-    if (type == MEMORY_TYPE_INT8 || type == MEMORY_TYPE_UINT8)
-    {
-        uint8_t x;
-        sscanf(str.c_str(), ((hex) ? "%" PRIx8 : ("%" PRIu8)), &x);
-        memcpy(buff, &x, sizeof(uint8_t));
-    }
-    else if (type == MEMORY_TYPE_INT16 || type == MEMORY_TYPE_UINT16)
-    {
-        uint16_t x;
-        sscanf(str.c_str(), ((hex) ? "%" PRIx16 : ("%" PRIu16)), &x);
-        memcpy(buff, &x, sizeof(uint16_t));
-    }
-    else if (type == MEMORY_TYPE_INT32 || type == MEMORY_TYPE_UINT32)
-    {
-        uint32_t x;
-        sscanf(str.c_str(), ((hex) ? "%" PRIx32 : ("%" PRIu32)), &x);
-        memcpy(buff, &x, sizeof(uint32_t));
-    }
-    else if (type == MEMORY_TYPE_INT64 || type == MEMORY_TYPE_UINT64)
-    {
-        uint64_t x;
-        sscanf(str.c_str(), ((hex) ? "%" PRIx64 : ("%" PRIu64)), &x);
-        memcpy(buff, &x, sizeof(uint64_t));
-    }
-    else if (type == MEMORY_TYPE_FLOAT)
-    {
-        float x;
-        sscanf(str.c_str(), "%f", &x);
-        memcpy(buff, &x, sizeof(float));
-    }
-    else if (type == MEMORY_TYPE_DOUBLE)
+    switch (type)
     {
-        double x;
-        sscanf(str.c_str(), "%lf", &x);
-        memcpy(buff, &x, sizeof(double));
+    case MEMORY_TYPE_INT8:      return format_number<int8_t>(buff, hex, out);
+    case MEMORY_TYPE_UINT8:     return format_number<uint8_t>(buff, hex, out);
+    case MEMORY_TYPE_INT16:     return format_number<int16_t>(buff, hex, out);
+    case MEMORY_TYPE_UINT16:    return format_number<uint16_t>(buff, hex, out);
+    case MEMORY_TYPE_INT32:     return format_number<int32_t>(buff, hex, out);
+    case MEMORY_TYPE_UINT32:    return format_number<uint32_t>(buff, hex, out);
+    case MEMORY_TYPE_INT64:     return format_number<int64_t>(buff, hex, out);
+    case MEMORY_TYPE_UINT64:    return format_number<uint64_t>(buff, hex, out);
+    case MEMORY_TYPE_FLOAT:     return format_number<float>(buff, hex, out);
+    case MEMORY_TYPE_DOUBLE:    return format_number<double>(buff, hex, out);
+    default:                    return 0;
     }
-    else if (type == MEMORY_TYPE_STRING)
+}
+
+parse_result_t utility::to_bytes(const std::string& str, size_t size, memory::type_t type, bool hex, uint8_t* buff) noexcept
+{
+    switch (type)
     {
-        memcpy(buff, str.c_str(), size);
+    case MEMORY_TYPE_INT8:      return parse_number<int8_t>(str, hex, buff);
+    case MEMORY_TYPE_UINT8:     return parse_number<uint8_t>(str, hex, buff);
+    case MEMORY_TYPE_INT16:     return parse_number<int16_t>(str, hex, buff);
+    case MEMORY_TYPE_UINT16:    return parse_number<uint16_t>(str, hex, buff);
+    case MEMORY_TYPE_INT32:     return parse_number<int32_t>(str, hex, buff);
+    case MEMORY_TYPE_UINT32:    return parse_number<uint32_t>(str, hex, buff);
+    case MEMORY_TYPE_INT64:     return parse_number<int64_t>(str, hex, buff);
+    case MEMORY_TYPE_UINT64:    return parse_number<uint64_t>(str, hex, buff);
+    case MEMORY_TYPE_FLOAT:     return parse_number<float>(str, hex, buff);
+    case MEMORY_TYPE_DOUBLE:    return parse_number<double>(str, hex, buff);
+    case MEMORY_TYPE_STRING:
+        memcpy(buff, str.c_str(), std::min(size, str.size() + 1));
+        return MEMORY_PARSE_OK;
+    default:
+        return MEMORY_PARSE_INVALID;
     }
 }
 
@@ -12,12 +12,22 @@
 #pragma once
 
 #include "buffer.h"
+#include <charconv>
 #include <vector>
 
 namespace memory
 {
+    enum parse_result_t : uint8_t
+    {
+        MEMORY_PARSE_OK = 0x0,
+        MEMORY_PARSE_INVALID = 0x1,         // the string is not a number or contains trailing characters
+        MEMORY_PARSE_OUT_OF_RANGE = 0x2     // the number does not fit into the type
+    };
+
     namespace utility
     {
+        constexpr size_t MAX_VALUE_CHARS = 32;  // maximum number of characters of a formatted number
+
         /**
         * @brief Converts a variable from host to network byteorder.
         * @param[in] x: host byteorder variable
@@ -104,9 +114,8 @@ namespace memory
         template<typename T>
         static void to_dec_str(T x, std::string& str)
         {
-            std::stringstream ss;
-            ss << x;
-            str = ss.str();
+            char buff[MAX_VALUE_CHARS];
+            str.assign(buff, std::to_chars(buff, buff + MAX_VALUE_CHARS, x).ptr);
         }
 
         /**
@@ -137,15 +146,28 @@ namespace memory
         */
         void to_string(const uint8_t* buff, size_t size, memory::type_t type, bool hex, std::string& str);
 
+        /**
+        * @brief Formats a number which is stored in a byte array, without allocating memory.
+        *   Hexadecimal numbers are the bits of the value without leading zeros.
+        * @param[in] buff: buffer where the data is stored
+        * @param[in] type: type of the value, strings are not formatted
+        * @param[in] hex: should the value be converted to hexadecimal
+        * @param[out] out: output characters, at least MAX_VALUE_CHARS
+        * @return Number of written characters.
+        */
+        size_t format_value(const uint8_t* buff, memory::type_t type, bool hex, char* out) noexcept;
+
         /**
         * @brief Converts a string into a value which is stored in a byte array.
+        *   Hexadecimal strings may start with "0x" and are interpreted as the bits of the value.
         * @param[in] str: input string
         * @param[in] size: size of the value
         * @param[in] type: type of the value
-        * @param[in] hex: should the value be converted to hexadecimal
-        * @param[out] buff: bytes of the value
+        * @param[in] hex: is the string a hexadecimal number
+        * @param[out] buff: bytes of the value, unchanged if the string could not be converted
+        * @return MEMORY_PARSE_OK if the string has been converted.
         */
-        void to_bytes(const std::string& str, size_t size, memory::type_t type, bool hex, uint8_t* buff);
+        parse_result_t to_bytes(const std::string& str, size_t size, memory::type_t type, bool hex, uint8_t* buff) noexcept;
 
         /**
         * @brief Check if a string matches a decimal non floating point value.
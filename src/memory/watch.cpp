@@ -0,0 +1,249 @@
+/**
+* @file     watch.cpp
+* @brief    Implementation of the Watch-class.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#include "watch.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+using namespace memory;
+
+Watch::Watch(void)
+{
+    this->_running = false;
+    this->_interval = 0;
+    this->_ticks = 0;
+}
+
+Watch::~Watch(void)
+{
+    this->stop();
+}
+
+double Watch::to_double(type_t type, const uint8_t* value) noexcept
+{
+    switch (type)
+    {
+    case MEMORY_TYPE_INT8:      { int8_t x;     memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_UINT8:     { uint8_t x;    memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_INT16:     { int16_t x;    memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_UINT16:    { uint16_t x;   memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_INT32:     { int32_t x;    memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_UINT32:    { uint32_t x;   memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_INT64:     { int64_t x;    memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_UINT64:    { uint64_t x;   memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_FLOAT:     { float x;      memcpy(&x, value, sizeof(x)); return static_cast<double>(x); }
+    case MEMORY_TYPE_DOUBLE:    { double x;     memcpy(&x, value, sizeof(x)); return x; }
+    default:                    return 0.0;
+    }
+}
+
+bool Watch::add(pid_t pid, address_t address, type_t type, size_t size)
+{
+    if (this->running() || type == MEMORY_TYPE_STRING || size == 0 || size > VALUE_SIZE) return false;
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    Statistics s = {};
+    s.pid = pid;
+    s.address = address;
+    s.type = type;
+    s.size = size;
+    this->_stats.push_back(s);
+    return true;
+}
+
+void Watch::clear(void)
+{
+    this->stop();
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_stats.clear();
+    this->_history.clear();
+    this->_values.clear();
+    this->_groups.clear();
+    this->_ticks = 0;
+}
+
+bool Watch::start(uint32_t interval)
+{
+    if (this->running()) return false;
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        if (this->_stats.size() == 0) return false;
+
+        // reset history and statistics
+        for (Statistics& s : this->_stats)
+        {
+            memset(s.last, 0, VALUE_SIZE);
+            s.min = std::numeric_limits<double>::infinity();
+            s.max = -std::numeric_limits<double>::infinity();
+            s.mean = s.change_rate = 0.0;
+            s.samples = s.failed = s.changes = s.last_change = 0;
+        }
+        this->_history.assign(this->_stats.size() * HISTORY_SIZE, Sample());
+        this->_values.assign(this->_stats.size() * VALUE_SIZE, 0);
+        this->_ticks = 0;
+        this->_interval = std::max<uint32_t>(interval, 1);
+
+        // group the addresses by process, every process is read with one batch per tick
+        std::vector<size_t> order(this->_stats.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return this->_stats[a].pid < this->_stats[b].pid; });
+
+        this->_groups.clear();
+        size_t n_groups = 0;
+        for (size_t i = 0; i < order.size(); i++)
+            n_groups += (i == 0 || this->_stats[order[i]].pid != this->_stats[order[i - 1]].pid) ? 1 : 0;
+        this->_groups.resize(n_groups);     // no reallocation afterwards, the batches keep pointers into '_values'
+
+        size_t g = 0;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const Statistics& s = this->_stats[order[i]];
+            if (i > 0 && s.pid != this->_stats[order[i - 1]].pid) ++g;
+            Group& group = this->_groups[g];
+            if (group.indices.size() == 0)
+                group.proc.init("", s.pid, 0, 0);
+            group.indices.push_back(order[i]);
+            group.batch.add(s.address, s.size, this->_values.data() + order[i] * VALUE_SIZE);
+        }
+    }
+
+    this->_running = true;
+    this->_thread = std::thread(&Watch::run, this);
+    return true;
+}
+
+void Watch::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_running = false;
+    }
+    this->_cv.notify_all();
+    if (this->_thread.joinable())
+        this->_thread.join();
+    for (Group& g : this->_groups)
+        g.proc.close();
+}
+
+size_t Watch::size(void) const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_stats.size();
+}
+
+uint64_t Watch::ticks(void) const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_ticks;
+}
+
+void Watch::run(void)
+{
+    using namespace std::chrono;
+    Trace::exclude_thread();    // the samples belong to no operation
+
+    const time_point<steady_clock> t0 = steady_clock::now();
+    time_point<steady_clock> tp = t0;
+    while (this->_running)
+    {
+        this->sample(duration_cast<milliseconds>(steady_clock::now() - t0).count());
+
+        // if sampling takes longer than the interval, ticks are skipped instead of accumulated
+        tp += milliseconds(this->_interval);
+        if (tp < steady_clock::now())
+            tp = steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_cv.wait_until(lock, tp, [this] { return !this->_running; });
+    }
+}
+
+void Watch::sample(uint64_t time)
+{
+    // read without holding the lock, the reading threads are only blocked while the statistics are updated
+    for (Group& g : this->_groups)
+    {
+        if (!g.proc.is_valid() && !g.proc.open())
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            for (size_t i : g.indices)
+                ++this->_stats[i].failed;
+            continue;
+        }
+
+        g.batch.read(g.proc);
+        const std::vector<IoBatch::Request>& requests = g.batch.requests();
+
+        // if nothing could be read, the process may have terminated, it is reopened in the next tick
+        bool all_failed = true;
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        for (size_t k = 0; k < g.indices.size(); k++)
+        {
+            Statistics& s = this->_stats[g.indices[k]];
+            if (requests[k].failed)
+            {
+                ++s.failed;
+                continue;
+            }
+            all_failed = false;
+
+            const uint8_t* value = this->_values.data() + g.indices[k] * VALUE_SIZE;
+            const double x = to_double(s.type, value);
+            const bool changed = (s.samples > 0 && memcmp(s.last, value, s.size) != 0);
+
+            // incremental statistics
+            ++s.samples;
+            s.min = std::min(s.min, x);
+            s.max = std::max(s.max, x);
+            s.mean += (x - s.mean) / static_cast<double>(s.samples);
+            if (changed)
+            {
+                ++s.changes;
+                s.last_change = time;
+            }
+            s.change_rate += RATE_SMOOTHING * ((changed ? 1000.0 / this->_interval : 0.0) - s.change_rate);
+            memcpy(s.last, value, s.size);
+
+            Sample& h = this->_history[g.indices[k] * HISTORY_SIZE + (s.samples - 1) % HISTORY_SIZE];
+            h.time = time;
+            memcpy(h.value, value, VALUE_SIZE);
+        }
+        if (all_failed)
+            g.proc.close();
+    }
+
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    ++this->_ticks;
+}
+
+void Watch::statistics(std::vector<Statistics>& stats) const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    stats = this->_stats;
+}
+
+bool Watch::history(size_t index, std::vector<Sample>& samples) const
+{
+    samples.clear();
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    if (index >= this->_stats.size() || this->_history.size() == 0) return false;
+
+    const uint64_t n = this->_stats[index].samples;
+    const uint64_t count = std::min<uint64_t>(n, HISTORY_SIZE);
+    const Sample* ring = this->_history.data() + index * HISTORY_SIZE;
+    for (uint64_t i = n - count; i < n; i++)
+        samples.push_back(ring[i % HISTORY_SIZE]);
+    return true;
+}
@@ -0,0 +1,144 @@
+/**
+* @file     watch.h
+* @brief    Definition of the Watch-class. Samples a set of addresses periodically
+*           in a background thread and keeps a history and statistics of every address.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "io_batch.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace memory
+{
+    class Watch
+    {
+    public:
+        constexpr static size_t HISTORY_SIZE    = 256;      // number of samples that are kept per address
+        constexpr static size_t VALUE_SIZE      = 8;        // maximum size of a watched value
+        constexpr static double RATE_SMOOTHING  = 0.1;      // weight of the newest sample for the change rate
+
+        struct Sample
+        {
+            uint64_t time;                  // milliseconds since the watch has been started
+            uint8_t value[VALUE_SIZE];
+        };
+
+        struct Statistics
+        {
+            pid_t pid;
+            address_t address;
+            type_t type;
+            size_t size;
+            uint8_t last[VALUE_SIZE];       // last sampled value
+            double min, max, mean;
+            uint64_t samples;               // number of successful samples
+            uint64_t failed;                // number of failed samples
+            uint64_t changes;               // number of samples that differ from their previous sample
+            uint64_t last_change;           // time of the last change in milliseconds, only valid if 'changes' > 0
+            double change_rate;             // smoothed number of changes per second
+        };
+
+    private:
+        struct Group
+        {
+            Process proc;
+            IoBatch batch;
+            std::vector<size_t> indices;    // watched addresses of the process
+        };
+
+        std::vector<Statistics> _stats;
+        std::vector<Sample> _history;       // HISTORY_SIZE samples per address, used as ring buffer
+        std::vector<uint8_t> _values;       // staging area of one sampling tick
+        std::vector<Group> _groups;
+
+        std::thread _thread;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::atomic<bool> _running;
+        uint32_t _interval;
+        uint64_t _ticks;
+
+        /** @brief Main function of the sampling thread. */
+        void run(void);
+
+        /**
+        * @brief Samples all addresses once.
+        * @param[in] time: time of the sample in milliseconds
+        */
+        void sample(uint64_t time);
+
+        /**
+        * @brief Converts a value to double for the statistics.
+        * @param[in] type: type of the value
+        * @param[in] value: value to convert
+        * @return Value as double.
+        */
+        static double to_double(type_t type, const uint8_t* value) noexcept;
+
+    public:
+        Watch(void);
+        Watch(const Watch&) = delete;
+        Watch& operator= (const Watch&) = delete;
+        virtual ~Watch(void);
+
+        /**
+        * @brief Adds an address to the watch, addresses can only be added while the watch is stopped.
+        * @param[in] pid: ID of the process
+        * @param[in] address: address of the value
+        * @param[in] type: type of the value, strings are not supported
+        * @param[in] size: size of the value, at most VALUE_SIZE bytes
+        * @return 'true' if the address has been added.
+        */
+        bool add(pid_t pid, address_t address, type_t type, size_t size);
+
+        /** @brief Stops the watch and removes all addresses. */
+        void clear(void);
+
+        /**
+        * @brief Starts the sampling thread, the history and statistics are reset.
+        * @param[in] interval: sampling interval in milliseconds
+        * @return 'true' if the watch has been started and 'false' if it has no addresses or is already running.
+        */
+        bool start(uint32_t interval);
+
+        /** @brief Stops the sampling thread, the history and statistics are kept. */
+        void stop(void);
+
+        /** @return 'true' if the sampling thread is running. */
+        bool running(void) const noexcept { return this->_running.load(); }
+
+        /** @return Number of watched addresses. */
+        size_t size(void) const;
+
+        /** @return Number of sampling ticks since the watch has been started. */
+        uint64_t ticks(void) const;
+
+        /** @return Sampling interval in milliseconds. */
+        uint32_t interval(void) const noexcept { return this->_interval; }
+
+        /**
+        * @brief Copies the statistics of all watched addresses.
+        * @param[out] stats: statistics in the order the addresses have been added
+        */
+        void statistics(std::vector<Statistics>& stats) const;
+
+        /**
+        * @brief Copies the sample history of one address.
+        * @param[in] index: index of the address
+        * @param[out] samples: samples ordered from oldest to newest
+        * @return 'false' if the index is out of range.
+        */
+        bool history(size_t index, std::vector<Sample>& samples) const;
+    };
+}
@@ -0,0 +1,316 @@
+/**
+* @file     target/main.cpp
+* @brief    Main function of the target sub-program. A reproducible process to scan, read and write.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "target.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <inttypes.h>
+
+/*
+* Syntax: memory_target.exe <pipe name> <seed> <heap size>
+*
+* INFO:
+*   <pipe name>         : STRING, without the pipe prefix
+*   <seed>              : DECIMAL
+*   <heap size>         : DECIMAL, in bytes, at least target::MIN_HEAP_SIZE
+*
+* Return values:
+*   -1: invalid arguments
+*   -2: the pipe could not be created or the driver has not connected
+*/
+
+/*
+* The heap is filled with pseudo random bytes of the seed. It is divided into cells of target::CELL_SIZE bytes
+* and every seeded object gets its own cell in a random order, the rest of its cell is 0. The expected results
+* are found by scanning the heap after it has been seeded, so random bytes that happen to match are expected as well.
+*/
+struct Set
+{
+    std::string name;
+    memory::type_t type;
+    size_t size;
+    uint16_t alignment;
+    uint8_t a[64], b[64];
+    std::vector<memory::address_t> addresses;
+};
+
+struct Layout
+{
+    std::vector<uint8_t> heap;
+    memory::address_t chain_head;
+    uint64_t chain_value;
+    std::vector<memory::address_t> counters, slots;
+    std::vector<Set> sets;
+};
+
+class Random
+{
+private:
+    uint64_t x;
+
+public:
+    explicit Random(uint64_t seed) : x(seed | 1) {}
+
+    uint64_t next(void) noexcept
+    {
+        this->x ^= this->x << 13;
+        this->x ^= this->x >> 7;
+        this->x ^= this->x << 17;
+        return this->x;
+    }
+};
+
+void seed_layout(uint64_t seed, uint64_t heap_size, Layout& layout);
+void find_expected(const Layout& layout, Set& set);
+void counter_thread_func(const std::atomic_bool* running, const std::vector<memory::address_t>* counters);
+bool write_frame(HANDLE pipe, const std::vector<uint8_t>& frame);
+bool read_frame(HANDLE pipe, memory::rpc::FrameHeader& header, std::vector<uint8_t>& payload);
+void make_layout_frame(const Layout& layout, std::vector<uint8_t>& frame);
+
+int main(const int argc, const char* const * const argv)
+{
+    using namespace memory;
+
+    // check correct argument length
+    if (argc != 4) return -1;   // -1: invalid argument length
+
+    // convert arguments
+    uint64_t seed, heap_size;
+    if (sscanf(argv[2], "%" PRIu64, &seed) != 1 || sscanf(argv[3], "%" PRIu64, &heap_size) != 1 || heap_size < target::MIN_HEAP_SIZE)
+        return -1;
+
+    // the pipe is created first, the driver waits for it while the heap is seeded
+    const std::string path = std::string(rpc::PIPE_PREFIX) + argv[1];
+    HANDLE pipe = CreateNamedPipe(path.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+                                  1, 0x10000, 0x10000, 0, nullptr);
+    if (pipe == MEMORY_INVALID_HANDLE) return -2;
+
+    Layout layout;
+    seed_layout(seed, heap_size, layout);
+
+    std::atomic_bool running = true;
+    std::thread counter_thread(counter_thread_func, &running, &layout.counters);
+
+    int ret = -2;
+    std::vector<uint8_t> frame, payload;
+    if (ConnectNamedPipe(pipe, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED)
+    {
+        ret = 0;
+        make_layout_frame(layout, frame);
+        bool connected = write_frame(pipe, frame);
+
+        // answer requests until the driver exits or disconnects
+        rpc::FrameHeader header;
+        while (connected && read_frame(pipe, header, payload))
+        {
+            rpc::Writer out(frame, static_cast<rpc_op_t>(MEMORY_TARGET_REPLY), header.id);
+            if (header.op == MEMORY_TARGET_CHECK)
+            {
+                uint32_t value = 0;
+                rpc::Reader in(payload.data(), payload.size());
+                in.get(value);
+
+                uint32_t count = 0;
+                for (address_t slot : layout.slots)
+                    count += (*reinterpret_cast<volatile const uint32_t*>(slot) == value) ? 1 : 0;
+                out.put<uint32_t>(count);
+            }
+            out.finish();
+            connected = write_frame(pipe, frame) && header.op != MEMORY_TARGET_EXIT;
+        }
+    }
+
+    running = false;
+    counter_thread.join();
+    CloseHandle(pipe);
+    return ret;
+}
+
+void seed_layout(uint64_t seed, uint64_t heap_size, Layout& layout)
+{
+    using namespace memory;
+
+    Random random(seed);
+    layout.heap.resize(heap_size);
+    for (size_t i = 0; i + sizeof(uint64_t) <= layout.heap.size(); i += sizeof(uint64_t))
+    {
+        const uint64_t x = random.next();
+        memcpy(layout.heap.data() + i, &x, sizeof(uint64_t));
+    }
+
+    // cells in a random order, every object takes the next cell
+    const size_t cell_count = heap_size / target::CELL_SIZE;
+    std::vector<uint32_t> cells(cell_count);
+    for (size_t i = 0; i < cell_count; i++)
+        cells[i] = static_cast<uint32_t>(i);
+    for (size_t i = cell_count - 1; i > 0; i--)
+        std::swap(cells[i], cells[random.next() % (i + 1)]);
+    size_t next_cell = 0;
+    auto take_cell = [&]() -> uint8_t*
+    {
+        uint8_t* cell = layout.heap.data() + cells[next_cell++] * target::CELL_SIZE;
+        memset(cell, 0, target::CELL_SIZE);
+        return cell;
+    };
+    const uint32_t values = static_cast<uint32_t>(std::max<size_t>(cell_count / 1024, 16));
+    const uint32_t strings = static_cast<uint32_t>(std::max<size_t>(cell_count / 4096, 4));
+
+    // int32 values, exact scan (the highest nibble is not 0, so the counters never reach them)
+    Set int_set = { "int32", MEMORY_TYPE_INT32, sizeof(int32_t), 4 };
+    const uint32_t marker = 0x10000000 | static_cast<uint32_t>(random.next() & 0x0FFFFFFF);
+    memcpy(int_set.a, &marker, sizeof(uint32_t));
+    memcpy(int_set.b, &marker, sizeof(uint32_t));
+    for (uint32_t i = 0; i < values; i++)
+        memcpy(take_cell(), &marker, sizeof(uint32_t));
+
+    // double values between 1000 and 2000, range scan
+    Set double_set = { "double", MEMORY_TYPE_DOUBLE, sizeof(double), 8 };
+    const double lower = 1000.0, upper = 2000.0;
+    memcpy(double_set.a, &lower, sizeof(double));
+    memcpy(double_set.b, &upper, sizeof(double));
+    for (uint32_t i = 0; i < values; i++)
+    {
+        const double x = lower + static_cast<double>(random.next() % 1000000) / 1000.0;
+        memcpy(take_cell() + 8 * (random.next() % 4), &x, sizeof(double));
+    }
+
+    // strings at unaligned addresses, exact scan
+    const std::string str = "memory_target_" + std::to_string(seed);
+    Set string_set = { "string", MEMORY_TYPE_STRING, str.size(), 1 };
+    memcpy(string_set.a, str.data(), str.size());
+    memcpy(string_set.b, str.data(), str.size());
+    for (uint32_t i = 0; i < strings; i++)
+        memcpy(take_cell() + random.next() % (target::CELL_SIZE - str.size()), str.data(), str.size());
+
+    // pointer chain, built from the last node to the head
+    layout.chain_value = random.next();
+    uint64_t node[2] = { 0, layout.chain_value };
+    for (uint32_t i = 0; i < target::CHAIN_LENGTH; i++)
+    {
+        uint8_t* cell = take_cell();
+        memcpy(cell, node, sizeof(node));
+        node[0] = reinterpret_cast<address_t>(cell);
+        node[1] = random.next();
+    }
+    layout.chain_head = node[0];
+
+    for (uint32_t i = 0; i < target::COUNTER_COUNT; i++)
+        layout.counters.push_back(reinterpret_cast<address_t>(take_cell()));
+    for (uint32_t i = 0; i < target::SLOT_COUNT; i++)
+        layout.slots.push_back(reinterpret_cast<address_t>(take_cell()));
+
+    layout.sets = { int_set, double_set, string_set };
+    for (Set& set : layout.sets)
+        find_expected(layout, set);
+}
+
+void find_expected(const Layout& layout, Set& set)
+{
+    using namespace memory;
+
+    // a plain loop that does not share code with the scanner, so the scanner is checked against it
+    const uint8_t* heap = layout.heap.data();
+    set.addresses.clear();
+    for (size_t i = 0; i + set.size <= layout.heap.size(); i += set.alignment)
+    {
+        bool match;
+        if (set.type == MEMORY_TYPE_DOUBLE)
+        {
+            double a, b, x;
+            memcpy(&a, set.a, sizeof(double));
+            memcpy(&b, set.b, sizeof(double));
+            memcpy(&x, heap + i, sizeof(double));
+            match = (x >= a && x <= b);
+        }
+        else
+            match = (memcmp(heap + i, set.a, set.size) == 0);
+
+        if (match)
+            set.addresses.push_back(reinterpret_cast<address_t>(heap + i));
+    }
+}
+
+void counter_thread_func(const std::atomic_bool* running, const std::vector<memory::address_t>* counters)
+{
+    while (*running)
+    {
+        for (memory::address_t counter : *counters)
+            ++*reinterpret_cast<volatile uint32_t*>(counter);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool write_frame(HANDLE pipe, const std::vector<uint8_t>& frame)
+{
+    for (size_t offset = 0; offset < frame.size();)
+    {
+        DWORD written = 0;
+        if (!WriteFile(pipe, frame.data() + offset, static_cast<DWORD>(frame.size() - offset), &written, nullptr)) return false;
+        offset += written;
+    }
+    return true;
+}
+
+bool read_frame(HANDLE pipe, memory::rpc::FrameHeader& header, std::vector<uint8_t>& payload)
+{
+    auto read_all = [pipe](void* data, size_t size) -> bool
+    {
+        uint8_t* p = static_cast<uint8_t*>(data);
+        while (size > 0)
+        {
+            DWORD read = 0;
+            if (!ReadFile(pipe, p, static_cast<DWORD>(size), &read, nullptr) || read == 0) return false;
+            p += read;
+            size -= read;
+        }
+        return true;
+    };
+
+    if (!read_all(&header, sizeof(header)) || header.size > memory::rpc::MAX_PAYLOAD) return false;
+    payload.resize(header.size);
+    return read_all(payload.data(), header.size);
+}
+
+void make_layout_frame(const Layout& layout, std::vector<uint8_t>& frame)
+{
+    using namespace memory;
+
+    rpc::Writer out(frame, static_cast<rpc_op_t>(MEMORY_TARGET_LAYOUT), 0);
+    out.put<uint64_t>(reinterpret_cast<address_t>(layout.heap.data()));
+    out.put<uint64_t>(layout.heap.size());
+    out.put<uint64_t>(layout.chain_head);
+    out.put<uint32_t>(target::CHAIN_LENGTH);
+    out.put<uint64_t>(layout.chain_value);
+    for (const std::vector<address_t>* addresses : { &layout.counters, &layout.slots })
+    {
+        out.put<uint32_t>(static_cast<uint32_t>(addresses->size()));
+        for (address_t address : *addresses)
+            out.put<uint64_t>(address);
+    }
+    out.put<uint32_t>(static_cast<uint32_t>(layout.sets.size()));
+    for (const Set& set : layout.sets)
+    {
+        out.put_string(set.name);
+        out.put<uint8_t>(set.type);
+        out.put<uint32_t>(static_cast<uint32_t>(set.size));
+        out.put<uint16_t>(set.alignment);
+        out.put(set.a, set.size);
+        out.put(set.b, set.size);
+        out.put<uint32_t>(static_cast<uint32_t>(set.addresses.size()));
+        for (address_t address : set.addresses)
+            out.put<uint64_t>(address);
+    }
+    out.finish();
+}
@@ -0,0 +1,49 @@
+/**
+* @file     target/target.h
+* @brief    Control protocol of the target sub-program, shared with its driver in bench/main.cpp.
+* @author   Michael Reim / Github: R-Michi
+* Copyright (c) 2021 by Michael Reim
+*
+* This code is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+*/
+
+#pragma once
+
+#include "../src/memory/memory.h"
+
+/*
+* The target is controlled over a named pipe with the frames of rpc.h. As soon as the driver has connected,
+* the target sends MEMORY_TARGET_LAYOUT, which describes its heap and the expected results:
+*   u64 heap base, u64 heap size
+*   u64 chain head, u32 chain length, u64 chain value  (node: u64 address of the next node, u64 value, the last next is 0)
+*   u32 n, u64 counter[n]                             (u32 values that are incremented every millisecond)
+*   u32 n, u64 slot[n]                                (u32 values that are 0 until the driver writes them)
+*   u32 n, n times: string name, u8 type, u32 size, u16 alignment, a[size], b[size], u32 m, u64 address[m]
+*                                                     (every address of the heap that a scan for 'a' to 'b' must find)
+* Requests of the driver, answered with MEMORY_TARGET_REPLY:
+*   CHECK:  u32 value   -> u32 number of slots that hold the value
+*   EXIT:   empty       -> empty, then the target exits
+*/
+
+namespace memory
+{
+    enum target_op_t : uint16_t
+    {
+        MEMORY_TARGET_LAYOUT = 0x1,
+        MEMORY_TARGET_CHECK = 0x2,
+        MEMORY_TARGET_EXIT = 0x3,
+        MEMORY_TARGET_REPLY = 0x80
+    };
+
+    namespace target
+    {
+        constexpr char PIPE_NAME[]          = "memory_target_";     // followed by the PID of the driver
+        constexpr uint64_t MIN_HEAP_SIZE    = 0x10000;              // 64kB
+        constexpr size_t CELL_SIZE          = 64;                   // every seeded object has its own cell
+        constexpr uint32_t CHAIN_LENGTH     = 64;
+        constexpr uint32_t COUNTER_COUNT    = 16;
+        constexpr uint32_t SLOT_COUNT       = 16;
+    }
+}